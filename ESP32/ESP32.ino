@@ -11,6 +11,7 @@
 #include <PacketSerial.h>
 #include "Indicator_Extender.h"
 #include "Indicator_SWSPI.h"
+#include "Indicator_HWSPI.h"
 #include "ui.h"
 #include "touch.h"
 #include "./src/UI/AudioFeedback.h"
@@ -18,10 +19,20 @@
 #include "./src/UI/WiFiConfig.h"
 #include "./src/Core/MQTTManager.h"
 #include "./src/UI/DataSimulator.h"
+#include "./src/Core/PerfMonitor.h"
+#include "./src/UI/WindChimeRender.h"
+#include "./src/UI/WindChimeConfig.h"
+#include "./src/UI/ReplayBench.h"
+#include "./src/Display/RotateRGB565.h"
+#include "./src/Display/FrameCapture.h"
+#include "./src/Display/FlushHeatmap.h"
+#include "./src/Display/DisplaySleep.h"
 
 #define HOR_RES 480
 #define VER_RES 480
 
+#define LCD_VSYNC_PIN 17
+
 #define PACKET_UART_RXD 20
 #define PACKET_UART_TXD 19
 
@@ -30,12 +41,20 @@
 #define GFX_DEV_DEVICE ESP32_S3_RGB
 #define RGB_PANEL
 #define GFX_BL 45
+
+// 面板命令总线：0 软件 SPI (逐位翻转 GPIO)，1 SPI 外设 9 位模式。两者 CS 都在扩展芯片上
+#define PANEL_BUS_HWSPI 0
+#if PANEL_BUS_HWSPI
+Arduino_DataBus *bus = new Indicator_HWSPI(
+    EXPANDER_IO_LCD_CS /* CS */, SPI_SCLK /* SCK */, SPI_MOSI /* MOSI */);
+#else
 Arduino_DataBus *bus = new Indicator_SWSPI(
     GFX_NOT_DEFINED /* DC */, EXPANDER_IO_LCD_CS /* CS */,
     SPI_SCLK /* SCK */, SPI_MOSI /* MOSI */, GFX_NOT_DEFINED /* MISO */);
+#endif
 
 Arduino_ESP32RGBPanel *rgbpanel = new Arduino_ESP32RGBPanel(
-    18 /* DE */, 17 /* VSYNC */, 16 /* HSYNC */, 21 /* PCLK */,
+    18 /* DE */, LCD_VSYNC_PIN /* VSYNC */, 16 /* HSYNC */, 21 /* PCLK */,
     4 /* R0 */, 3 /* R1 */, 2 /* R2 */, 1 /* R3 */, 0 /* R4 */,
     10 /* G0 */, 9 /* G1 */, 8 /* G2 */, 7 /* G3 */, 6 /* G4 */, 5 /* G5 */,
     15 /* B0 */, 14 /* B1 */, 13 /* B2 */, 12 /* B3 */, 11 /* B4 */,
@@ -43,13 +62,16 @@ Arduino_ESP32RGBPanel *rgbpanel = new Arduino_ESP32RGBPanel(
     1 /* vsync_polarity */, 10 /* vsync_front_porch */, 8 /* vsync_pulse_width */, 20 /* vsync_back_porch */);
 Arduino_RGB_Display *gfx = new Arduino_RGB_Display(
     HOR_RES /* width */, VER_RES /* height */, rgbpanel, 0 /* rotation */, false /* auto_flush */,
-    bus, GFX_NOT_DEFINED /* RST */, st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations));
+    bus, GFX_NOT_DEFINED /* RST */, NULL, 0 /* init: st7701_indicator_init_stream, sent by bus->begin() */);
 
 
 COBSPacketSerial myPacketSerial;
 
 void onPacketReceived(const uint8_t* buffer, size_t size);
 
+// WiFi/MQTT 刚连上，loop() 里重新检查显示缓冲占用的 SRAM (WiFi 回调在事件任务中)
+static volatile bool network_connected = false;
+
 // MQTT状态回调函数
 extern "C" void mqtt_status_callback(mqtt_status_t status, const char* message)
 {
@@ -58,6 +80,7 @@ extern "C" void mqtt_status_callback(mqtt_status_t status, const char* message)
   // 根据MQTT连接状态控制数据模拟器
   // 如果MQTT连上了，那么不Mock
   if (status == MQTT_STATUS_CONNECTED) {
+    network_connected = true;
     DataSimulatorSetMQTTMode(true);
   } else {
     DataSimulatorSetMQTTMode(false);
@@ -71,6 +94,7 @@ extern "C" void wifi_status_callback(wifi_status_t status, const char* message)
   
   // 当WiFi连接成功时，尝试连接MQTT
   if (status == WIFI_STATUS_CONNECTED) {
+    network_connected = true;
     Serial.println("WiFi connected, attempting MQTT connection...");
     MQTTManager_Connect();
   } else if (status == WIFI_STATUS_DISCONNECTED || status == WIFI_STATUS_FAILED) {
@@ -79,6 +103,191 @@ extern "C" void wifi_status_callback(wifi_status_t status, const char* message)
   }
 }
 
+// 串口调试命令，一行一条
+//   perf        打印各阶段耗时直方图
+//   perf reset  清零直方图
+//   bench [seed] 运行风铃回放基准测试 (默认种子1)
+//   rotate      旋转内核与 lv_draw_sw_rotate 的逐位比较和计时
+//   display tune    重新测量各渲染模式并保存最快的
+//   display mode N  切换并保存渲染模式 (0 direct, 1 zero-copy, 2 partial, 3 double-partial)
+//   capture [mqtt] [key]  截取帧缓冲中变化的块，默认走串口，key 发送整帧
+//   heatmap [on|off|overlay|reset]  刷新区域热力图，不带参数打印报告
+//   vsync N     每 N 个面板 VSYNC 刷新一次 (1-3)，0 恢复 LVGL 定时刷新
+//   coalesce [on|off|calibrate]  刷新前的脏区域合并，calibrate 在当前模式下重新测量代价模型
+//   l8 on|off   风铃界面使用 L8 调色板渲染
+//   sleep       显示休眠统计；sleep now 立即熄灭；sleep D B 调暗/熄灭超时 (秒，0 关闭)
+static bool windchime_l8 = WINDCHIME_L8_RENDER;
+
+// 风铃界面显示期间切到 L8 渲染，离开时恢复原来的模式
+static void windchime_l8_cb(lv_event_t * e)
+{
+  if (!windchime_l8) return;
+  lv_screen_set_l8(lv_event_get_code(e) == LV_EVENT_SCREEN_LOADED);
+  WindChimeSetIndexed(lv_screen_is_l8());
+}
+
+// 屏幕熄灭期间风铃动画也停下，事件只暂存
+static void display_sleep_cb(bool blanked)
+{
+  WindChimeSetSuspended(blanked);
+}
+
+static void windchime_event_cb(const wind_chime_event_t* event)
+{
+  DisplaySleep_OnEvent(event->intensity);
+}
+
+static void handle_serial_command(const char* cmd)
+{
+  if (strcmp(cmd, "perf") == 0)
+  {
+    PerfMonitor_PrintReport();
+    const windchime_ring_cache_stats_t* rc = WindChimeRenderGetRingCacheStats();
+    Serial.printf("Ring cache: %u hits, %u misses, %u fallbacks, %u sprites, %u bytes\n",
+                  rc->hits, rc->misses, rc->fallbacks, rc->sprites, rc->bytes);
+    lv_screen_print_stats();
+  }
+  else if (strcmp(cmd, "perf reset") == 0)
+  {
+    PerfMonitor_Reset();
+    Serial.println("PerfMonitor: histograms cleared");
+  }
+  else if (strncmp(cmd, "bench", 5) == 0 && (cmd[5] == '\0' || cmd[5] == ' '))
+  {
+    uint32_t seed = cmd[5] ? strtoul(cmd + 6, NULL, 10) : 1;
+    ReplayBenchStart(seed);
+  }
+  else if (strcmp(cmd, "rotate") == 0)
+  {
+    rotate_rgb565_check_t check;
+    bool ok = RotateRGB565SelfCheck(&check);
+    static const int degrees[3] = {90, 180, 270};
+    for (int i = 0; i < 3; i++)
+    {
+      Serial.printf("Rotate %3d: %s, lv_draw_sw_rotate %u us, tiled %u us\n", degrees[i],
+                    check.exact[i] ? "exact" : "MISMATCH", check.lvgl_us[i], check.tiled_us[i]);
+    }
+    Serial.println(ok ? "Rotate self check passed" : "Rotate self check FAILED");
+  }
+  else if (strcmp(cmd, "display tune") == 0)
+  {
+    lv_screen_autotune();
+  }
+  else if (strncmp(cmd, "display mode ", 13) == 0)
+  {
+    display_mode_t mode = (display_mode_t)atoi(cmd + 13);
+    if (lv_screen_set_mode(mode, true) && lv_screen_get_mode() == mode)
+    {
+      Serial.printf("Display: using %s mode\n", lv_screen_mode_name(mode));
+    }
+    else
+    {
+      Serial.printf("Display: mode %d not available, still %s\n", (int)mode, lv_screen_mode_name(lv_screen_get_mode()));
+    }
+  }
+  else if (strncmp(cmd, "capture", 7) == 0 && (cmd[7] == '\0' || cmd[7] == ' '))
+  {
+    frame_capture_sink_t sink = strstr(cmd, "mqtt") ? FRAME_CAPTURE_SINK_MQTT : FRAME_CAPTURE_SINK_SERIAL;
+    bool keyframe = strstr(cmd, "key") != NULL;
+    lv_screen_flush_drain();
+    if (!FrameCaptureStart((const uint16_t *)gfx->getFramebuffer(), HOR_RES, VER_RES, sink, keyframe))
+    {
+      Serial.println("FrameCapture: busy, or MQTT not connected");
+    }
+  }
+  else if (strcmp(cmd, "heatmap") == 0)
+  {
+    FlushHeatmap_PrintReport();
+  }
+  else if (strncmp(cmd, "heatmap ", 8) == 0)
+  {
+    const char* arg = cmd + 8;
+    // The flush worker tints from the heatmap
+    lv_screen_flush_drain();
+    if (strcmp(arg, "on") == 0) FlushHeatmap_SetEnabled(true);
+    else if (strcmp(arg, "off") == 0) { FlushHeatmap_SetOverlay(false); FlushHeatmap_SetEnabled(false); }
+    else if (strcmp(arg, "overlay") == 0) FlushHeatmap_SetOverlay(!FlushHeatmap_GetOverlay());
+    else if (strcmp(arg, "reset") == 0) FlushHeatmap_Reset();
+    else Serial.printf("Unknown heatmap option: %s\n", arg);
+  }
+  else if (strncmp(cmd, "vsync ", 6) == 0)
+  {
+    if (lv_screen_set_vsync_divider(atoi(cmd + 6)))
+    {
+      Serial.printf("VSYNC: divider %u\n", lv_screen_get_vsync_divider());
+    }
+    else
+    {
+      Serial.println("VSYNC: divider must be 0-3 and the VSYNC pin attached");
+    }
+  }
+  else if (strcmp(cmd, "coalesce on") == 0)
+  {
+    lv_screen_set_area_coalescer(AreaCoalesce_CostModel);
+  }
+  else if (strcmp(cmd, "coalesce off") == 0)
+  {
+    lv_screen_set_area_coalescer(NULL);
+  }
+  else if (strcmp(cmd, "coalesce calibrate") == 0)
+  {
+    lv_screen_calibrate_coalescing();
+  }
+  else if (strcmp(cmd, "l8 on") == 0 || strcmp(cmd, "l8 off") == 0)
+  {
+    windchime_l8 = strcmp(cmd, "l8 on") == 0;
+    bool ok = lv_screen_set_l8(windchime_l8 && lv_screen_active() == windchime_screen);
+    WindChimeSetIndexed(lv_screen_is_l8());
+    Serial.printf("Display: L8 for WindChime %s%s\n", windchime_l8 ? "on" : "off", ok ? "" : " (failed)");
+  }
+  else if (strcmp(cmd, "sleep") == 0)
+  {
+    DisplaySleep_PrintReport();
+  }
+  else if (strcmp(cmd, "sleep now") == 0)
+  {
+    DisplaySleep_Blank();
+  }
+  else if (strncmp(cmd, "sleep ", 6) == 0)
+  {
+    unsigned dim_s, blank_s;
+    if (sscanf(cmd + 6, "%u %u", &dim_s, &blank_s) == 2)
+    {
+      DisplaySleep_SetTimeouts(dim_s, blank_s);
+      Serial.printf("Sleep: dim after %u s, blank after %u s\n", dim_s, blank_s);
+    }
+    else
+    {
+      Serial.println("Usage: sleep | sleep now | sleep <dim s> <blank s>");
+    }
+  }
+  else if (cmd[0] != '\0')
+  {
+    Serial.printf("Unknown command: %s\n", cmd);
+  }
+}
+
+static void poll_serial_commands(void)
+{
+  static char line[64];
+  static uint8_t len = 0;
+
+  while (Serial.available())
+  {
+    char c = Serial.read();
+    if (c == '\r' || c == '\n')
+    {
+      line[len] = '\0';
+      handle_serial_command(line);
+      len = 0;
+    }
+    else if (len < sizeof(line) - 1)
+    {
+      line[len++] = c;
+    }
+  }
+}
+
 uint32_t millis_cb(void)
 {
   return millis();
@@ -87,11 +296,15 @@ uint32_t millis_cb(void)
 /*Read the touchpad*/
 void my_touchpad_read(lv_indev_t *indev, lv_indev_data_t *data)
 {
+  // A touch that wakes the display is not passed on, until it is released
+  static bool wake_touch = false;
+
   if (touch_has_signal())
   {
     if (touch_touched())
     {
-      data->state = LV_INDEV_STATE_PRESSED;
+      if (DisplaySleep_Wake()) wake_touch = true;
+      data->state = wake_touch ? LV_INDEV_STATE_RELEASED : LV_INDEV_STATE_PRESSED;
 
       /*Set the coordinates*/
       data->point.x = touch_last_x;
@@ -100,6 +313,7 @@ void my_touchpad_read(lv_indev_t *indev, lv_indev_data_t *data)
     else if (touch_released())
     {
       data->state = LV_INDEV_STATE_RELEASED;
+      wake_touch = false;
     }
   }
   else
@@ -187,6 +401,8 @@ static void event_handler(lv_event_t * e)
 
 void setup()
 {
+  // 截图按整行写入串口，缓冲放得下一行时才不会阻塞 loop()
+  Serial.setTxBufferSize(FRAME_CAPTURE_SERIAL_TX_BUFFER);
   Serial.begin(115200);
   Serial.println("SenseCap Indicator startup");
   String LVGL_Arduino = String('V') + lv_version_major() + "." + lv_version_minor() + "." + lv_version_patch();
@@ -203,6 +419,7 @@ void setup()
   myPacketSerial.setPacketHandler(&onPacketReceived);
 
   // Init Display
+  static_cast<Indicator_PanelBus *>(bus)->setInitStream(st7701_indicator_init_stream.view());
   if (!gfx->begin(12000000L))
   {
     Serial.println("gfx->begin() failed!");
@@ -210,9 +427,21 @@ void setup()
   }
   gfx->fillScreen(RGB565_BLACK);
 
+  // 面板初始化的总线操作统计 (时间包含 Sleep Out 后的 120ms 延时)
+  const Indicator_PanelBus_Stats &bus_stats = static_cast<Indicator_PanelBus *>(bus)->stats();
+  Serial.printf("Panel init: %u words in %u us, CS edges %u (%u saved), MOSI writes %u (%u saved), %u SPI transactions\n",
+                bus_stats.words, bus_stats.batch_us, bus_stats.cs_edges, bus_stats.cs_edges_saved,
+                bus_stats.mosi_writes, bus_stats.mosi_writes_saved, bus_stats.transactions);
+  const extender_stats_t *ext_stats = extender_get_stats();
+  Serial.printf("Expander: %u I2C writes, %u saved (%u unchanged, %u coalesced)\n", ext_stats->writes,
+                ext_stats->saved_unchanged + ext_stats->saved_coalesced,
+                ext_stats->saved_unchanged, ext_stats->saved_coalesced);
+
+  // 背光由显示休眠按 PWM 控制，按键用于唤醒
 #ifdef GFX_BL
-  pinMode(GFX_BL, OUTPUT);
-  digitalWrite(GFX_BL, HIGH);
+  DisplaySleep_Init(bus, GFX_BL, BUTTON_PIN);
+#else
+  DisplaySleep_Init(bus, -1, BUTTON_PIN);
 #endif
   lv_init();
 
@@ -225,6 +454,10 @@ void setup()
 #endif
 
   lv_screen_init(gfx, HOR_RES, VER_RES);
+  if (!lv_screen_attach_vsync(LCD_VSYNC_PIN))
+  {
+    Serial.println("VSYNC interrupt not available, LVGL refreshes on its timer");
+  }
   //lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_0);
   //lv_display_set_antialiasing(disp,false);
 
@@ -239,6 +472,15 @@ void setup()
   WindChimeScreenCreate(event_handler);
   ControlPanelCreate(event_handler);
   WiFiConfigCreate(event_handler);
+  lv_obj_add_event_cb(windchime_screen, windchime_l8_cb, LV_EVENT_SCREEN_LOADED, NULL);
+  lv_obj_add_event_cb(windchime_screen, windchime_l8_cb, LV_EVENT_SCREEN_UNLOAD_START, NULL);
+  WindChimeSetPaletteCallback(lv_screen_set_l8_palette);
+  WindChimeSetEventCallback(windchime_event_cb);
+  DisplaySleep_SetCallback(display_sleep_cb);
+  FlushHeatmap_NameScreen(windchime_screen, "WindChime");
+  FlushHeatmap_NameScreen(screen2, "Screen2");
+  FlushHeatmap_NameScreen(control_panel_screen, "ControlPanel");
+  FlushHeatmap_NameScreen(wifi_config_screen, "WiFiConfig");
   
   // 初始化WiFi管理器
   WiFiManager_Init();
@@ -254,6 +496,15 @@ void setup()
   AudioFeedbackInit();
 
   lv_screen_load(windchime_screen);
+
+  // 首次启动时在风铃界面上测量各渲染模式，结果保存后不再重复；
+  // 网络此时还没连上，测量时会给 WiFi/MQTT 预留 SRAM
+  if (!lv_screen_has_saved_mode())
+  {
+    lv_screen_autotune();
+    lv_screen_set_l8(windchime_l8); // The tuner switched back to an RGB565 mode
+    WindChimeSetIndexed(lv_screen_is_l8());
+  }
   
   // 自动启动数据模拟（演示用）
   DataSimulatorInit();
@@ -268,6 +519,8 @@ void setup()
 void loop()
 {
   static TickType_t xLastWakeTime = xTaskGetTickCount();
+
+  PerfMonitor_LoopBegin();
   
   /*
   unsigned long startTime = millis();
@@ -289,7 +542,28 @@ void loop()
     // user-defined packet to the sender.
   }
 
+  poll_serial_commands();
+
   lv_task_handler(); /* let the GUI do its work */
+
+  // 按面板 VSYNC 节拍刷新
+  lv_screen_vsync_poll();
+
+  // 空闲调暗/熄灭，按键唤醒
+  DisplaySleep_Update();
+
+  if (network_connected)
+  {
+    network_connected = false;
+    lv_screen_network_up();
+  }
+
+  // 截图按时间预算分步进行，读帧缓冲前先等异步刷新写完
+  if (FrameCaptureIsRunning())
+  {
+    lv_screen_flush_drain();
+    FrameCaptureUpdate();
+  }
   
   // 更新WiFi管理器状态
   WiFiManager_Update();
@@ -297,6 +571,8 @@ void loop()
   // 更新MQTT管理器状态
   MQTTManager_Update();
 
+  PerfMonitor_LoopEnd();
+
   // Simple delay always 5ms
   //delay(5);
 
@@ -6,6 +6,91 @@ PCA9555 ioex;
 
 bool extender_init_done = false;
 
+// Shadow registers. The chip keeps its registers across an ESP32 reset,
+// so the first write of each one is always sent.
+typedef struct {
+  uint16_t value;
+  uint16_t written; // Last value sent
+  bool valid;       // written is what the chip holds
+  bool dirty;       // changed inside a batch, not written yet
+  uint16_t changes; // pin changes since the last write
+} extender_reg_t;
+
+static extender_reg_t out_reg = { 0xFFFF, 0xFFFF, false, false, 0 }; // Power-on: all high
+static extender_reg_t dir_reg = { 0xFFFF, 0xFFFF, false, false, 0 }; // Power-on: all inputs
+static uint8_t batch_depth = 0;
+static extender_stats_t stats = { 0, 0, 0 };
+
+static bool reg_flush(extender_reg_t * reg, bool (*send)(uint16_t))
+{
+  if (!reg->dirty) return true;
+  reg->dirty = false;
+  if (reg->valid && reg->value == reg->written)
+  {
+    // The batch put everything back
+    stats.saved_unchanged += reg->changes;
+    reg->changes = 0;
+    return true;
+  }
+  stats.saved_coalesced += reg->changes - 1;
+  reg->changes = 0;
+  stats.writes++;
+  reg->written = reg->value;
+  reg->valid = send(reg->value);
+  return reg->valid;
+}
+
+static bool reg_set(extender_reg_t * reg, uint8_t bit, bool high, bool (*send)(uint16_t))
+{
+  uint16_t value = high ? (reg->value | (1 << bit)) : (reg->value & ~(1 << bit));
+  if (value == reg->value && (reg->valid || reg->dirty))
+  {
+    stats.saved_unchanged++;
+    return true;
+  }
+  reg->value = value;
+  reg->dirty = true;
+  reg->changes++;
+  return batch_depth ? true : reg_flush(reg, send);
+}
+
+static bool send_output(uint16_t value)
+{
+  return ioex.write(value);
+}
+
+static bool send_direction(uint16_t value)
+{
+  return ioex.direction(value);
+}
+
+bool extender_write(PCA95x5::Port::Port port, PCA95x5::Level::Level level)
+{
+  return reg_set(&out_reg, port, level == PCA95x5::Level::H, send_output);
+}
+
+bool extender_direction(PCA95x5::Port::Port port, PCA95x5::Direction::Direction dir)
+{
+  return reg_set(&dir_reg, port, dir == PCA95x5::Direction::IN, send_direction);
+}
+
+void extender_begin_batch(void)
+{
+  batch_depth++;
+}
+
+bool extender_end_batch(void)
+{
+  if (batch_depth == 0 || --batch_depth > 0) return true;
+  bool ok = reg_flush(&out_reg, send_output);
+  return reg_flush(&dir_reg, send_direction) && ok;
+}
+
+const extender_stats_t * extender_get_stats(void)
+{
+  return &stats;
+}
+
 void extender_init(void)
 {
   if (!extender_init_done)
@@ -16,40 +101,44 @@ void extender_init(void)
 
     ioex.polarity(PCA95x5::Polarity::ORIGINAL_ALL);
 
+    extender_begin_batch();
+
     // LCD Reset PIN
-    ioex.write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::L);
-    ioex.direction(EXPANDER_IO_LCD_RESET, PCA95x5::Direction::OUT);
+    extender_write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::L);
+    extender_direction(EXPANDER_IO_LCD_RESET, PCA95x5::Direction::OUT);
 
     // Touchscreen interupt PIN
-    ioex.direction(EXPANDER_IO_LCD_INT, PCA95x5::Direction::IN);
+    extender_direction(EXPANDER_IO_LCD_INT, PCA95x5::Direction::IN);
 
     // Touchscreen reset PIN
-    ioex.write(EXPANDER_IO_TP_RESET, PCA95x5::Level::L);
-    ioex.direction(EXPANDER_IO_TP_RESET, PCA95x5::Direction::OUT);
+    extender_write(EXPANDER_IO_TP_RESET, PCA95x5::Level::L);
+    extender_direction(EXPANDER_IO_TP_RESET, PCA95x5::Direction::OUT);
 
     // RP2040 reset PIN
-    ioex.direction(EXPANDER_IO_RP2040_RESET, PCA95x5::Direction::OUT);
-    ioex.write(EXPANDER_IO_RP2040_RESET, PCA95x5::Level::H);
+    extender_direction(EXPANDER_IO_RP2040_RESET, PCA95x5::Direction::OUT);
+    extender_write(EXPANDER_IO_RP2040_RESET, PCA95x5::Level::H);
 
     // Expander power PIN
-    ioex.direction(EXPANDER_IO_BMP_PWR, PCA95x5::Direction::OUT);
-    ioex.write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::H);
+    extender_direction(EXPANDER_IO_BMP_PWR, PCA95x5::Direction::OUT);
+    extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::H);
 
 
     // SX126x init
-    ioex.write(EXPANDER_IO_RADIO_NSS, PCA95x5::Level::H);
-    ioex.direction(EXPANDER_IO_RADIO_NSS, PCA95x5::Direction::OUT); //output
-    ioex.direction(EXPANDER_IO_RADIO_RST, PCA95x5::Direction::OUT); //output
-    ioex.direction(EXPANDER_IO_RADIO_BUSY, PCA95x5::Direction::IN); //input
-    ioex.direction(EXPANDER_IO_RADIO_DIO_1, PCA95x5::Direction::IN); //input
+    extender_write(EXPANDER_IO_RADIO_NSS, PCA95x5::Level::H);
+    extender_direction(EXPANDER_IO_RADIO_NSS, PCA95x5::Direction::OUT); //output
+    extender_direction(EXPANDER_IO_RADIO_RST, PCA95x5::Direction::OUT); //output
+    extender_direction(EXPANDER_IO_RADIO_BUSY, PCA95x5::Direction::IN); //input
+    extender_direction(EXPANDER_IO_RADIO_DIO_1, PCA95x5::Direction::IN); //input
 
-    delay(5);
+    extender_end_batch();
 
-    // Reset LCD
-    ioex.write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::H);
+    delay(5);
 
-    // Reset touchscreen
-    ioex.write(EXPANDER_IO_TP_RESET, PCA95x5::Level::H);
+    // Reset LCD and touchscreen
+    extender_begin_batch();
+    extender_write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::H);
+    extender_write(EXPANDER_IO_TP_RESET, PCA95x5::Level::H);
+    extender_end_batch();
 
     delay(5);
 
@@ -42,6 +42,24 @@ extern "C" {
 
 void extender_init(void);
 
+// Shadow copies of the output and configuration registers. A pin change only
+// goes over I2C when it changes the register, as one 2-byte port write.
+// Between extender_begin_batch() and extender_end_batch() changes are collected
+// and written once per register (output before configuration, so a pin turned
+// into an output drives the level set for it in the same batch).
+bool extender_write(PCA95x5::Port::Port port, PCA95x5::Level::Level level);
+bool extender_direction(PCA95x5::Port::Port port, PCA95x5::Direction::Direction dir);
+void extender_begin_batch(void);
+bool extender_end_batch(void);
+
+typedef struct {
+  uint32_t writes;           // Register writes sent over I2C
+  uint32_t saved_unchanged;  // Pin calls that left the register as it was
+  uint32_t saved_coalesced;  // Pin changes folded into another write of a batch
+} extender_stats_t;
+
+const extender_stats_t * extender_get_stats(void);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -0,0 +1,172 @@
+#include "Indicator_HWSPI.h"
+#include "Indicator_Extender.h"
+
+Indicator_HWSPI::Indicator_HWSPI(int8_t cs, int8_t sck, int8_t mosi, spi_host_device_t host /* = SPI2_HOST */)
+    : Indicator_PanelBus(cs), _sck(sck), _mosi(mosi), _host(host)
+{
+}
+
+bool Indicator_HWSPI::begin(int32_t speed, int8_t dataMode)
+{
+  extender_init();
+  CS_INIT();
+
+  if (!_spi)
+  {
+    spi_bus_config_t buscfg = {};
+    buscfg.mosi_io_num = _mosi;
+    buscfg.miso_io_num = -1;
+    buscfg.sclk_io_num = _sck;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = PANEL_FRAME_MAX_BYTES;
+    esp_err_t err = spi_bus_initialize(_host, &buscfg, SPI_DMA_DISABLED);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+    {
+      return false;
+    }
+
+    // Same waveform as the bit-banged bus: SCK idles low, MOSI sampled on the rising edge
+    spi_device_interface_config_t devcfg = {};
+    devcfg.mode = (dataMode == GFX_NOT_DEFINED) ? 0 : dataMode;
+    devcfg.clock_speed_hz = (speed == GFX_NOT_DEFINED) ? HWSPI_DEFAULT_SPEED : speed;
+    devcfg.spics_io_num = -1; // CS is on the expander
+    devcfg.queue_size = 1;
+    if (spi_bus_add_device(_host, &devcfg, &_spi) != ESP_OK)
+    {
+      return false;
+    }
+  }
+
+  if (_initStream.words)
+  {
+    writeInitStream(_initStream);
+  }
+
+  return true;
+}
+
+void Indicator_HWSPI::beginWrite()
+{
+  CS_LOW();
+}
+
+void Indicator_HWSPI::endWrite()
+{
+  // Also the last chance before a batch's DELAY
+  FLUSH();
+  CS_RELEASE();
+}
+
+void Indicator_HWSPI::writeCommand(uint8_t c)
+{
+  PUT(c, 9);
+}
+
+void Indicator_HWSPI::writeCommand16(uint16_t c)
+{
+  _data16.value = c;
+  PUT(_data16.msb, 9);
+  PUT(_data16.lsb, 9);
+}
+
+void Indicator_HWSPI::writeCommandBytes(uint8_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    PUT(*data++, 9);
+  }
+}
+
+void Indicator_HWSPI::write(uint8_t d)
+{
+  PUT(PANEL_FRAME_DATA | d, 9);
+}
+
+void Indicator_HWSPI::write16(uint16_t d)
+{
+  _data16.value = d;
+  PUT(PANEL_FRAME_DATA | _data16.msb, 9);
+  PUT(PANEL_FRAME_DATA | _data16.lsb, 9);
+}
+
+void Indicator_HWSPI::writeRepeat(uint16_t p, uint32_t len)
+{
+  _data16.value = p;
+  while (len--)
+  {
+    PUT(PANEL_FRAME_DATA | _data16.msb, 9);
+    PUT(PANEL_FRAME_DATA | _data16.lsb, 9);
+  }
+}
+
+// Raw 16-bit words, like Indicator_SWSPI::writePixels()
+void Indicator_HWSPI::writePixels(uint16_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    PUT(*data++, 16);
+  }
+}
+
+#if !defined(LITTLE_FOOT_PRINT)
+// Raw 8-bit words, like Indicator_SWSPI::writeBytes()
+void Indicator_HWSPI::writeBytes(uint8_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    PUT(*data++, 8);
+  }
+}
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+void Indicator_HWSPI::writeInitStream(const ST7701InitStreamView &stream)
+{
+  uint32_t start = micros();
+
+  CS_LOW();
+  uint32_t bit = 0;
+  for (uint8_t i = 0; i < stream.segment_count; i++)
+  {
+    const ST7701InitSegment &segment = stream.segments[i];
+    // Segments are not byte aligned in the stream, repack them into frames
+    for (uint16_t w = 0; w < segment.words; w++, bit += 9)
+    {
+      PUT(panel_frame_get(stream.bits, bit, 9), 9);
+    }
+    FLUSH();
+    if (segment.delay_ms)
+    {
+      delay(segment.delay_ms);
+    }
+  }
+  CS_HIGH();
+
+  _stats.batch_us = micros() - start;
+}
+
+void Indicator_HWSPI::PUT(uint16_t value, uint8_t bits)
+{
+  if (!_frame.fits(bits))
+  {
+    FLUSH();
+  }
+  _frame.put(value, bits);
+  _stats.words++;
+}
+
+// The SPI host sends the buffer MSB first and stops after length bits,
+// so a frame that does not end on a byte boundary goes out as packed
+void Indicator_HWSPI::FLUSH(void)
+{
+  if (!_frame.bits || !_spi)
+  {
+    return;
+  }
+  spi_transaction_t t = {};
+  t.length = _frame.bits;
+  t.tx_buffer = _frame.buf;
+  spi_device_polling_transmit(_spi, &t);
+  _stats.transactions++;
+  _frame.clear();
+}
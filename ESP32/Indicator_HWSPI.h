@@ -0,0 +1,45 @@
+#ifndef _Indicator_HWSPI_H_
+#define _Indicator_HWSPI_H_
+
+#include <driver/spi_master.h>
+#include "Indicator_PanelBus.h"
+#include "src/Display/PanelFrame.h"
+
+#define HWSPI_DEFAULT_SPEED 10000000 // ST7701 write cycle is >= 66 ns
+
+// 3-wire (9-bit) panel command bus on an ESP32-S3 SPI host. CS stays on the
+// expander; words are packed by PanelFrame exactly as Indicator_SWSPI clocks
+// them out and sent as one transaction per frame (up to 56 9-bit words).
+class Indicator_HWSPI : public Indicator_PanelBus
+{
+public:
+  Indicator_HWSPI(int8_t cs, int8_t sck, int8_t mosi, spi_host_device_t host = SPI2_HOST);
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) override;
+  void beginWrite() override;
+  void endWrite() override;
+  void writeCommand(uint8_t) override;
+  void writeCommand16(uint16_t) override;
+  void writeCommandBytes(uint8_t *data, uint32_t len) override;
+  void write(uint8_t) override;
+  void write16(uint16_t) override;
+  void writeRepeat(uint16_t p, uint32_t len) override;
+  void writePixels(uint16_t *data, uint32_t len) override;
+
+#if !defined(LITTLE_FOOT_PRINT)
+  void writeBytes(uint8_t *data, uint32_t len) override;
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+  void writeInitStream(const ST7701InitStreamView &stream) override;
+
+private:
+  void PUT(uint16_t value, uint8_t bits);
+  void FLUSH(void);
+
+  int8_t _sck, _mosi;
+  spi_host_device_t _host;
+  spi_device_handle_t _spi = NULL;
+  PanelFrame _frame = {};
+};
+
+#endif // _Indicator_HWSPI_H_
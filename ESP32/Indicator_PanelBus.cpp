@@ -0,0 +1,79 @@
+#include "Indicator_PanelBus.h"
+#include "Indicator_Extender.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+void Indicator_PanelBus::batchOperation(const uint8_t *operations, size_t len)
+{
+  uint32_t start = micros();
+
+  // In 3-wire mode every word carries its own D/C bit, so the ST7701 does not
+  // need CS to go high between commands; the stream it sees is unchanged
+  _batching = true;
+  Arduino_DataBus::batchOperation(operations, len);
+  _batching = false;
+  _csReleaseDeferred = false;
+  if (_csLow)
+  {
+    CS_HIGH();
+  }
+
+  _stats.batch_us = micros() - start;
+}
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+void Indicator_PanelBus::CS_INIT(void)
+{
+  if (_cs != GFX_NOT_DEFINED)
+  {
+    // LCD CS PIN
+    extender_begin_batch();
+    extender_write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::L);
+    extender_direction(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Direction::OUT);
+    extender_write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::H);
+    extender_end_batch();
+  }
+  _csLow = false;
+}
+
+void Indicator_PanelBus::CS_RELEASE(void)
+{
+  if (_batching)
+  {
+    // Released once at the end of the batch, unless the batch releases it for good
+    _csReleaseDeferred = _csLow;
+    return;
+  }
+  CS_HIGH();
+}
+
+void Indicator_PanelBus::CS_HIGH(void)
+{
+  if (_cs != GFX_NOT_DEFINED)
+  {
+    if (!_csLow)
+    {
+      _stats.cs_edges_saved++;
+      return;
+    }
+    extender_write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::H);
+    _stats.cs_edges++;
+    _csLow = false;
+  }
+}
+
+void Indicator_PanelBus::CS_LOW(void)
+{
+  if (_cs != GFX_NOT_DEFINED)
+  {
+    if (_csLow)
+    {
+      // A deferred release followed by this assert is a high/low pair not sent
+      _stats.cs_edges_saved += _csReleaseDeferred ? 2 : 1;
+      _csReleaseDeferred = false;
+      return;
+    }
+    extender_write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::L);
+    _stats.cs_edges++;
+    _csLow = true;
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef _Indicator_PanelBus_H_
+#define _Indicator_PanelBus_H_
+
+#include "Arduino_DataBus.h"
+#include "src/Display/ST7701InitStream.h"
+
+// Bus operation counters. CS sits on the PCA9555, every CS edge is an I2C write.
+struct Indicator_PanelBus_Stats
+{
+  uint32_t words;             // Words shifted out (9-bit in 3-wire mode)
+  uint32_t cs_edges;          // CS edges written to the expander
+  uint32_t cs_edges_saved;    // CS edges skipped: held across a batch, or already at that level
+  uint32_t mosi_writes;       // Bit-banged MOSI level changes (Indicator_SWSPI)
+  uint32_t mosi_writes_saved; // MOSI already at the bit's level
+  uint32_t transactions;      // SPI host transactions (Indicator_HWSPI)
+  uint32_t batch_us;          // Duration of the last init stream or batchOperation()
+};
+
+// What the panel command buses share: CS on the expander, held across batches,
+// the precompiled init stream and the counters. Subclasses only move bits.
+class Indicator_PanelBus : public Arduino_DataBus
+{
+public:
+  Indicator_PanelBus(int8_t cs) : _cs(cs) {}
+
+#if !defined(LITTLE_FOOT_PRINT)
+  // Keeps CS asserted from the first BEGIN_WRITE to the end of the sequence,
+  // END_WRITE/BEGIN_WRITE pairs in between (e.g. around a DELAY) cost nothing
+  void batchOperation(const uint8_t *operations, size_t len) override;
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+  // Precompiled 9-bit init stream, sent with CS held at the end of begin().
+  // Use it instead of passing init operations to the display.
+  void setInitStream(const ST7701InitStreamView &stream) { _initStream = stream; }
+  virtual void writeInitStream(const ST7701InitStreamView &stream) = 0;
+
+  const Indicator_PanelBus_Stats &stats() const { return _stats; }
+  void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+protected:
+  void CS_INIT(void);    // Expander pin as output, released
+  void CS_RELEASE(void); // endWrite(): deferred to the end of a batch
+  void CS_HIGH(void);
+  void CS_LOW(void);
+
+  int8_t _cs;
+  bool _csLow = false;
+  bool _batching = false;
+  bool _csReleaseDeferred = false;
+  Indicator_PanelBus_Stats _stats = {};
+  ST7701InitStreamView _initStream = {};
+};
+
+#endif // _Indicator_PanelBus_H_
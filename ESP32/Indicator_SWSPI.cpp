@@ -4,11 +4,13 @@
  */
 #include "Indicator_SWSPI.h"
 #include "Indicator_Extender.h"
-
-extern PCA9555 ioex;
+#if defined(ESP32) && !defined(SWSPI_NO_DIRECT_GPIO)
+#include <soc/gpio_struct.h>
+#include <esp_cpu.h>
+#endif
 
 Indicator_SWSPI::Indicator_SWSPI(int8_t dc, int8_t cs, int8_t sck, int8_t mosi, int8_t miso /* = GFX_NOT_DEFINED */)
-    : _dc(dc), _cs(cs), _sck(sck), _mosi(mosi), _miso(miso)
+    : Indicator_PanelBus(cs), _dc(dc), _sck(sck), _mosi(mosi), _miso(miso)
 {
 }
 
@@ -16,30 +18,37 @@ bool Indicator_SWSPI::begin(int32_t, int8_t)
 {
   extender_init();
 
-  if (_cs != GFX_NOT_DEFINED)
-  {
-    // LCD CS PIN
-    ioex.write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::L);
-    ioex.direction(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Direction::OUT);
-  }
+  CS_INIT();
   if (_dc != GFX_NOT_DEFINED)
   {
     pinMode(_dc, OUTPUT);
     digitalWrite(_dc, HIGH); // Data mode
   }
-  if (_cs != GFX_NOT_DEFINED)
-  {
-    ioex.write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::H);
-  }
   pinMode(_sck, OUTPUT);
   digitalWrite(_sck, LOW);
   pinMode(_mosi, OUTPUT);
   digitalWrite(_mosi, LOW);
+  _mosiLevel = LOW;
   if (_miso != GFX_NOT_DEFINED)
   {
     pinMode(_miso, INPUT);
   }
 
+#if defined(ESP32) && !defined(SWSPI_NO_DIRECT_GPIO)
+  _sckSetReg = _sck < 32 ? &GPIO.out_w1ts : &GPIO.out1_w1ts.val;
+  _sckClrReg = _sck < 32 ? &GPIO.out_w1tc : &GPIO.out1_w1tc.val;
+  _mosiSetReg = _mosi < 32 ? &GPIO.out_w1ts : &GPIO.out1_w1ts.val;
+  _mosiClrReg = _mosi < 32 ? &GPIO.out_w1tc : &GPIO.out1_w1tc.val;
+  _sckBit = 1UL << (_sck & 31);
+  _mosiBit = 1UL << (_mosi & 31);
+  _halfCycleCycles = (SWSPI_MIN_HALF_CYCLE_NS * ESP.getCpuFreqMHz() + 999) / 1000;
+#endif
+
+  if (_initStream.words)
+  {
+    writeInitStream(_initStream);
+  }
+
   return true;
 }
 
@@ -54,7 +63,7 @@ void Indicator_SWSPI::beginWrite()
 
 void Indicator_SWSPI::endWrite()
 {
-  CS_HIGH();
+  CS_RELEASE();
 }
 
 void Indicator_SWSPI::writeCommand(uint8_t c)
@@ -185,8 +194,31 @@ void Indicator_SWSPI::writeBytes(uint8_t *data, uint32_t len)
 }
 #endif // !defined(LITTLE_FOOT_PRINT)
 
+void Indicator_SWSPI::writeInitStream(const ST7701InitStreamView &stream)
+{
+  uint32_t start = micros();
+
+  CS_LOW();
+  uint32_t bit = 0;
+  for (uint8_t i = 0; i < stream.segment_count; i++)
+  {
+    const ST7701InitSegment &segment = stream.segments[i];
+    WRITEBITS(stream.bits, bit, segment.words * 9);
+    bit += segment.words * 9;
+    _stats.words += segment.words;
+    if (segment.delay_ms)
+    {
+      delay(segment.delay_ms);
+    }
+  }
+  CS_HIGH();
+
+  _stats.batch_us = micros() - start;
+}
+
 GFX_INLINE void Indicator_SWSPI::WRITE9BITCOMMAND(uint8_t c)
 {
+  _stats.words++;
   // D/C bit, command
   SPI_MOSI_LOW();
   SPI_SCK_HIGH();
@@ -211,6 +243,7 @@ GFX_INLINE void Indicator_SWSPI::WRITE9BITCOMMAND(uint8_t c)
 
 GFX_INLINE void Indicator_SWSPI::WRITE9BITDATA(uint8_t d)
 {
+  _stats.words++;
   // D/C bit, data
   SPI_MOSI_HIGH();
   SPI_SCK_HIGH();
@@ -235,6 +268,7 @@ GFX_INLINE void Indicator_SWSPI::WRITE9BITDATA(uint8_t d)
 
 GFX_INLINE void Indicator_SWSPI::WRITE(uint8_t d)
 {
+  _stats.words++;
   uint8_t bit = 0x80;
   while (bit)
   {
@@ -254,6 +288,7 @@ GFX_INLINE void Indicator_SWSPI::WRITE(uint8_t d)
 
 GFX_INLINE void Indicator_SWSPI::WRITE16(uint16_t d)
 {
+  _stats.words++;
   uint16_t bit = 0x8000;
   while (bit)
   {
@@ -322,6 +357,81 @@ GFX_INLINE void Indicator_SWSPI::WRITEREPEAT(uint16_t p, uint32_t len)
   }
 }
 
+// Clocks out count bits of a packed MSB-first stream starting at bit first.
+// Whole bytes go through an unrolled loop; MOSI and SCK are written through
+// the GPIO set/clear registers. Back-to-back register writes can sit in the
+// write buffer and reach the pins closer together than the CPU issued them,
+// so before each SCK edge the output register is read back (the read waits
+// for the writes before it) and the level held for _halfCycleCycles: MOSI has
+// that long to settle before the rising edge, SCK stays high that long.
+GFX_INLINE void Indicator_SWSPI::WRITEBITS(const uint8_t *bits, uint32_t first, uint32_t count)
+{
+  uint32_t end = first + count;
+#if defined(ESP32) && !defined(SWSPI_NO_DIRECT_GPIO)
+  const uint32_t hold = _halfCycleCycles;
+  volatile uint32_t *sckOut = _sckSetReg == &GPIO.out_w1ts ? &GPIO.out : &GPIO.out1.val;
+#define SWSPI_HOLD()                                                    \
+  do                                                                    \
+  {                                                                     \
+    (void)*sckOut;                                                      \
+    uint32_t t = (uint32_t)esp_cpu_get_cycle_count();                  \
+    while ((uint32_t)esp_cpu_get_cycle_count() - t < hold)              \
+    {                                                                   \
+    }                                                                   \
+  } while (0)
+#define SWSPI_BIT(b, mask)                                              \
+  do                                                                    \
+  {                                                                     \
+    *(((b) & (mask)) ? _mosiSetReg : _mosiClrReg) = _mosiBit;           \
+    SWSPI_HOLD();                                                       \
+    *_sckSetReg = _sckBit;                                              \
+    SWSPI_HOLD();                                                       \
+    *_sckClrReg = _sckBit;                                              \
+  } while (0)
+
+  while (first < end && (first & 7))
+  {
+    SWSPI_BIT(bits[first >> 3], 0x80 >> (first & 7));
+    first++;
+  }
+  while (end - first >= 8)
+  {
+    uint8_t b = bits[first >> 3];
+    SWSPI_BIT(b, 0x80);
+    SWSPI_BIT(b, 0x40);
+    SWSPI_BIT(b, 0x20);
+    SWSPI_BIT(b, 0x10);
+    SWSPI_BIT(b, 0x08);
+    SWSPI_BIT(b, 0x04);
+    SWSPI_BIT(b, 0x02);
+    SWSPI_BIT(b, 0x01);
+    first += 8;
+  }
+  while (first < end)
+  {
+    SWSPI_BIT(bits[first >> 3], 0x80 >> (first & 7));
+    first++;
+  }
+#undef SWSPI_BIT
+#undef SWSPI_HOLD
+  _mosiLevel = -1; // Written behind digitalWrite()'s back
+#else
+  for (; first < end; first++)
+  {
+    if (bits[first >> 3] & (0x80 >> (first & 7)))
+    {
+      SPI_MOSI_HIGH();
+    }
+    else
+    {
+      SPI_MOSI_LOW();
+    }
+    SPI_SCK_HIGH();
+    SPI_SCK_LOW();
+  }
+#endif
+}
+
 /******** low level bit twiddling **********/
 
 GFX_INLINE void Indicator_SWSPI::DC_HIGH(void)
@@ -334,28 +444,19 @@ GFX_INLINE void Indicator_SWSPI::DC_LOW(void)
   digitalWrite(_dc, LOW);
 }
 
-GFX_INLINE void Indicator_SWSPI::CS_HIGH(void)
-{
-  if (_cs != GFX_NOT_DEFINED)
-  {
-    ioex.write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::H);
-  }
-}
-
-GFX_INLINE void Indicator_SWSPI::CS_LOW(void)
-{
-  if (_cs != GFX_NOT_DEFINED)
-  {
-    ioex.write(static_cast<PCA95x5::Port::Port>(_cs), PCA95x5::Level::L);
-  }
-}
-
 /*!
     @brief  Set the software (bitbang) SPI MOSI line HIGH.
 */
 GFX_INLINE void Indicator_SWSPI::SPI_MOSI_HIGH(void)
 {
+  if (_mosiLevel == HIGH)
+  {
+    _stats.mosi_writes_saved++;
+    return;
+  }
   digitalWrite(_mosi, HIGH);
+  _mosiLevel = HIGH;
+  _stats.mosi_writes++;
 }
 
 /*!
@@ -363,7 +464,14 @@ GFX_INLINE void Indicator_SWSPI::SPI_MOSI_HIGH(void)
 */
 GFX_INLINE void Indicator_SWSPI::SPI_MOSI_LOW(void)
 {
+  if (_mosiLevel == LOW)
+  {
+    _stats.mosi_writes_saved++;
+    return;
+  }
   digitalWrite(_mosi, LOW);
+  _mosiLevel = LOW;
+  _stats.mosi_writes++;
 }
 
 /*!
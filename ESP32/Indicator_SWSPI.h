@@ -5,9 +5,16 @@
 #ifndef _Indicator_SWSPI_H_
 #define _Indicator_SWSPI_H_
 
-#include "Arduino_DataBus.h"
+#include "Indicator_PanelBus.h"
 
-class Indicator_SWSPI : public Arduino_DataBus
+// ST7701S 3-wire write timing: SCL cycle >= 66 ns, so each SCK phase of the
+// register path is held for at least half of that plus margin
+#define SWSPI_MIN_HALF_CYCLE_NS 40
+// Define to send the init stream through digitalWrite() even on ESP32
+// #define SWSPI_NO_DIRECT_GPIO
+
+// Bit-banged 3-wire bus, MOSI is only written when the level changes
+class Indicator_SWSPI : public Indicator_PanelBus
 {
 public:
   Indicator_SWSPI(int8_t dc, int8_t cs, int8_t _sck, int8_t _mosi, int8_t _miso = GFX_NOT_DEFINED); // Constructor
@@ -27,6 +34,8 @@ public:
   void writeBytes(uint8_t *data, uint32_t len) override;
 #endif // !defined(LITTLE_FOOT_PRINT)
 
+  void writeInitStream(const ST7701InitStreamView &stream) override;
+
 private:
   GFX_INLINE void WRITE9BITCOMMAND(uint8_t c);
   GFX_INLINE void WRITE9BITDATA(uint8_t d);
@@ -34,19 +43,27 @@ private:
   GFX_INLINE void WRITE16(uint16_t d);
   GFX_INLINE void WRITE9BITREPEAT(uint16_t p, uint32_t len);
   GFX_INLINE void WRITEREPEAT(uint16_t p, uint32_t len);
+  GFX_INLINE void WRITEBITS(const uint8_t *bits, uint32_t first, uint32_t count);
   GFX_INLINE void DC_HIGH(void);
   GFX_INLINE void DC_LOW(void);
-  GFX_INLINE void CS_HIGH(void);
-  GFX_INLINE void CS_LOW(void);
   GFX_INLINE void SPI_MOSI_HIGH(void);
   GFX_INLINE void SPI_MOSI_LOW(void);
   GFX_INLINE void SPI_SCK_HIGH(void);
   GFX_INLINE void SPI_SCK_LOW(void);
   GFX_INLINE bool SPI_MISO_READ(void);
 
-  int8_t _dc, _cs;
+  int8_t _dc;
   int8_t _sck, _mosi, _miso;
 
+  int8_t _mosiLevel = -1; // Unknown until first written
+
+#if defined(ESP32) && !defined(SWSPI_NO_DIRECT_GPIO)
+  // GPIO set/clear registers for the packed stream sender, digitalWrite() is ~10x slower
+  volatile uint32_t *_sckSetReg, *_sckClrReg, *_mosiSetReg, *_mosiClrReg;
+  uint32_t _sckBit, _mosiBit;
+  uint32_t _halfCycleCycles; // SWSPI_MIN_HALF_CYCLE_NS in CPU cycles
+#endif
+
   // CLASS INSTANCE VARIABLES --------------------------------------------
 
   // Here be dragons! There's a big union of three structures here --
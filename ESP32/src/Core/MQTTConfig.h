@@ -12,11 +12,13 @@
 #define MQTT_TOPIC_EVENTS "windchime/events"
 #define MQTT_TOPIC_STATUS "windchime/status"
 #define MQTT_TOPIC_HEARTBEAT "windchime/heartbeat"
+#define MQTT_TOPIC_CAPTURE "windchime/capture"     // 截图分包，二进制
 
 // 连接配置
 #define MQTT_RECONNECT_INTERVAL 5000    // 5秒重连间隔
 #define MQTT_CONNECT_TIMEOUT 10000      // 10秒连接超时
 #define MQTT_HEARTBEAT_INTERVAL 30000   // 30秒心跳间隔
+#define MQTT_PERF_REPORT_INTERVAL 60000 // 60秒发布一次带计时直方图的状态，发布后清零
 
 // QoS配置
 #define MQTT_QOS_EVENTS 1               // 事件消息QoS
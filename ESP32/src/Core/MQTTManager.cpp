@@ -1,6 +1,9 @@
 #include "MQTTManager.h"
 #include "WiFiManager.h"
+#include "PerfMonitor.h"
 #include "../UI/WindChime.h"
+#include "../UI/WindChimeRender.h"
+#include "../UI/ReplayBench.h"
 #include "../UI/AudioFeedback.h"
 #include "../UI/DataSimulator.h"
 #include <string.h>
@@ -15,6 +18,7 @@ static char mqtt_username[64] = {0};
 static char mqtt_password[64] = {0};
 static unsigned long last_connect_attempt = 0;
 static unsigned long last_heartbeat = 0;
+static unsigned long last_perf_report = 0;
 static const unsigned long RECONNECT_INTERVAL = MQTT_RECONNECT_INTERVAL;
 static const unsigned long HEARTBEAT_INTERVAL = MQTT_HEARTBEAT_INTERVAL;
 
@@ -107,6 +111,15 @@ void MQTTManager_Update(void)
             send_heartbeat();
             last_heartbeat = millis();
         }
+
+        // 定期发布计时直方图，每个窗口重新统计
+        if (millis() - last_perf_report > MQTT_PERF_REPORT_INTERVAL) {
+            send_status_update();
+            if (!ReplayBenchIsRunning()) { // 基准测试自己管理统计窗口
+                PerfMonitor_Reset();
+            }
+            last_perf_report = millis();
+        }
     } else {
         // 如果应该连接但未连接，尝试重连
         if (current_status == MQTT_STATUS_CONNECTING || current_status == MQTT_STATUS_RECONNECTING) {
@@ -201,6 +214,15 @@ bool MQTTManager_Publish(const char* topic, const char* payload)
     return result;
 }
 
+// 不打印日志，截图一次会发很多包
+bool MQTTManager_PublishBinary(const char* topic, const uint8_t* payload, unsigned int length)
+{
+    if (!mqtt_client.connected()) {
+        return false;
+    }
+    return mqtt_client.publish(topic, payload, length);
+}
+
 const char* MQTTManager_GetBrokerInfo(void)
 {
     static char broker_info[128];
@@ -458,6 +480,28 @@ static void send_status_update(void)
     status_doc["uptime"] = millis() / 1000;
     status_doc["audio_volume"] = GetAudioVolume();
     status_doc["simulator_running"] = DataSimulatorIsRunning();
+    status_doc["loop_util_permille"] = PerfMonitor_GetLoopUtilization();
+    status_doc["animation_idle"] = WindChimeIsAnimationIdle();
+
+    // 各阶段耗时 (微秒)
+    JsonObject perf = status_doc["perf"].to<JsonObject>();
+    for (int i = 0; i < PERF_PHASE_MAX; i++) {
+        perf_summary_t summary;
+        PerfMonitor_GetSummary((perf_phase_t)i, &summary);
+        JsonObject phase = perf[PerfMonitor_GetPhaseName((perf_phase_t)i)].to<JsonObject>();
+        phase["n"] = summary.count;
+        phase["p50"] = summary.p50_us;
+        phase["p95"] = summary.p95_us;
+        phase["p99"] = summary.p99_us;
+        phase["max"] = summary.max_us;
+    }
+
+    const windchime_ring_cache_stats_t* ring_cache = WindChimeRenderGetRingCacheStats();
+    JsonObject ring = status_doc["ring_cache"].to<JsonObject>();
+    ring["hits"] = ring_cache->hits;
+    ring["misses"] = ring_cache->misses;
+    ring["fallbacks"] = ring_cache->fallbacks;
+    ring["bytes"] = ring_cache->bytes;
     
     String status_payload;
     serializeJson(status_doc, status_payload);
@@ -27,16 +27,6 @@ typedef struct {
     data_source_t source_type;
 } mqtt_source_mapping_t;
 
-typedef struct {
-    int r;
-    int g;
-    int b;
-    float a;
-    int x_coord;
-    int y_coord;
-    int radius;
-} circle_style_t;
-
 // MQTT事件数据结构
 typedef struct {
     data_source_t source;
@@ -75,6 +65,7 @@ bool MQTTManager_Unsubscribe(const char* topic);
 
 // 发布消息（可选功能）
 bool MQTTManager_Publish(const char* topic, const char* payload);
+bool MQTTManager_PublishBinary(const char* topic, const uint8_t* payload, unsigned int length);
 
 // 工具函数
 const char* MQTTManager_GetBrokerInfo(void);
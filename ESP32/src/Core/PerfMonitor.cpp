@@ -0,0 +1,157 @@
+#include <Arduino.h>
+#include "PerfMonitor.h"
+
+#define LOOP_WINDOW_US 1000000UL // 统计窗口
+
+// 对数分桶：每个2的幂再分两半，即 1,2,3,4,6,8,12,16,24,32... 微秒
+// 40个桶覆盖到约 1 秒
+#define PERF_BUCKETS 40
+
+typedef struct {
+    uint32_t buckets[PERF_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+} perf_histogram_t;
+
+static perf_histogram_t histograms[PERF_PHASE_MAX];
+static uint32_t counters[PERF_COUNTER_MAX];
+static uint32_t cycles_per_us = 0;
+
+static const char* phase_names[PERF_PHASE_MAX] = {
+    "particles", "ripples", "orb", "visuals", "render", "flush", "frame"
+};
+
+static const char* counter_names[PERF_COUNTER_MAX] = {
+    "invalidated_px", "flushes", "flushed_px", "copied_bytes", "coalesce_passes"
+};
+
+static uint32_t loop_start_us = 0;
+static uint32_t window_start_us = 0;
+static uint32_t window_busy_us = 0;
+static uint16_t loop_utilization = 0; // 千分比
+
+static uint8_t bucket_index(uint32_t us)
+{
+    if (us == 0) return 0;
+    uint8_t msb = 31 - __builtin_clz(us);
+    uint8_t half = msb > 0 ? (us >> (msb - 1)) & 1 : 0;
+    uint8_t index = 2 * msb + half + 1;
+    return index < PERF_BUCKETS ? index : PERF_BUCKETS - 1;
+}
+
+// 桶的上界 (不含)，即下一个桶的下界
+static uint32_t bucket_upper_us(uint8_t index)
+{
+    if (index == 0) return 1;
+    uint8_t msb = index / 2;
+    uint8_t half = index % 2;
+    return (1UL << msb) + (msb > 0 ? half * (1UL << (msb - 1)) : half);
+}
+
+static uint32_t percentile_us(const perf_histogram_t* h, uint32_t permille)
+{
+    uint32_t target = ((uint64_t)h->count * permille + 999) / 1000;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < PERF_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = bucket_upper_us(i);
+            return upper < h->max_us ? upper : h->max_us;
+        }
+    }
+    return h->max_us;
+}
+
+extern "C" {
+
+void PerfMonitor_End(perf_phase_t phase, uint32_t start_cycles)
+{
+    if (phase >= PERF_PHASE_MAX) return;
+    if (cycles_per_us == 0) {
+        cycles_per_us = ESP.getCpuFreqMHz();
+    }
+
+    uint32_t us = ((uint32_t)esp_cpu_get_cycle_count() - start_cycles) / cycles_per_us;
+    perf_histogram_t* h = &histograms[phase];
+    h->buckets[bucket_index(us)]++;
+    h->count++;
+    if (us > h->max_us) h->max_us = us;
+}
+
+void PerfMonitor_Count(perf_counter_t counter, uint32_t n)
+{
+    if (counter < PERF_COUNTER_MAX) counters[counter] += n;
+}
+
+uint32_t PerfMonitor_GetCounter(perf_counter_t counter)
+{
+    return counter < PERF_COUNTER_MAX ? counters[counter] : 0;
+}
+
+const char* PerfMonitor_GetPhaseName(perf_phase_t phase)
+{
+    return phase < PERF_PHASE_MAX ? phase_names[phase] : "unknown";
+}
+
+void PerfMonitor_GetSummary(perf_phase_t phase, perf_summary_t* summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (phase >= PERF_PHASE_MAX) return;
+
+    const perf_histogram_t* h = &histograms[phase];
+    summary->count = h->count;
+    if (h->count == 0) return;
+    summary->p50_us = percentile_us(h, 500);
+    summary->p95_us = percentile_us(h, 950);
+    summary->p99_us = percentile_us(h, 990);
+    summary->max_us = h->max_us;
+}
+
+void PerfMonitor_Reset(void)
+{
+    memset(histograms, 0, sizeof(histograms));
+    memset(counters, 0, sizeof(counters));
+}
+
+void PerfMonitor_PrintReport(void)
+{
+    Serial.printf("PerfMonitor: loop utilization %u.%u%%\n", loop_utilization / 10, loop_utilization % 10);
+    Serial.printf("  %-10s %8s %8s %8s %8s %8s\n", "phase", "count", "p50us", "p95us", "p99us", "maxus");
+    for (int i = 0; i < PERF_PHASE_MAX; i++) {
+        perf_summary_t s;
+        PerfMonitor_GetSummary((perf_phase_t)i, &s);
+        Serial.printf("  %-10s %8u %8u %8u %8u %8u\n", phase_names[i],
+                      s.count, s.p50_us, s.p95_us, s.p99_us, s.max_us);
+    }
+    for (int i = 0; i < PERF_COUNTER_MAX; i++) {
+        Serial.printf("  %-16s %u\n", counter_names[i], counters[i]);
+    }
+}
+
+void PerfMonitor_LoopBegin(void)
+{
+    loop_start_us = micros();
+    if (window_start_us == 0) {
+        window_start_us = loop_start_us;
+    }
+}
+
+void PerfMonitor_LoopEnd(void)
+{
+    uint32_t now = micros();
+    window_busy_us += now - loop_start_us;
+
+    uint32_t window_us = now - window_start_us;
+    if (window_us >= LOOP_WINDOW_US) {
+        loop_utilization = (uint16_t)((uint64_t)window_busy_us * 1000 / window_us);
+        window_busy_us = 0;
+        window_start_us = now;
+    }
+}
+
+uint16_t PerfMonitor_GetLoopUtilization(void)
+{
+    return loop_utilization;
+}
+
+} // extern "C"
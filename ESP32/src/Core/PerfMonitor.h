@@ -0,0 +1,70 @@
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <esp_cpu.h>
+
+// 逐帧计时的阶段
+typedef enum {
+    PERF_PHASE_PARTICLES = 0,   // update_particles()
+    PERF_PHASE_RIPPLES,         // update_ripples()
+    PERF_PHASE_ORB,             // update_center_orb()
+    PERF_PHASE_VISUALS,         // update_visual_objects()
+    PERF_PHASE_RENDER,          // LVGL 渲染 (RENDER_START..RENDER_READY，包含 flush)
+    PERF_PHASE_FLUSH,           // my_disp_flush_*()
+    PERF_PHASE_FRAME,           // 整个 WindChime animation_callback()
+    PERF_PHASE_MAX
+} perf_phase_t;
+
+// 累计计数器，与直方图一起清零
+typedef enum {
+    PERF_COUNTER_INVALIDATED_PX = 0,  // WindChime 提交给 LVGL 的失效像素
+    PERF_COUNTER_FLUSHES,             // flush 回调次数
+    PERF_COUNTER_FLUSHED_PX,          // flush 的像素
+    PERF_COUNTER_COPIED_BYTES,        // flush 拷贝到屏幕帧缓冲的字节 (零拷贝模式为0)
+    PERF_COUNTER_COALESCE_PASSES,     // 脏区域合并扫描区域列表的遍数
+    PERF_COUNTER_MAX
+} perf_counter_t;
+
+// 直方图摘要 (微秒)，百分位取所在桶的上界
+typedef struct {
+    uint32_t count;
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} perf_summary_t;
+
+// 周期计数器，成对使用：
+//   uint32_t t = PerfMonitor_Begin();  ...  PerfMonitor_End(PERF_PHASE_X, t);
+static inline uint32_t PerfMonitor_Begin(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+void PerfMonitor_End(perf_phase_t phase, uint32_t start_cycles);
+
+void PerfMonitor_Count(perf_counter_t counter, uint32_t n);
+uint32_t PerfMonitor_GetCounter(perf_counter_t counter);
+
+// 直方图查询/清零
+const char* PerfMonitor_GetPhaseName(perf_phase_t phase);
+void PerfMonitor_GetSummary(perf_phase_t phase, perf_summary_t* summary);
+void PerfMonitor_Reset(void);
+void PerfMonitor_PrintReport(void);
+
+// 主循环利用率统计：loop() 开头/结尾各调用一次
+void PerfMonitor_LoopBegin(void);
+void PerfMonitor_LoopEnd(void);
+
+// 上一个统计窗口 (1秒) 内 loop() 忙碌时间的千分比
+uint16_t PerfMonitor_GetLoopUtilization(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERF_MONITOR_H
@@ -0,0 +1,55 @@
+#include "AreaCoalesce.h"
+
+static area_cost_model_t cost_model = {
+    AREA_COALESCE_DEFAULT_OVERHEAD_NS,
+    AREA_COALESCE_DEFAULT_PX_COST_NS
+};
+
+void AreaCoalesce_SetModel(const area_cost_model_t * model)
+{
+    cost_model = *model;
+}
+
+const area_cost_model_t * AreaCoalesce_GetModel(void)
+{
+    return &cost_model;
+}
+
+uint32_t AreaCoalesce_CostModel(lv_area_t * areas, uint8_t * joined, uint32_t count)
+{
+    uint64_t overhead = cost_model.area_overhead_ns;
+    uint64_t px_cost = cost_model.px_cost_ns;
+    uint32_t passes = 0;
+    bool merged;
+
+    // Overlapping areas are rendered twice, so the separate cost is the plain sum.
+    // Repeat while something merges, a grown area may now be worth joining with
+    // others, but at most AREA_COALESCE_MAX_PASSES times to stay O(n^2).
+    do {
+        merged = false;
+        passes++;
+        for (uint32_t i = 0; i < count; i++) {
+            if (joined[i]) continue;
+            for (uint32_t j = i + 1; j < count; j++) {
+                if (joined[j]) continue;
+
+                lv_area_t bbox;
+                bbox.x1 = LV_MIN(areas[i].x1, areas[j].x1);
+                bbox.y1 = LV_MIN(areas[i].y1, areas[j].y1);
+                bbox.x2 = LV_MAX(areas[i].x2, areas[j].x2);
+                bbox.y2 = LV_MAX(areas[i].y2, areas[j].y2);
+
+                uint64_t separate = 2 * overhead + px_cost * (lv_area_get_size(&areas[i]) + lv_area_get_size(&areas[j]));
+                uint64_t together = overhead + px_cost * lv_area_get_size(&bbox);
+                if (together < separate) {
+                    // Keep the higher index, LVGL flags its last area before this runs
+                    areas[j] = bbox;
+                    joined[i] = 1;
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    } while (merged && passes < AREA_COALESCE_MAX_PASSES);
+    return passes;
+}
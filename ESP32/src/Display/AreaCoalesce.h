@@ -0,0 +1,39 @@
+#ifndef AREA_COALESCE_H
+#define AREA_COALESCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 刷新前合并脏区域。LVGL 自己只在合并后的外接矩形不比两块之和大时才合并，
+// 粒子分散时会留下很多小区域，每块都要单独渲染、单独 flush。
+// 这里按代价模型合并：每块固定开销 + 每像素渲染和拷贝的开销，合并后更便宜就合并。
+typedef struct {
+    uint32_t area_overhead_ns;  // 每块区域的固定开销 (渲染准备、flush 调用、逐行拷贝的循环开销)
+    uint32_t px_cost_ns;        // 每像素的渲染 + 拷贝开销
+} area_cost_model_t;
+
+// 默认值，串口命令 "coalesce calibrate" 可在设备上重新测量
+#define AREA_COALESCE_DEFAULT_OVERHEAD_NS 60000
+#define AREA_COALESCE_DEFAULT_PX_COST_NS 30
+// 合并后变大的区域可能又值得和别的区域合并，所以要多扫几遍；每遍 O(n^2)，
+// 扫到没有合并为止最坏是 O(n^3)。限制遍数，第二遍已经能接上绝大多数连锁合并。
+#define AREA_COALESCE_MAX_PASSES 2
+
+// 合并阶段的接口：areas/joined 与 LVGL 的 inv_areas/inv_area_joined 相同，
+// 被合并掉的区域把 joined 置 1。合并结果必须写进两块中下标较大的那块，
+// 因为 LVGL 在调用前已经按下标确定了最后一块。返回扫描区域列表的遍数，计入 PERF_COUNTER_COALESCE_PASSES。
+typedef uint32_t (*area_coalesce_cb_t)(lv_area_t * areas, uint8_t * joined, uint32_t count);
+
+// 按 AreaCoalesce_SetModel() 设置的代价模型合并，最多 AREA_COALESCE_MAX_PASSES 遍
+uint32_t AreaCoalesce_CostModel(lv_area_t * areas, uint8_t * joined, uint32_t count);
+void AreaCoalesce_SetModel(const area_cost_model_t * model);
+const area_cost_model_t * AreaCoalesce_GetModel(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // AREA_COALESCE_H
@@ -0,0 +1,250 @@
+#include <Arduino.h>
+#include <Arduino_GFX_Library.h>
+#include "DisplaySleep.h"
+#include "lvgldriver.h"
+#include "../Core/PerfMonitor.h"
+
+#define ST7701_DISPOFF 0x28
+#define ST7701_DISPON 0x29
+
+#define SAMPLE_PERIOD_MS 1000 // PerfMonitor's loop utilization window
+
+extern "C" {
+
+typedef struct {
+    uint32_t ms;
+    uint32_t util_sum;     // Loop utilization samples, per mille
+    uint32_t util_samples;
+    uint64_t copied_bytes; // Written to the PSRAM framebuffer by the flush callbacks
+    uint64_t flushed_px;
+} sleep_state_stats_t;
+
+static const char * state_names[DISPLAY_SLEEP_STATE_MAX] = { "awake", "dimmed", "blanked" };
+
+static Arduino_DataBus * panel_bus = NULL;
+static int bl_pin = -1;
+static int btn_pin = -1;
+static display_sleep_cb_t sleep_cb = NULL;
+
+static display_sleep_state_t state = DISPLAY_SLEEP_AWAKE;
+static uint32_t dim_ms = DISPLAY_SLEEP_DIM_TIMEOUT_S * 1000UL;
+static uint32_t blank_ms = DISPLAY_SLEEP_BLANK_TIMEOUT_S * 1000UL;
+static uint32_t last_activity = 0;
+static uint32_t dim_start = 0;
+static uint8_t brightness = 0;
+
+static sleep_state_stats_t stats[DISPLAY_SLEEP_STATE_MAX];
+static uint32_t account_ms = 0;
+static uint32_t account_copied = 0;
+static uint32_t account_flushed = 0;
+static uint32_t last_sample = 0;
+
+// Wake latency: from the wake request to the first flush of the redraw
+static uint32_t wake_us = 0;
+static uint32_t wake_flushes = 0;
+static bool wake_pending = false;
+static uint32_t last_wake_latency_us = 0;
+static uint32_t wake_count = 0;
+
+static void set_brightness(uint8_t level)
+{
+    if (bl_pin < 0 || level == brightness) return;
+    brightness = level;
+    analogWrite(bl_pin, level);
+}
+
+static void panel_command(uint8_t cmd)
+{
+    if (!panel_bus) return;
+    panel_bus->beginWrite();
+    panel_bus->writeCommand(cmd);
+    panel_bus->endWrite();
+}
+
+// PerfMonitor counters are cleared by 'perf reset', treat a drop as a restart from 0
+static uint32_t counter_delta(perf_counter_t counter, uint32_t * last)
+{
+    uint32_t now = PerfMonitor_GetCounter(counter);
+    uint32_t delta = now >= *last ? now - *last : now;
+    *last = now;
+    return delta;
+}
+
+// Charge everything since the last call to the current state
+static void account(void)
+{
+    uint32_t now = millis();
+    sleep_state_stats_t * s = &stats[state];
+    s->ms += now - account_ms;
+    s->copied_bytes += counter_delta(PERF_COUNTER_COPIED_BYTES, &account_copied);
+    s->flushed_px += counter_delta(PERF_COUNTER_FLUSHED_PX, &account_flushed);
+    account_ms = now;
+}
+
+static void enter_state(display_sleep_state_t next)
+{
+    account();
+    state = next;
+}
+
+void DisplaySleep_Init(void * bus, int backlight_pin, int button_pin)
+{
+    panel_bus = (Arduino_DataBus *)bus;
+    bl_pin = backlight_pin;
+    btn_pin = button_pin;
+    if (bl_pin >= 0)
+    {
+        pinMode(bl_pin, OUTPUT);
+        brightness = 0;
+        set_brightness(DISPLAY_SLEEP_FULL_BRIGHTNESS);
+    }
+
+    state = DISPLAY_SLEEP_AWAKE;
+    last_activity = account_ms = last_sample = millis();
+    account_copied = PerfMonitor_GetCounter(PERF_COUNTER_COPIED_BYTES);
+    account_flushed = PerfMonitor_GetCounter(PERF_COUNTER_FLUSHED_PX);
+}
+
+void DisplaySleep_SetCallback(display_sleep_cb_t cb)
+{
+    sleep_cb = cb;
+}
+
+void DisplaySleep_SetTimeouts(uint32_t dim_s, uint32_t blank_s)
+{
+    dim_ms = dim_s * 1000UL;
+    blank_ms = blank_s * 1000UL;
+    DisplaySleep_Wake();
+}
+
+bool DisplaySleep_Wake(void)
+{
+    last_activity = millis();
+    if (state == DISPLAY_SLEEP_AWAKE) return false;
+
+    bool was_blanked = state == DISPLAY_SLEEP_BLANKED;
+    enter_state(DISPLAY_SLEEP_AWAKE);
+    if (was_blanked)
+    {
+        // Rendering first: the panel still holds the last frame, so the backlight
+        // can come on right away while the full redraw catches up
+        wake_us = micros();
+        wake_flushes = PerfMonitor_GetCounter(PERF_COUNTER_FLUSHES);
+        wake_pending = true;
+        wake_count++;
+        lv_screen_set_suspended(false);
+        if (sleep_cb) sleep_cb(false);
+        panel_command(ST7701_DISPON);
+    }
+    set_brightness(DISPLAY_SLEEP_FULL_BRIGHTNESS);
+    return was_blanked;
+}
+
+void DisplaySleep_OnEvent(int32_t intensity)
+{
+    if (intensity >= DISPLAY_SLEEP_WAKE_INTENSITY) DisplaySleep_Wake();
+}
+
+void DisplaySleep_Blank(void)
+{
+    if (state == DISPLAY_SLEEP_BLANKED) return;
+
+    enter_state(DISPLAY_SLEEP_BLANKED);
+    wake_pending = false;
+    // Stops rendering and waits for the flush worker before the panel goes off
+    lv_screen_set_suspended(true);
+    if (sleep_cb) sleep_cb(true);
+    set_brightness(0);
+    panel_command(ST7701_DISPOFF);
+}
+
+display_sleep_state_t DisplaySleep_GetState(void)
+{
+    return state;
+}
+
+void DisplaySleep_Update(void)
+{
+    uint32_t now = millis();
+
+    if (btn_pin >= 0 && digitalRead(btn_pin) == LOW) DisplaySleep_Wake();
+
+    if (wake_pending && PerfMonitor_GetCounter(PERF_COUNTER_FLUSHES) != wake_flushes)
+    {
+        last_wake_latency_us = micros() - wake_us;
+        wake_pending = false;
+    }
+
+    uint32_t idle = now - last_activity;
+    if (blank_ms && idle >= blank_ms)
+    {
+        DisplaySleep_Blank();
+    }
+    else if (dim_ms && idle >= dim_ms && state == DISPLAY_SLEEP_AWAKE)
+    {
+        enter_state(DISPLAY_SLEEP_DIMMED);
+        dim_start = now;
+    }
+
+    if (state == DISPLAY_SLEEP_DIMMED)
+    {
+        uint32_t t = LV_MIN(now - dim_start, DISPLAY_SLEEP_FADE_MS);
+        set_brightness(DISPLAY_SLEEP_FULL_BRIGHTNESS -
+                       (DISPLAY_SLEEP_FULL_BRIGHTNESS - DISPLAY_SLEEP_DIM_BRIGHTNESS) * t / DISPLAY_SLEEP_FADE_MS);
+    }
+
+    if (now - last_sample >= SAMPLE_PERIOD_MS)
+    {
+        last_sample = now;
+        stats[state].util_sum += PerfMonitor_GetLoopUtilization();
+        stats[state].util_samples++;
+    }
+}
+
+static uint32_t avg_util(const sleep_state_stats_t * s)
+{
+    return s->util_samples ? s->util_sum / s->util_samples : 0;
+}
+
+static float copy_rate(const sleep_state_stats_t * s)
+{
+    return s->ms ? s->copied_bytes / (s->ms * 1000.0f) : 0.0f; // MB/s
+}
+
+static float flush_rate(const sleep_state_stats_t * s)
+{
+    return s->ms ? s->flushed_px / (s->ms * 1000.0f) : 0.0f;   // Mpx/s
+}
+
+void DisplaySleep_PrintReport(void)
+{
+    account();
+
+    Serial.printf("Sleep: %s, dim after %u s, blank after %u s, brightness %u\n",
+                  state_names[state], dim_ms / 1000, blank_ms / 1000, brightness);
+    if (wake_count)
+    {
+        Serial.printf("  %u wakes, last one %u.%u ms to first flush\n", wake_count,
+                      last_wake_latency_us / 1000, last_wake_latency_us / 100 % 10);
+    }
+    for (int i = 0; i < DISPLAY_SLEEP_STATE_MAX; i++)
+    {
+        const sleep_state_stats_t * s = &stats[i];
+        uint32_t util = avg_util(s);
+        Serial.printf("  %-8s %6u s, loop %u.%u%%, fb writes %.2f MB/s, flushed %.3f Mpx/s\n",
+                      state_names[i], s->ms / 1000, util / 10, util % 10, copy_rate(s), flush_rate(s));
+    }
+
+    const sleep_state_stats_t * awake = &stats[DISPLAY_SLEEP_AWAKE];
+    const sleep_state_stats_t * blanked = &stats[DISPLAY_SLEEP_BLANKED];
+    if (awake->util_samples && blanked->util_samples)
+    {
+        int32_t util = (int32_t)avg_util(awake) - (int32_t)avg_util(blanked);
+        // Sign printed on its own: -5 per mille would otherwise come out as "0.5"
+        uint32_t util_abs = util < 0 ? -util : util;
+        Serial.printf("  reclaimed while blanked: loop %s%u.%u%%, fb writes %.2f MB/s (panel scan-out not stopped)\n",
+                      util < 0 ? "-" : "", util_abs / 10, util_abs % 10, copy_rate(awake) - copy_rate(blanked));
+    }
+}
+
+} // extern "C"
@@ -0,0 +1,55 @@
+#ifndef DISPLAY_SLEEP_H
+#define DISPLAY_SLEEP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 无人操作时的显示休眠：先把背光 (PWM) 渐暗，再熄灭。
+// 熄灭后 LVGL 停止渲染和刷新、风铃动画定时器暂停、面板发 DISPOFF。
+// RGB 外设的帧缓冲扫描 (PSRAM 读) 无法通过 Arduino_GFX 停止，熄灭期间照常进行。
+// 触摸、按键或高强度事件唤醒，唤醒后整屏重绘一次。
+typedef enum {
+    DISPLAY_SLEEP_AWAKE = 0,
+    DISPLAY_SLEEP_DIMMED,
+    DISPLAY_SLEEP_BLANKED,
+    DISPLAY_SLEEP_STATE_MAX
+} display_sleep_state_t;
+
+#define DISPLAY_SLEEP_DIM_TIMEOUT_S 60     // 无操作多久后调暗，0 不调暗
+#define DISPLAY_SLEEP_BLANK_TIMEOUT_S 180  // 无操作多久后熄灭，0 不熄灭
+#define DISPLAY_SLEEP_FULL_BRIGHTNESS 255
+#define DISPLAY_SLEEP_DIM_BRIGHTNESS 40
+#define DISPLAY_SLEEP_FADE_MS 500          // 调暗的渐变时间，唤醒总是立即全亮
+#define DISPLAY_SLEEP_WAKE_INTENSITY 80    // 不低于此强度的事件会唤醒屏幕
+
+// 熄灭/唤醒时回调 (LVGL 渲染已由本模块暂停/恢复)，应用层在这里暂停自己的定时器
+typedef void (*display_sleep_cb_t)(bool blanked);
+
+// bus: 面板命令总线 (Arduino_DataBus*)，可为 NULL；引脚为 -1 表示没有
+void DisplaySleep_Init(void * bus, int backlight_pin, int button_pin);
+void DisplaySleep_SetCallback(display_sleep_cb_t cb);
+void DisplaySleep_SetTimeouts(uint32_t dim_s, uint32_t blank_s);
+
+// 用户操作：重置空闲计时并立即恢复全亮。返回 true 表示屏幕之前是熄灭的，
+// 这次操作只用来唤醒 (触摸不应再传给界面)
+bool DisplaySleep_Wake(void);
+// 事件到达，强度够高就唤醒
+void DisplaySleep_OnEvent(int32_t intensity);
+void DisplaySleep_Blank(void);
+display_sleep_state_t DisplaySleep_GetState(void);
+
+// loop() 中调用：按键轮询、超时、渐变和统计
+void DisplaySleep_Update(void);
+
+// 各状态下的主循环利用率和帧缓冲写入带宽，以及熄灭节省了多少
+void DisplaySleep_PrintReport(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // DISPLAY_SLEEP_H
@@ -0,0 +1,208 @@
+#include <Arduino.h>
+#include "FlushHeatmap.h"
+
+extern "C" {
+
+typedef struct {
+    lv_obj_t * screen;
+    const char * name;
+    uint64_t pixels;
+    uint32_t active_ms;
+} heatmap_screen_t;
+
+static bool flush_heatmap_enabled = false;
+static bool heatmap_overlay = false;
+
+static uint32_t tile_count[FLUSH_HEATMAP_ROWS][FLUSH_HEATMAP_COLS];
+static uint32_t tile_max = 0;
+static uint8_t tile_alpha[FLUSH_HEATMAP_ROWS][FLUSH_HEATMAP_COLS]; // Overlay opacity, kept in step with tile_count
+
+static heatmap_screen_t screens[FLUSH_HEATMAP_MAX_SCREENS];
+static heatmap_screen_t * last_screen = NULL;
+static uint32_t last_tick = 0;
+
+static heatmap_screen_t * find_screen(lv_obj_t * screen)
+{
+    heatmap_screen_t * free_slot = NULL;
+    for (int i = 0; i < FLUSH_HEATMAP_MAX_SCREENS; i++)
+    {
+        if (screens[i].screen == screen) return &screens[i];
+        if (!screens[i].screen && !free_slot) free_slot = &screens[i];
+    }
+    if (free_slot) free_slot->screen = screen;
+    return free_slot;
+}
+
+// Charge the time since the last call to the screen that was active during it
+static void account_time(lv_obj_t * screen)
+{
+    uint32_t now = lv_tick_get();
+    if (last_screen) last_screen->active_ms += now - last_tick;
+    last_tick = now;
+    last_screen = find_screen(screen);
+}
+
+// 0 for an untouched tile, up to FLUSH_HEATMAP_MAX_ALPHA for the hottest one, log scale
+static uint8_t alpha_for(uint32_t count)
+{
+    if (!count || !tile_max) return 0;
+    uint32_t bits = 32 - __builtin_clz(count);
+    uint32_t max_bits = 32 - __builtin_clz(tile_max);
+    return 16 + (FLUSH_HEATMAP_MAX_ALPHA - 16) * bits / max_bits;
+}
+
+static void update_alpha(void)
+{
+    for (int ty = 0; ty < FLUSH_HEATMAP_ROWS; ty++)
+    {
+        for (int tx = 0; tx < FLUSH_HEATMAP_COLS; tx++)
+        {
+            tile_alpha[ty][tx] = alpha_for(tile_count[ty][tx]);
+        }
+    }
+}
+
+void FlushHeatmap_SetEnabled(bool enabled)
+{
+    if (enabled && !flush_heatmap_enabled)
+    {
+        last_screen = NULL;
+        account_time(lv_screen_active());
+    }
+    flush_heatmap_enabled = enabled;
+}
+
+void FlushHeatmap_SetOverlay(bool overlay)
+{
+    heatmap_overlay = overlay;
+    if (overlay) FlushHeatmap_SetEnabled(true);
+}
+
+bool FlushHeatmap_GetOverlay(void)
+{
+    return heatmap_overlay;
+}
+
+void FlushHeatmap_NameScreen(lv_obj_t * screen, const char * name)
+{
+    heatmap_screen_t * entry = find_screen(screen);
+    if (entry) entry->name = name;
+}
+
+void FlushHeatmap_Reset(void)
+{
+    memset(tile_count, 0, sizeof(tile_count));
+    memset(tile_alpha, 0, sizeof(tile_alpha));
+    tile_max = 0;
+    for (int i = 0; i < FLUSH_HEATMAP_MAX_SCREENS; i++)
+    {
+        screens[i].pixels = 0;
+        screens[i].active_ms = 0;
+    }
+    last_screen = NULL;
+    account_time(lv_screen_active());
+}
+
+void FlushHeatmap_Record(lv_display_t * disp, const lv_area_t * area)
+{
+    if (!flush_heatmap_enabled) return;
+
+    lv_obj_t * screen = lv_display_get_screen_active(disp);
+    if (!last_screen || last_screen->screen != screen) account_time(screen);
+    if (last_screen) last_screen->pixels += lv_area_get_size(area);
+
+    int32_t tx1 = LV_MAX(area->x1, 0) / FLUSH_HEATMAP_TILE;
+    int32_t ty1 = LV_MAX(area->y1, 0) / FLUSH_HEATMAP_TILE;
+    int32_t tx2 = LV_MIN(area->x2 / FLUSH_HEATMAP_TILE, FLUSH_HEATMAP_COLS - 1);
+    int32_t ty2 = LV_MIN(area->y2 / FLUSH_HEATMAP_TILE, FLUSH_HEATMAP_ROWS - 1);
+    bool new_max = false;
+    for (int32_t ty = ty1; ty <= ty2; ty++)
+    {
+        for (int32_t tx = tx1; tx <= tx2; tx++)
+        {
+            uint32_t count = ++tile_count[ty][tx];
+            if (count > tile_max)
+            {
+                // The scale only changes when the maximum crosses a power of two
+                if ((count & (count - 1)) == 0) new_max = true;
+                tile_max = count;
+            }
+        }
+    }
+    if (!heatmap_overlay) return;
+    if (new_max)
+    {
+        update_alpha();
+    }
+    else
+    {
+        for (int32_t ty = ty1; ty <= ty2; ty++)
+        {
+            for (int32_t tx = tx1; tx <= tx2; tx++)
+            {
+                tile_alpha[ty][tx] = alpha_for(tile_count[ty][tx]);
+            }
+        }
+    }
+}
+
+void FlushHeatmap_Tint(uint16_t * fb, int32_t stride, const lv_area_t * area)
+{
+    if (!heatmap_overlay) return;
+
+    for (int32_t y = area->y1; y <= area->y2; y++)
+    {
+        const uint8_t * alpha_row = tile_alpha[LV_MIN(y / FLUSH_HEATMAP_TILE, FLUSH_HEATMAP_ROWS - 1)];
+        uint16_t * px = fb + y * stride;
+        for (int32_t x = area->x1; x <= area->x2; x++)
+        {
+            uint32_t a = alpha_row[LV_MIN(x / FLUSH_HEATMAP_TILE, FLUSH_HEATMAP_COLS - 1)];
+            if (!a) continue;
+            uint32_t c = px[x];
+            uint32_t r = (((c >> 11) & 0x1F) * (256 - a) + 0x1F * a) >> 8;
+            uint32_t g = (((c >> 5) & 0x3F) * (256 - a)) >> 8;
+            uint32_t b = ((c & 0x1F) * (256 - a)) >> 8;
+            px[x] = (r << 11) | (g << 5) | b;
+        }
+    }
+}
+
+void FlushHeatmap_PrintReport(void)
+{
+    static const char shades[] = " .:-=+*#%@";
+
+    if (!flush_heatmap_enabled)
+    {
+        Serial.println("Heatmap: off ('heatmap on' to start)");
+        return;
+    }
+    account_time(last_screen ? last_screen->screen : lv_screen_active());
+
+    Serial.printf("Heatmap: %dx%d px tiles, hottest tile redrawn %u times, overlay %s\n",
+                  FLUSH_HEATMAP_TILE, FLUSH_HEATMAP_TILE, tile_max, heatmap_overlay ? "on" : "off");
+    uint32_t max_bits = tile_max ? 32 - __builtin_clz(tile_max) : 1;
+    char line[FLUSH_HEATMAP_COLS + 3];
+    for (int ty = 0; ty < FLUSH_HEATMAP_ROWS; ty++)
+    {
+        line[0] = '|';
+        for (int tx = 0; tx < FLUSH_HEATMAP_COLS; tx++)
+        {
+            uint32_t count = tile_count[ty][tx];
+            uint32_t bits = count ? 32 - __builtin_clz(count) : 0;
+            line[tx + 1] = shades[bits * (sizeof(shades) - 2) / max_bits];
+        }
+        line[FLUSH_HEATMAP_COLS + 1] = '|';
+        line[FLUSH_HEATMAP_COLS + 2] = '\0';
+        Serial.println(line);
+    }
+
+    for (int i = 0; i < FLUSH_HEATMAP_MAX_SCREENS; i++)
+    {
+        heatmap_screen_t * s = &screens[i];
+        if (!s->screen || !s->active_ms) continue;
+        Serial.printf("  %-14s %8llu px in %6u ms, %8llu px/s\n", s->name ? s->name : "other",
+                      s->pixels, s->active_ms, s->pixels * 1000 / s->active_ms);
+    }
+}
+
+} /*extern "C"*/
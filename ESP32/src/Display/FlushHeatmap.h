@@ -0,0 +1,35 @@
+#ifndef FLUSH_HEATMAP_H
+#define FLUSH_HEATMAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 刷新区域热力图：记录每个送到 flush 回调的区域，按 16x16 块累计重绘次数，
+// 并按界面统计每秒刷新的像素数。打开叠加层时，刚刷新的像素按所在块的次数
+// 染上半透明的红色，越常重绘越红 (只在旋转 0 且面板帧缓冲不是 LVGL 绘制缓冲时)。
+#define FLUSH_HEATMAP_TILE 16
+#define FLUSH_HEATMAP_COLS (480 / FLUSH_HEATMAP_TILE)
+#define FLUSH_HEATMAP_ROWS (480 / FLUSH_HEATMAP_TILE)
+#define FLUSH_HEATMAP_MAX_SCREENS 8
+#define FLUSH_HEATMAP_MAX_ALPHA 128 // 叠加层最红时的不透明度 (0-255)
+
+void FlushHeatmap_SetEnabled(bool enabled);
+void FlushHeatmap_SetOverlay(bool overlay);
+bool FlushHeatmap_GetOverlay(void);
+void FlushHeatmap_NameScreen(lv_obj_t * screen, const char * name);
+void FlushHeatmap_Reset(void);
+void FlushHeatmap_PrintReport(void);
+
+// 由显示驱动在 flush 回调中调用
+void FlushHeatmap_Record(lv_display_t * disp, const lv_area_t * area);
+// 把叠加层画到面板帧缓冲 fb 中 area 对应的像素上，stride 以像素计
+void FlushHeatmap_Tint(uint16_t * fb, int32_t stride, const lv_area_t * area);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // FLUSH_HEATMAP_H
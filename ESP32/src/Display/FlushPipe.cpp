@@ -0,0 +1,272 @@
+#include "FlushPipe.h"
+
+#if defined(ESP32)
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#define FLUSH_PIPE_TASK_CORE 0        // loop() runs on core 1
+#define FLUSH_PIPE_TASK_PRIORITY 5
+#define FLUSH_PIPE_TASK_STACK 4096
+
+static flush_pipe_sink_t pipe_sink = NULL;
+static uint32_t pipe_px_size = 0;
+static bool pipe_started = false;
+
+// Worker statistics, reset by FlushPipe_ResetStats()
+static volatile uint32_t pipe_jobs = 0;
+static volatile uint32_t pipe_frames = 0;
+static volatile uint32_t pipe_bytes = 0;
+static volatile uint32_t pipe_busy_us = 0;
+static uint32_t pipe_stall_us = 0;
+static uint32_t pipe_window_start = 0;
+
+static uint32_t pipe_now_us(void);
+
+// One job on the worker, with its statistics
+static void pipe_run(const flush_job_t * job)
+{
+    uint32_t start = pipe_now_us();
+    pipe_sink(job);
+    if (job->last)
+    {
+        pipe_frames++;
+    }
+    pipe_busy_us += pipe_now_us() - start;
+    pipe_bytes += lv_area_get_size(&job->area) * pipe_px_size;
+    pipe_jobs++;
+}
+
+#if defined(ESP32)
+
+static QueueHandle_t flush_queue = NULL;
+// Taken when an area is queued, given back by the worker once it is done:
+// whoever holds it owns the framebuffer
+static SemaphoreHandle_t flush_idle = NULL;
+static TaskHandle_t flush_task = NULL;
+
+static uint32_t pipe_now_us(void)
+{
+    return micros();
+}
+
+static void flush_worker(void * arg)
+{
+    flush_job_t job;
+    for (;;)
+    {
+        if (xQueueReceive(flush_queue, &job, portMAX_DELAY) != pdTRUE) continue;
+        pipe_run(&job);
+        xSemaphoreGive(flush_idle);
+    }
+}
+
+static void pipe_delete(void)
+{
+    if (flush_task) vTaskDelete(flush_task);
+    if (flush_queue) vQueueDelete(flush_queue);
+    if (flush_idle) vSemaphoreDelete(flush_idle);
+    flush_task = NULL;
+    flush_queue = NULL;
+    flush_idle = NULL;
+}
+
+static bool pipe_create(void)
+{
+    flush_idle = xSemaphoreCreateBinary();
+    flush_queue = xQueueCreate(1, sizeof(flush_job_t));
+    if (!flush_idle || !flush_queue ||
+        xTaskCreatePinnedToCore(flush_worker, "lv_flush", FLUSH_PIPE_TASK_STACK, NULL,
+                                FLUSH_PIPE_TASK_PRIORITY, &flush_task, FLUSH_PIPE_TASK_CORE) != pdPASS)
+    {
+        flush_task = NULL;
+        pipe_delete();
+        return false;
+    }
+    xSemaphoreGive(flush_idle); // Binary semaphores start out taken
+    return true;
+}
+
+static void pipe_take_idle(void)
+{
+    xSemaphoreTake(flush_idle, portMAX_DELAY);
+}
+
+static void pipe_give_idle(void)
+{
+    xSemaphoreGive(flush_idle);
+}
+
+static void pipe_queue(const flush_job_t * job)
+{
+    xQueueSend(flush_queue, job, portMAX_DELAY);
+}
+
+#else
+
+// Host: the same one-slot handoff with a thread, a mutex and a condition variable
+static std::thread flush_thread;
+static std::mutex pipe_mutex;
+static std::condition_variable pipe_cv;
+static bool idle_taken = false;
+static bool job_ready = false;
+static bool stopping = false;
+static flush_job_t pending_job;
+
+static uint32_t pipe_now_us(void)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void flush_worker(void)
+{
+    for (;;)
+    {
+        flush_job_t job;
+        {
+            std::unique_lock<std::mutex> lock(pipe_mutex);
+            pipe_cv.wait(lock, [] { return job_ready || stopping; });
+            if (!job_ready) return;
+            job = pending_job;
+            job_ready = false;
+        }
+        pipe_run(&job);
+        std::lock_guard<std::mutex> lock(pipe_mutex);
+        idle_taken = false;
+        pipe_cv.notify_all();
+    }
+}
+
+static void pipe_delete(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(pipe_mutex);
+        stopping = true;
+        pipe_cv.notify_all();
+    }
+    flush_thread.join();
+    stopping = false;
+    idle_taken = false;
+}
+
+static bool pipe_create(void)
+{
+    flush_thread = std::thread(flush_worker);
+    return true;
+}
+
+static void pipe_take_idle(void)
+{
+    std::unique_lock<std::mutex> lock(pipe_mutex);
+    pipe_cv.wait(lock, [] { return !idle_taken; });
+    idle_taken = true;
+}
+
+static void pipe_give_idle(void)
+{
+    std::lock_guard<std::mutex> lock(pipe_mutex);
+    idle_taken = false;
+    pipe_cv.notify_all();
+}
+
+static void pipe_queue(const flush_job_t * job)
+{
+    std::lock_guard<std::mutex> lock(pipe_mutex);
+    pending_job = *job;
+    job_ready = true;
+    pipe_cv.notify_all();
+}
+
+#endif
+
+extern "C" {
+
+bool FlushPipe_Start(flush_pipe_sink_t sink, uint32_t px_size)
+{
+    if (pipe_started)
+    {
+        // The worker may still be in the old sink
+        FlushPipe_Drain();
+        pipe_sink = sink;
+        pipe_px_size = px_size;
+        return true;
+    }
+
+    pipe_sink = sink;
+    pipe_px_size = px_size;
+    if (!pipe_create()) return false;
+    pipe_started = true;
+    FlushPipe_ResetStats();
+    return true;
+}
+
+void FlushPipe_Stop(void)
+{
+    if (!pipe_started) return;
+    FlushPipe_Drain();
+    pipe_delete();
+    pipe_started = false;
+}
+
+bool FlushPipe_IsStarted(void)
+{
+    return pipe_started;
+}
+
+void FlushPipe_Acquire(void)
+{
+    pipe_take_idle();
+}
+
+void FlushPipe_Submit(const flush_job_t * job)
+{
+    pipe_queue(job);
+}
+
+void FlushPipe_Drain(void)
+{
+    if (!pipe_started) return;
+    pipe_take_idle();
+    pipe_give_idle();
+}
+
+void FlushPipe_Wait(void)
+{
+    uint32_t start = pipe_now_us();
+    FlushPipe_Drain();
+    pipe_stall_us += pipe_now_us() - start;
+}
+
+void FlushPipe_GetStats(flush_pipe_stats_t * stats)
+{
+    stats->jobs = pipe_jobs;
+    stats->frames = pipe_frames;
+    stats->bytes = pipe_bytes;
+    stats->busy_us = pipe_busy_us;
+    stats->stall_us = pipe_stall_us;
+    stats->window_us = pipe_now_us() - pipe_window_start;
+}
+
+void FlushPipe_ResetStats(void)
+{
+    pipe_jobs = pipe_frames = pipe_bytes = pipe_busy_us = 0;
+    pipe_stall_us = 0;
+    pipe_window_start = pipe_now_us();
+}
+
+uint32_t FlushPipe_OverlapPermille(const flush_pipe_stats_t * stats)
+{
+    if (!stats->busy_us) return 0;
+    return 1000 - LV_MIN(stats->stall_us, stats->busy_us) * 1000ULL / stats->busy_us;
+}
+
+} // extern "C"
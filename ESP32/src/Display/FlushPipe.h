@@ -0,0 +1,57 @@
+#ifndef FLUSH_PIPE_H
+#define FLUSH_PIPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 异步刷新的交接：渲染方提交一个区域后立刻返回去渲染下一块，工作线程在另一个核上
+// 调用 sink 把它送到面板。只有一个槽位：提交前先 FlushPipe_Acquire() 等上一块送完，
+// 谁持有它谁就拥有帧缓冲。设备上是 FreeRTOS 任务 + 队列/信号量，主机上是一个线程，
+// 所以交接和统计可以在主机测试里用一个慢速 sink 量出来。
+typedef struct {
+    lv_area_t area;
+    uint8_t * px_map;
+    lv_display_rotation_t rotation;
+    bool last;                      // Last area of the frame
+} flush_job_t;
+
+// Runs on the worker, one job at a time, in submission order
+typedef void (*flush_pipe_sink_t)(const flush_job_t * job);
+
+// Since FlushPipe_Start() or the last FlushPipe_ResetStats()
+typedef struct {
+    uint32_t jobs;
+    uint32_t frames;
+    uint32_t bytes;      // Area pixels times px_size
+    uint32_t busy_us;    // Worker time in the sink
+    uint32_t stall_us;   // Renderer time blocked in FlushPipe_Wait()
+    uint32_t window_us;
+} flush_pipe_stats_t;
+
+// Starts the worker on first use; later calls only swap the sink (after draining)
+bool FlushPipe_Start(flush_pipe_sink_t sink, uint32_t px_size);
+// Drains and stops the worker, for tests; the device keeps it running
+void FlushPipe_Stop(void);
+bool FlushPipe_IsStarted(void);
+
+// Waits until the worker is idle and takes the slot; FlushPipe_Submit() hands it over
+void FlushPipe_Acquire(void);
+void FlushPipe_Submit(const flush_job_t * job);
+// Blocks until the worker is idle, no-op if it was never started
+void FlushPipe_Drain(void);
+// FlushPipe_Drain() for the renderer: the wait is counted as stall
+void FlushPipe_Wait(void);
+
+void FlushPipe_GetStats(flush_pipe_stats_t * stats);
+void FlushPipe_ResetStats(void);
+// Share of the sink's time the renderer did not spend waiting for it, per mille
+uint32_t FlushPipe_OverlapPermille(const flush_pipe_stats_t * stats);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // FLUSH_PIPE_H
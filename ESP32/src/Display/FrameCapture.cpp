@@ -0,0 +1,366 @@
+#include <Arduino.h>
+#include <string.h>
+#include "FrameCapture.h"
+#include "../Core/MQTTManager.h"
+
+extern "C" {
+
+#define CHUNK_HEADER_SIZE 5
+#define TILE_RECORD_HEADER_SIZE 5
+#define TILE_RAW_SIZE (FRAME_CAPTURE_TILE * FRAME_CAPTURE_TILE * 2)
+#define SERIAL_LINE_PREFIX "CAP "
+
+static const uint16_t * cap_fb = NULL;
+static uint16_t cap_width = 0;
+static uint16_t cap_height = 0;
+static uint16_t cap_tiles_x = 0;
+static uint16_t cap_tiles_y = 0;
+static frame_capture_sink_t cap_sink = FRAME_CAPTURE_SINK_SERIAL;
+static bool cap_running = false;
+static bool cap_keyframe = false;
+static bool cap_have_reference = false; // tile_hash matches what the receiver has
+static uint16_t cap_frame_id = 0;
+static uint16_t cap_seq = 0;
+static uint16_t cap_cursor = 0;
+static bool cap_end_queued = false;     // END 包已放进 chunk_buf
+
+// chunk_buf 里是一个完整的包，等发送端有空间；这期间不再往里加块
+static bool chunk_ready = false;
+static uint16_t tile_len = 0;           // tile_buf 里已编码、还没放进包的块
+static bool sink_waiting = false;       // 串口缓冲放不下一整行
+static uint32_t sink_wait_start = 0;
+static bool step_published = false;     // MQTT: 这一步已经发过一包
+
+static uint32_t tile_hash[FRAME_CAPTURE_MAX_TILES];
+
+static uint8_t chunk_buf[CHUNK_HEADER_SIZE + FRAME_CAPTURE_CHUNK_PAYLOAD];
+static uint16_t chunk_len = 0;
+static uint8_t tile_buf[TILE_RECORD_HEADER_SIZE + TILE_RAW_SIZE + 3]; // RLE may overshoot raw by one run before giving up
+static char line_buf[FRAME_CAPTURE_MAX_LINE];
+
+static frame_capture_stats_t cur_stats;
+static frame_capture_stats_t last_stats;
+
+static void put_u16(uint8_t * p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t * p, uint32_t v)
+{
+    put_u16(p, v & 0xFFFF);
+    put_u16(p + 2, v >> 16);
+}
+
+static const char base64_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// "CAP <base64>\r\n" into line_buf, returns the length
+static uint16_t serial_line(const uint8_t * data, size_t len)
+{
+    char * out = line_buf;
+    memcpy(out, SERIAL_LINE_PREFIX, sizeof(SERIAL_LINE_PREFIX) - 1);
+    out += sizeof(SERIAL_LINE_PREFIX) - 1;
+    size_t i;
+    for (i = 0; i + 2 < len; i += 3)
+    {
+        uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        *out++ = base64_table[(v >> 18) & 0x3F];
+        *out++ = base64_table[(v >> 12) & 0x3F];
+        *out++ = base64_table[(v >> 6) & 0x3F];
+        *out++ = base64_table[v & 0x3F];
+    }
+    if (i < len)
+    {
+        uint32_t v = data[i] << 16;
+        if (i + 1 < len) v |= data[i + 1] << 8;
+        *out++ = base64_table[(v >> 18) & 0x3F];
+        *out++ = base64_table[(v >> 12) & 0x3F];
+        *out++ = (i + 1 < len) ? base64_table[(v >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+    *out++ = '\r';
+    *out++ = '\n';
+    return out - line_buf;
+}
+
+static void chunk_begin(uint8_t type)
+{
+    chunk_buf[0] = type;
+    put_u16(chunk_buf + 1, cap_frame_id);
+    put_u16(chunk_buf + 3, cap_seq++);
+    chunk_len = CHUNK_HEADER_SIZE;
+}
+
+typedef enum {
+    SEND_DONE,
+    SEND_WAIT,      // 发送端没空间，留到下一步
+    SEND_FAILED     // MQTT 断开
+} send_result_t;
+
+// 不阻塞地发送 chunk_buf 里的包。串口只在发送缓冲放得下一整行时才写，
+// 行不会被拆开，其他日志也插不进来；MQTT 每步最多发布一包。
+static send_result_t chunk_send(void)
+{
+    if (cap_sink == FRAME_CAPTURE_SINK_MQTT)
+    {
+        if (step_published) return SEND_WAIT;
+        step_published = true;
+        if (!MQTTManager_PublishBinary(MQTT_TOPIC_CAPTURE, chunk_buf, chunk_len)) return SEND_FAILED;
+    }
+    else
+    {
+        uint16_t line_len = serial_line(chunk_buf, chunk_len);
+        if ((size_t)Serial.availableForWrite() < line_len)
+        {
+            if (!sink_waiting)
+            {
+                sink_waiting = true;
+                sink_wait_start = millis();
+            }
+            // 发送缓冲比一行还小时永远等不到，超时后退回阻塞写
+            if (millis() - sink_wait_start < FRAME_CAPTURE_SINK_WAIT_MS) return SEND_WAIT;
+            cur_stats.blocking_sends++;
+        }
+        sink_waiting = false;
+        Serial.write((const uint8_t *)line_buf, line_len);
+    }
+    cur_stats.chunks++;
+    chunk_len = 0;
+    chunk_ready = false;
+    return SEND_DONE;
+}
+
+static uint32_t hash_tile(uint16_t tx, uint16_t ty, uint16_t w, uint16_t h)
+{
+    const uint16_t * row = cap_fb + ty * FRAME_CAPTURE_TILE * cap_width + tx * FRAME_CAPTURE_TILE;
+    uint32_t hash = 2166136261u;
+    for (uint16_t y = 0; y < h; y++, row += cap_width)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            hash = (hash ^ row[x]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+// 把一块编码进 tile_buf，返回记录长度
+static uint16_t encode_tile(uint16_t tx, uint16_t ty, uint16_t w, uint16_t h)
+{
+    const uint16_t * row = cap_fb + ty * FRAME_CAPTURE_TILE * cap_width + tx * FRAME_CAPTURE_TILE;
+    uint16_t raw_len = w * h * 2;
+    uint8_t * data = tile_buf + TILE_RECORD_HEADER_SIZE;
+    uint16_t len = 0;
+    uint16_t run_px = 0;
+    uint16_t run_count = 0;
+    const uint16_t * p = row;
+
+    // RLE，一旦不比原始数据小就放弃
+    for (uint16_t y = 0; y < h && len < raw_len; y++, p += cap_width)
+    {
+        for (uint16_t x = 0; x < w; x++)
+        {
+            if (run_count && p[x] == run_px && run_count < 256)
+            {
+                run_count++;
+                continue;
+            }
+            if (run_count)
+            {
+                data[len] = run_count - 1;
+                put_u16(data + len + 1, run_px);
+                len += 3;
+                if (len >= raw_len) break;
+            }
+            run_px = p[x];
+            run_count = 1;
+        }
+    }
+    if (run_count && len < raw_len)
+    {
+        data[len] = run_count - 1;
+        put_u16(data + len + 1, run_px);
+        len += 3;
+    }
+
+    uint8_t enc = FRAME_CAPTURE_ENC_RLE;
+    if (len >= raw_len)
+    {
+        enc = FRAME_CAPTURE_ENC_RAW;
+        len = 0;
+        for (p = row; len < raw_len; p += cap_width)
+        {
+            for (uint16_t x = 0; x < w; x++, len += 2)
+            {
+                put_u16(data + len, p[x]);
+            }
+        }
+    }
+
+    tile_buf[0] = tx;
+    tile_buf[1] = ty;
+    tile_buf[2] = enc;
+    put_u16(tile_buf + 3, len);
+
+    cur_stats.raw_bytes += raw_len;
+    cur_stats.encoded_bytes += len;
+    return TILE_RECORD_HEADER_SIZE + len;
+}
+
+static void capture_abort(void)
+{
+    Serial.println("FrameCapture: aborted, MQTT not connected");
+    cap_running = false;
+    // 接收端少了一部分块，下次必须发关键帧
+    cap_have_reference = false;
+}
+
+bool FrameCaptureStart(const uint16_t * fb, uint16_t width, uint16_t height,
+                       frame_capture_sink_t sink, bool keyframe)
+{
+    uint16_t tiles_x = (width + FRAME_CAPTURE_TILE - 1) / FRAME_CAPTURE_TILE;
+    uint16_t tiles_y = (height + FRAME_CAPTURE_TILE - 1) / FRAME_CAPTURE_TILE;
+    if (cap_running || !fb || tiles_x * tiles_y > FRAME_CAPTURE_MAX_TILES) return false;
+    if (sink == FRAME_CAPTURE_SINK_MQTT && !MQTTManager_IsConnected()) return false;
+
+    // 分辨率变了，旧的哈希没有意义
+    if (width != cap_width || height != cap_height) cap_have_reference = false;
+
+    cap_fb = fb;
+    cap_width = width;
+    cap_height = height;
+    cap_tiles_x = tiles_x;
+    cap_tiles_y = tiles_y;
+    cap_sink = sink;
+    cap_keyframe = keyframe || !cap_have_reference;
+    cap_frame_id++;
+    cap_seq = 0;
+    cap_cursor = 0;
+    cap_end_queued = false;
+    tile_len = 0;
+    sink_waiting = false;
+    memset(&cur_stats, 0, sizeof(cur_stats));
+    cur_stats.frame_id = cap_frame_id;
+
+    // 和其他包一样由 FrameCaptureUpdate() 发出
+    chunk_begin(FRAME_CAPTURE_CHUNK_BEGIN);
+    put_u16(chunk_buf + chunk_len, width);
+    put_u16(chunk_buf + chunk_len + 2, height);
+    chunk_buf[chunk_len + 4] = FRAME_CAPTURE_TILE;
+    chunk_buf[chunk_len + 5] = cap_keyframe;
+    chunk_len += 6;
+    chunk_ready = true;
+    cap_running = true;
+    return true;
+}
+
+void FrameCaptureUpdate(void)
+{
+    if (!cap_running) return;
+
+    uint32_t start = micros();
+    uint16_t tile_count = cap_tiles_x * cap_tiles_y;
+    bool done = false;
+    step_published = false;
+
+    // 每轮只做一件事：发送待发的包、把编码好的块放进包、编码下一块或结束这一帧。
+    // 发送端没空间时这一步就此结束，不在这里等。
+    for (;;)
+    {
+        if (chunk_ready)
+        {
+            send_result_t result = chunk_send();
+            if (result == SEND_FAILED)
+            {
+                capture_abort();
+                return;
+            }
+            if (result == SEND_WAIT)
+            {
+                cur_stats.sink_waits++;
+                break;
+            }
+            if (cap_end_queued)
+            {
+                done = true;
+                break;
+            }
+        }
+        if (micros() - start >= FRAME_CAPTURE_STEP_BUDGET_US) break;
+
+        if (tile_len)
+        {
+            if (chunk_len && chunk_len + tile_len > sizeof(chunk_buf))
+            {
+                chunk_ready = true;
+                continue;
+            }
+            if (!chunk_len) chunk_begin(FRAME_CAPTURE_CHUNK_TILES);
+            memcpy(chunk_buf + chunk_len, tile_buf, tile_len);
+            chunk_len += tile_len;
+            tile_len = 0;
+        }
+        else if (cap_cursor < tile_count)
+        {
+            uint16_t tx = cap_cursor % cap_tiles_x;
+            uint16_t ty = cap_cursor / cap_tiles_x;
+            uint16_t w = min(FRAME_CAPTURE_TILE, cap_width - tx * FRAME_CAPTURE_TILE);
+            uint16_t h = min(FRAME_CAPTURE_TILE, cap_height - ty * FRAME_CAPTURE_TILE);
+
+            uint32_t hash = hash_tile(tx, ty, w, h);
+            if (cap_keyframe || hash != tile_hash[cap_cursor])
+            {
+                tile_len = encode_tile(tx, ty, w, h);
+                tile_hash[cap_cursor] = hash;
+                cur_stats.tiles_changed++;
+            }
+            cap_cursor++;
+        }
+        else if (chunk_len)
+        {
+            // 最后一个块包
+            chunk_ready = true;
+        }
+        else
+        {
+            uint32_t step_us = micros() - start;
+            chunk_begin(FRAME_CAPTURE_CHUNK_END);
+            put_u16(chunk_buf + chunk_len, cur_stats.tiles_changed);
+            put_u32(chunk_buf + chunk_len + 2, cur_stats.encoded_bytes);
+            put_u32(chunk_buf + chunk_len + 6, cur_stats.total_us + step_us);
+            chunk_len += 10;
+            chunk_ready = true;
+            cap_end_queued = true;
+        }
+    }
+
+    uint32_t step_us = micros() - start;
+    cur_stats.total_us += step_us;
+    cur_stats.steps++;
+    if (step_us > cur_stats.max_step_us) cur_stats.max_step_us = step_us;
+
+    if (done)
+    {
+        cap_running = false;
+        cap_have_reference = true;
+        last_stats = cur_stats;
+        Serial.printf("FrameCapture: frame %u, %u/%u tiles, %u -> %u bytes in %u chunks, %u us over %u steps (max %u us, %u sink waits, %u blocking)\n",
+                      last_stats.frame_id, last_stats.tiles_changed, tile_count,
+                      last_stats.raw_bytes, last_stats.encoded_bytes, last_stats.chunks,
+                      last_stats.total_us, last_stats.steps, last_stats.max_step_us,
+                      last_stats.sink_waits, last_stats.blocking_sends);
+    }
+}
+
+bool FrameCaptureIsRunning(void)
+{
+    return cap_running;
+}
+
+const frame_capture_stats_t * FrameCaptureGetStats(void)
+{
+    return &last_stats;
+}
+
+} /*extern "C"*/
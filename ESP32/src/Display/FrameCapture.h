@@ -0,0 +1,72 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 帧缓冲远程截图：把 RGB565 帧缓冲切成 16x16 的块，只发送自上次截图以来变化的块
+// (按块哈希比较)，每块 RLE 编码，分成小包经串口 (base64 文本行 "CAP ...") 或 MQTT 发出。
+// 不复制整帧，每次 FrameCaptureUpdate() 只处理预算时间内能完成的块，
+// 所以一帧截图会分散在多次 loop() 中，期间屏幕的变化可能出现在部分块里。
+// 主机端用 tools/capture_decode.py 还原成 PNG。
+//
+// 发送不阻塞 loop()：串口只在发送缓冲放得下一整行 (最长 FRAME_CAPTURE_MAX_LINE 字节)
+// 时才写入，否则这个包留到下一步；MQTT 每步最多发布一包，耗时计入预算。
+// 单步耗时上限 = FRAME_CAPTURE_STEP_BUDGET_US + 一块的哈希和编码 + 一包的发送，
+// 其中串口发送只是拷进发送缓冲 (约 0.1 ms)。两种情况会超出：
+//   - 串口发送缓冲小于一行 (没有用 FRAME_CAPTURE_SERIAL_TX_BUFFER 调 setTxBufferSize)：
+//     等 FRAME_CAPTURE_SINK_WAIT_MS 后退回阻塞写，115200 波特率下一行约 90 ms；
+//   - MQTT 的 TCP 发送缓冲已满：publish 会阻塞，最长到 WiFiClient 的写超时。
+// 两者都计入 frame_capture_stats_t。结束的那一步还会用 Serial.printf 打印一行统计，
+// 和其他日志一样可能等串口。
+#define FRAME_CAPTURE_TILE 16
+#define FRAME_CAPTURE_MAX_TILES ((480 / FRAME_CAPTURE_TILE) * (480 / FRAME_CAPTURE_TILE))
+#define FRAME_CAPTURE_CHUNK_PAYLOAD 760     // 每包最大负载，加上包头后仍在 MQTT_BUFFER_SIZE 之内
+#define FRAME_CAPTURE_STEP_BUDGET_US 2000   // 每次 FrameCaptureUpdate() 的时间预算
+#define FRAME_CAPTURE_MAX_LINE (4 + (5 + FRAME_CAPTURE_CHUNK_PAYLOAD + 2) / 3 * 4 + 2) // "CAP " base64 "\r\n"
+#define FRAME_CAPTURE_SERIAL_TX_BUFFER 2048 // 建议的串口发送缓冲，放得下一行还有余量
+#define FRAME_CAPTURE_SINK_WAIT_MS 500      // 串口缓冲一直放不下一整行时，等这么久后阻塞写
+
+// 包类型，包头为 type(u8) frame(u16) seq(u16)，多字节字段均为小端
+#define FRAME_CAPTURE_CHUNK_BEGIN 0         // width(u16) height(u16) tile(u8) keyframe(u8)
+#define FRAME_CAPTURE_CHUNK_TILES 1         // 若干块: tx(u8) ty(u8) enc(u8) len(u16) data
+#define FRAME_CAPTURE_CHUNK_END 2           // tiles(u16) encoded_bytes(u32) cost_us(u32)
+
+#define FRAME_CAPTURE_ENC_RAW 0             // 逐像素 RGB565
+#define FRAME_CAPTURE_ENC_RLE 1             // (count-1)(u8) pixel(u16) 重复
+
+typedef enum {
+    FRAME_CAPTURE_SINK_SERIAL = 0,
+    FRAME_CAPTURE_SINK_MQTT
+} frame_capture_sink_t;
+
+typedef struct {
+    uint16_t frame_id;
+    uint16_t tiles_changed;
+    uint32_t raw_bytes;         // 变化块未压缩的大小
+    uint32_t encoded_bytes;     // 实际发送的块数据
+    uint16_t chunks;
+    uint16_t steps;             // 分了几次 FrameCaptureUpdate() 完成
+    uint32_t total_us;          // 扫描、编码和发送的总耗时
+    uint32_t max_step_us;       // 单次 FrameCaptureUpdate() 的最长耗时
+    uint16_t sink_waits;        // 发送端没空间，包留到下一步的次数
+    uint16_t blocking_sends;    // 等待超时后阻塞写出的行数
+} frame_capture_stats_t;
+
+// 开始截一帧，keyframe 为 true 时发送所有块。正在截图时返回 false
+bool FrameCaptureStart(const uint16_t * fb, uint16_t width, uint16_t height,
+                       frame_capture_sink_t sink, bool keyframe);
+// 在 loop() 中调用，没有截图时立即返回
+void FrameCaptureUpdate(void);
+bool FrameCaptureIsRunning(void);
+const frame_capture_stats_t * FrameCaptureGetStats(void); // 上一帧完成的截图
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // FRAME_CAPTURE_H
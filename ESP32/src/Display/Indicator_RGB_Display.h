@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Arduino_DataBus.h"
+#include "ST7701InitStream.h"
 
-#if defined(ESP32) && (CONFIG_IDF_TARGET_ESP32S3)
+// Plain data and compile-time checks, not guarded by the target so that the
+// static_asserts below also run in the host tests (tests/host/)
 
-static const uint8_t st7701_indicator_init_operations[] = {
+// Only read at compile time, the panel is initialized from st7701_indicator_init_stream below
+static constexpr uint8_t st7701_indicator_init_operations[] = {
     BEGIN_WRITE,
     WRITE_COMMAND_8, 0xFF,
     WRITE_BYTES, 5, 0x77, 0x01, 0x00, 0x00, 0x10,
@@ -126,4 +129,16 @@ static const uint8_t st7701_indicator_init_operations[] = {
     WRITE_COMMAND_8, 0x29, // Display On
     END_WRITE};
 
-#endif // #if defined(ESP32) && (CONFIG_IDF_TARGET_ESP32S3)
+// The table above as a packed 9-bit stream for Indicator_SWSPI::setInitStream()
+static constexpr size_t st7701_indicator_init_words =
+    ST7701Init::countWords(st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations));
+static constexpr size_t st7701_indicator_init_segments =
+    ST7701Init::countSegments(st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations));
+static_assert(st7701_indicator_init_words != ST7701Init::INVALID, "Unsupported operation in the ST7701 init table");
+
+static constexpr ST7701Init::Stream<st7701_indicator_init_words, st7701_indicator_init_segments> st7701_indicator_init_stream =
+    ST7701Init::encode<st7701_indicator_init_words, st7701_indicator_init_segments>(
+        st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations));
+static_assert(ST7701Init::matches(st7701_indicator_init_stream, st7701_indicator_init_operations,
+                                  sizeof(st7701_indicator_init_operations)),
+              "ST7701 init stream does not decode back to the operation table");
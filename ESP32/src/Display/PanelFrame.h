@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Framing for the panel command bus: words of any width up to 16 bits packed back to
+ * back, MSB first, exactly in the order they leave on MOSI. 3-wire 9-bit words carry
+ * the D/C bit on top (PANEL_FRAME_DATA). Used at compile time by ST7701InitStream.h
+ * and at run time by Indicator_HWSPI, which hands the bytes to the SPI host as-is.
+ */
+
+#define PANEL_FRAME_DATA 0x100 // D/C bit of a 9-bit word: set for data, clear for command
+#define PANEL_FRAME_MAX_BYTES 64 // SPI host transaction without DMA
+
+// buf must be zero from bit on
+constexpr void panel_frame_put(uint8_t *buf, size_t bit, uint16_t value, uint8_t bits)
+{
+  for (int b = bits - 1; b >= 0; b--, bit++)
+  {
+    if (value & (1 << b))
+    {
+      buf[bit >> 3] |= (uint8_t)(0x80 >> (bit & 7));
+    }
+  }
+}
+
+constexpr uint16_t panel_frame_get(const uint8_t *buf, size_t bit, uint8_t bits)
+{
+  uint16_t value = 0;
+  for (size_t end = bit + bits; bit < end; bit++)
+  {
+    value = (uint16_t)((value << 1) | ((buf[bit >> 3] >> (7 - (bit & 7))) & 1));
+  }
+  return value;
+}
+
+// One transaction's worth of words
+struct PanelFrame
+{
+  uint8_t buf[PANEL_FRAME_MAX_BYTES];
+  uint16_t bits;
+
+  bool fits(uint8_t n) const { return bits + n <= PANEL_FRAME_MAX_BYTES * 8; }
+
+  void put(uint16_t value, uint8_t n)
+  {
+    panel_frame_put(buf, bits, value, n);
+    bits += n;
+  }
+
+  void clear()
+  {
+    for (uint16_t i = 0; i < (bits + 7) / 8; i++)
+    {
+      buf[i] = 0;
+    }
+    bits = 0;
+  }
+};
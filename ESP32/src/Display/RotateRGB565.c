@@ -0,0 +1,149 @@
+#include <Arduino.h>
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+#include "RotateRGB565.h"
+
+#define CHECK_SIZE 480
+
+// =================================================================
+// --- Kernels ---
+// =================================================================
+
+// dst(row = w-1-x, col = y) = src(y, x) for 90, dst(row = x, col = h-1-y) for 270.
+// Walk the source in TILE x TILE blocks so both the rows read and the rows
+// written stay within a few cache lines; the rotation is a compile-time
+// constant after inlining, so each direction gets its own loop nest.
+static inline __attribute__((always_inline)) void rotate_quarter(const uint16_t * src, uint16_t * dst,
+                                                                 int32_t w, int32_t h, int32_t ss, int32_t ds,
+                                                                 bool cw)
+{
+    for (int32_t ty = 0; ty < h; ty += ROTATE_RGB565_TILE) {
+        int32_t y_end = LV_MIN(ty + ROTATE_RGB565_TILE, h);
+        for (int32_t tx = 0; tx < w; tx += ROTATE_RGB565_TILE) {
+            int32_t x_end = LV_MIN(tx + ROTATE_RGB565_TILE, w);
+            for (int32_t y = ty; y < y_end; y++) {
+                const uint16_t * s = src + y * ss + tx;
+                if (!cw) {
+                    // LV_DISPLAY_ROTATION_90
+                    uint16_t * d = dst + (w - 1 - tx) * ds + y;
+                    for (int32_t x = tx; x < x_end; x++) {
+                        *d = *s++;
+                        d -= ds;
+                    }
+                } else {
+                    // LV_DISPLAY_ROTATION_270
+                    uint16_t * d = dst + tx * ds + (h - 1 - y);
+                    for (int32_t x = tx; x < x_end; x++) {
+                        *d = *s++;
+                        d += ds;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Already sequential: each source row becomes a reversed destination row
+static void rotate_half(const uint16_t * src, uint16_t * dst, int32_t w, int32_t h, int32_t ss, int32_t ds)
+{
+    for (int32_t y = 0; y < h; y++) {
+        const uint16_t * s = src + y * ss;
+        uint16_t * d = dst + (h - 1 - y) * ds + w - 1;
+        for (int32_t x = 0; x < w; x++) {
+            *d-- = *s++;
+        }
+    }
+}
+
+__attribute__((weak)) bool RotateRGB565_SIMD(const uint16_t * src, uint16_t * dst, int32_t src_w, int32_t src_h,
+                                             int32_t src_stride, int32_t dst_stride, lv_display_rotation_t rotation)
+{
+    LV_UNUSED(src);
+    LV_UNUSED(dst);
+    LV_UNUSED(src_w);
+    LV_UNUSED(src_h);
+    LV_UNUSED(src_stride);
+    LV_UNUSED(dst_stride);
+    LV_UNUSED(rotation);
+    return false;
+}
+
+void RotateRGB565(const uint16_t * src, uint16_t * dst, int32_t src_w, int32_t src_h,
+                  int32_t src_stride, int32_t dst_stride, lv_display_rotation_t rotation)
+{
+    if (RotateRGB565_SIMD(src, dst, src_w, src_h, src_stride, dst_stride, rotation)) {
+        return;
+    }
+
+    int32_t ss = src_stride / sizeof(uint16_t);
+    int32_t ds = dst_stride / sizeof(uint16_t);
+    switch (rotation) {
+        case LV_DISPLAY_ROTATION_90:
+            rotate_quarter(src, dst, src_w, src_h, ss, ds, false);
+            break;
+        case LV_DISPLAY_ROTATION_270:
+            rotate_quarter(src, dst, src_w, src_h, ss, ds, true);
+            break;
+        case LV_DISPLAY_ROTATION_180:
+            rotate_half(src, dst, src_w, src_h, ss, ds);
+            break;
+        default:
+            for (int32_t y = 0; y < src_h; y++) {
+                lv_memcpy(dst + y * ds, src + y * ss, src_w * sizeof(uint16_t));
+            }
+            break;
+    }
+}
+
+// =================================================================
+// --- Self Check ---
+// =================================================================
+
+bool RotateRGB565SelfCheck(rotate_rgb565_check_t * result)
+{
+    const int32_t n = CHECK_SIZE;
+    const int32_t stride = n * sizeof(uint16_t);
+    const size_t size = n * stride;
+
+    uint16_t * src = (uint16_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    uint16_t * ref = (uint16_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    uint16_t * out = (uint16_t *)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    bool ok = src && ref && out;
+
+    if (ok) {
+        for (int32_t i = 0; i < n * n; i++) {
+            src[i] = (uint16_t)(i * 2654435761u >> 16);
+        }
+
+        // An odd-sized sub-area first, then the full frame for timing
+        static const lv_display_rotation_t rotations[3] = {
+            LV_DISPLAY_ROTATION_90, LV_DISPLAY_ROTATION_180, LV_DISPLAY_ROTATION_270
+        };
+        for (int r = 0; r < 3; r++) {
+            bool exact = true;
+            for (int pass = 0; pass < 2; pass++) {
+                int32_t w = pass ? n : 37;
+                int32_t h = pass ? n : 23;
+                memset(ref, 0, size);
+                memset(out, 0, size);
+
+                uint32_t t = micros();
+                lv_draw_sw_rotate(src, ref, w, h, stride, stride, rotations[r], LV_COLOR_FORMAT_RGB565);
+                result->lvgl_us[r] = micros() - t;
+
+                t = micros();
+                RotateRGB565(src, out, w, h, stride, stride, rotations[r]);
+                result->tiled_us[r] = micros() - t;
+
+                exact = exact && memcmp(ref, out, size) == 0;
+            }
+            result->exact[r] = exact;
+            ok = ok && exact;
+        }
+    }
+
+    heap_caps_free(src);
+    heap_caps_free(ref);
+    heap_caps_free(out);
+    return ok;
+}
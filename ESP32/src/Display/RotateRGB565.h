@@ -0,0 +1,36 @@
+#ifndef ROTATE_RGB565_H
+#define ROTATE_RGB565_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 分块旋转 RGB565 区域，语义与 lv_draw_sw_rotate() 相同：
+// src 为 src_w x src_h 的区域，步长单位为字节；90/270 时目标为 src_h x src_w。
+// 90/270 按 ROTATE_RGB565_TILE 大小的块转置，读写都留在缓存里，
+// 不再沿 PSRAM 列方向跳着访问。
+#define ROTATE_RGB565_TILE 32
+
+void RotateRGB565(const uint16_t * src, uint16_t * dst, int32_t src_w, int32_t src_h,
+                  int32_t src_stride, int32_t dst_stride, lv_display_rotation_t rotation);
+
+// ESP32-S3 SIMD 实现的挂钩 (弱符号)：处理了返回 true，否则用可移植的 C 版本
+bool RotateRGB565_SIMD(const uint16_t * src, uint16_t * dst, int32_t src_w, int32_t src_h,
+                       int32_t src_stride, int32_t dst_stride, lv_display_rotation_t rotation);
+
+// 与 lv_draw_sw_rotate() 的逐位比较和计时 (480x480)，串口命令 "rotate" 调用
+typedef struct {
+    bool exact[3];          // 90, 180, 270
+    uint32_t lvgl_us[3];
+    uint32_t tiled_us[3];
+} rotate_rgb565_check_t;
+
+bool RotateRGB565SelfCheck(rotate_rgb565_check_t * result);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*ROTATE_RGB565_H*/
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "Arduino_DataBus.h"
+#include "PanelFrame.h"
+
+/*
+ * Compile-time encoder for Arduino_GFX init operation tables on a 3-wire (9-bit) bus.
+ *
+ * The table is turned into the exact bit sequence the panel sees on MOSI: 9-bit words
+ * packed back to back, MSB first, each starting with its D/C bit (0 command, 1 data).
+ * DELAY splits the stream into segments; BEGIN_WRITE/END_WRITE disappear because the
+ * whole stream is sent with CS held. A sender only needs to clock bits out.
+ *
+ * Usage (see Indicator_RGB_Display.h):
+ *   constexpr size_t words = ST7701Init::countWords(ops, sizeof(ops));
+ *   constexpr size_t segments = ST7701Init::countSegments(ops, sizeof(ops));
+ *   constexpr auto stream = ST7701Init::encode<words, segments>(ops, sizeof(ops));
+ *   static_assert(ST7701Init::matches(stream, ops, sizeof(ops)), "...");
+ */
+
+struct ST7701InitSegment
+{
+  uint16_t words;   // 9-bit words to send
+  uint8_t delay_ms; // Then wait this long
+};
+
+// Non-template view handed to the bus
+struct ST7701InitStreamView
+{
+  const uint8_t *bits;
+  const ST7701InitSegment *segments;
+  uint8_t segment_count;
+  uint16_t words;
+};
+
+namespace ST7701Init
+{
+
+static constexpr size_t INVALID = (size_t)-1;
+
+template <size_t Words, size_t Segments>
+struct Stream
+{
+  uint8_t bits[(Words * 9 + 7) / 8];
+  ST7701InitSegment segments[Segments];
+
+  constexpr ST7701InitStreamView view() const
+  {
+    return {bits, segments, (uint8_t)Segments, (uint16_t)Words};
+  }
+};
+
+// Walks the table the way Arduino_DataBus::batchOperation() does, calling
+// word(value) for every 9-bit word and pause(ms) for every DELAY.
+// Returns false on an operation it does not know.
+template <typename WordFn, typename PauseFn>
+constexpr bool walk(const uint8_t *ops, size_t len, WordFn &word, PauseFn &pause)
+{
+  for (size_t i = 0; i < len; ++i)
+  {
+    size_t data = 0;
+    switch (ops[i])
+    {
+    case BEGIN_WRITE:
+    case END_WRITE:
+      break;
+    case WRITE_C8_D16:
+      data = 2;
+      word(ops[++i]);
+      break;
+    case WRITE_C8_D8:
+      data = 1;
+      word(ops[++i]);
+      break;
+    case WRITE_COMMAND_8:
+      word(ops[++i]);
+      break;
+    case WRITE_C16_D16:
+      data = 2;
+      word(ops[++i]);
+      word(ops[++i]);
+      break;
+    case WRITE_COMMAND_16:
+      word(ops[++i]);
+      word(ops[++i]);
+      break;
+    case WRITE_DATA_8:
+      data = 1;
+      break;
+    case WRITE_DATA_16:
+      data = 2;
+      break;
+    case WRITE_BYTES:
+      data = ops[++i];
+      break;
+    case WRITE_C8_BYTES:
+      word(ops[++i]);
+      data = ops[++i];
+      break;
+    case DELAY:
+      pause(ops[++i]);
+      break;
+    default:
+      return false;
+    }
+    while (data--)
+    {
+      word(PANEL_FRAME_DATA | ops[++i]);
+    }
+  }
+  return true;
+}
+
+struct Counter
+{
+  size_t words = 0;
+  size_t delays = 0;
+  constexpr void operator()(uint16_t) { words++; }
+};
+
+struct DelayCounter
+{
+  Counter *counter;
+  constexpr void operator()(uint8_t) { counter->delays++; }
+};
+
+constexpr size_t countWords(const uint8_t *ops, size_t len)
+{
+  Counter c;
+  DelayCounter d{&c};
+  return walk(ops, len, c, d) ? c.words : INVALID;
+}
+
+constexpr size_t countSegments(const uint8_t *ops, size_t len)
+{
+  Counter c;
+  DelayCounter d{&c};
+  return walk(ops, len, c, d) ? c.delays + 1 : INVALID;
+}
+
+template <size_t Words, size_t Segments>
+struct Packer
+{
+  Stream<Words, Segments> *out;
+  size_t word_index = 0;
+  size_t segment = 0;
+  size_t segment_start = 0;
+
+  constexpr void operator()(uint16_t w)
+  {
+    panel_frame_put(out->bits, word_index * 9, w, 9);
+    word_index++;
+  }
+};
+
+template <size_t Words, size_t Segments>
+struct SegmentCloser
+{
+  Packer<Words, Segments> *packer;
+  constexpr void operator()(uint8_t ms)
+  {
+    Stream<Words, Segments> *out = packer->out;
+    out->segments[packer->segment].words = (uint16_t)(packer->word_index - packer->segment_start);
+    out->segments[packer->segment].delay_ms = ms;
+    packer->segment++;
+    packer->segment_start = packer->word_index;
+  }
+};
+
+template <size_t Words, size_t Segments>
+constexpr Stream<Words, Segments> encode(const uint8_t *ops, size_t len)
+{
+  Stream<Words, Segments> out{};
+  Packer<Words, Segments> p{&out};
+  SegmentCloser<Words, Segments> close{&p};
+  walk(ops, len, p, close);
+  close(0); // Last segment, no delay after it
+  return out;
+}
+
+// Decodes the stream and compares it with what batchOperation() would send
+template <size_t Words, size_t Segments>
+struct Checker
+{
+  const Stream<Words, Segments> *stream;
+  size_t word_index = 0;
+  size_t segment = 0;
+  size_t segment_start = 0;
+  bool ok = true;
+
+  constexpr void operator()(uint16_t w)
+  {
+    ok = ok && word_index < Words && panel_frame_get(stream->bits, word_index * 9, 9) == w;
+    word_index++;
+  }
+};
+
+template <size_t Words, size_t Segments>
+struct SegmentChecker
+{
+  Checker<Words, Segments> *checker;
+  constexpr void operator()(uint8_t ms)
+  {
+    Checker<Words, Segments> *c = checker;
+    if (c->segment >= Segments)
+    {
+      c->ok = false;
+      return;
+    }
+    const ST7701InitSegment &s = c->stream->segments[c->segment];
+    c->ok = c->ok && s.words == c->word_index - c->segment_start && s.delay_ms == ms;
+    c->segment++;
+    c->segment_start = c->word_index;
+  }
+};
+
+template <size_t Words, size_t Segments>
+constexpr bool matches(const Stream<Words, Segments> &stream, const uint8_t *ops, size_t len)
+{
+  Checker<Words, Segments> c{&stream};
+  SegmentChecker<Words, Segments> close{&c};
+  if (!walk(ops, len, c, close))
+  {
+    return false;
+  }
+  close(0);
+  // Padding after the last word must be zero, it is never clocked out but keeps the table canonical
+  for (size_t bit = Words * 9; bit < sizeof(stream.bits) * 8; bit++)
+  {
+    c.ok = c.ok && !panel_frame_get(stream.bits, bit, 1);
+  }
+  return c.ok && c.word_index == Words && c.segment == Segments;
+}
+
+} // namespace ST7701Init
@@ -0,0 +1,45 @@
+#include <string.h>
+#include "VsyncPacer.h"
+
+void VsyncPacer_Init(vsync_pacer_t * pacer, uint8_t divider)
+{
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->divider = divider;
+}
+
+void VsyncPacer_SetDivider(vsync_pacer_t * pacer, uint8_t divider)
+{
+    pacer->divider = divider;
+    pacer->slot_vsync = pacer->vsync_count;
+}
+
+void VsyncPacer_ResetStats(vsync_pacer_t * pacer)
+{
+    pacer->frames_rendered = 0;
+    pacer->frames_dropped = 0;
+    pacer->frames_duplicated = 0;
+}
+
+bool VsyncPacer_Poll(vsync_pacer_t * pacer)
+{
+    if (!pacer->divider) return false;
+
+    uint32_t elapsed = pacer->vsync_count - pacer->slot_vsync;
+    if (elapsed < pacer->divider) return false;
+
+    // Polled late, the previous picture stayed up for the extra scan-outs.
+    // Restart the cadence from now rather than trying to catch up.
+    pacer->frames_duplicated += elapsed - pacer->divider;
+    pacer->slot_vsync += elapsed;
+    return true;
+}
+
+void VsyncPacer_FrameRendered(vsync_pacer_t * pacer)
+{
+    uint32_t now = pacer->vsync_count;
+    // No scan-out started since the previous frame was finished, it was never shown
+    if (pacer->rendered_once && now == pacer->rendered_vsync) pacer->frames_dropped++;
+    pacer->rendered_vsync = now;
+    pacer->rendered_once = true;
+    pacer->frames_rendered++;
+}
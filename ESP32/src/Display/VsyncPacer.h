@@ -0,0 +1,48 @@
+#ifndef VSYNC_PACER_H
+#define VSYNC_PACER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 按面板 VSYNC 节拍决定何时刷新 LVGL。只依赖计数，不碰硬件：
+// 设备上由 GPIO 中断调用 VsyncPacer_OnVsync()，也可以用模拟的 VSYNC 源驱动。
+//   divider 0     不按节拍，LVGL 自己的刷新定时器照常运行，只统计
+//   divider N     每 N 个 VSYNC 刷新一次 (面板约 42 Hz 时：1 → 42, 2 → 21, 3 → 14 Hz)
+// 统计：
+//   dropped     渲染好的帧在下一个 VSYNC 之前又被覆盖，从未显示
+//   duplicated  刷新时机过了才轮到刷新，上一帧多显示的扫描周期数
+typedef struct {
+    volatile uint32_t vsync_count;  // 由中断递增
+    uint8_t divider;
+    uint32_t slot_vsync;            // 上一次刷新时机对应的 vsync_count
+    uint32_t rendered_vsync;        // 上一帧渲染完成时的 vsync_count
+    bool rendered_once;
+    uint32_t frames_rendered;
+    uint32_t frames_dropped;
+    uint32_t frames_duplicated;
+} vsync_pacer_t;
+
+void VsyncPacer_Init(vsync_pacer_t * pacer, uint8_t divider);
+void VsyncPacer_SetDivider(vsync_pacer_t * pacer, uint8_t divider);
+void VsyncPacer_ResetStats(vsync_pacer_t * pacer);
+
+// 中断里调用
+static inline void VsyncPacer_OnVsync(vsync_pacer_t * pacer)
+{
+    pacer->vsync_count++;
+}
+
+// 主循环里调用：按节拍时返回 true，调用者随后刷新一次
+bool VsyncPacer_Poll(vsync_pacer_t * pacer);
+// 每渲染完一帧 (有脏区域的刷新) 调用一次
+void VsyncPacer_FrameRendered(vsync_pacer_t * pacer);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // VSYNC_PACER_H
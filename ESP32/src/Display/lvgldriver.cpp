@@ -1,4 +1,19 @@
 #include "lvgldriver.h"
+#include <Preferences.h>
+#include "../Core/PerfMonitor.h"
+#include "RotateRGB565.h"
+#include "FlushHeatmap.h"
+#include "VsyncPacer.h"
+#include "AreaCoalesce.h"
+#include "FlushPipe.h"
+#include <display/lv_display_private.h> // inv_areas, for the coalescing stage
+#include <driver/gpio.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#include <esp_cache.h>
+#else
+#include <esp32s3/rom/cache.h>
+#endif
 
 lv_display_t *disp = NULL;
 
@@ -6,13 +21,113 @@ Arduino_RGB_Display *gfxdisplay = NULL;
 
 #define BYTE_PER_PIXEL (LV_COLOR_FORMAT_GET_SIZE(LV_COLOR_FORMAT_RGB565)) /*will be 2 for RGB565 */
 
-#define DIRECT_MODE // Uncomment to enable full frame buffer
+#define DEFAULT_DISPLAY_MODE DISPLAY_MODE_DIRECT // Until the auto-tuner has saved one
+
+#define PARTIAL_LINES 10               // DISPLAY_MODE_PARTIAL: one SRAM strip
+#define ASYNC_FLUSH_LINES 40           // DISPLAY_MODE_DOUBLE_PARTIAL: lines per SRAM strip
+
+#define VSYNC_DEFAULT_DIVIDER 2        // Panel runs at about 42 Hz with a 12 MHz PCLK, 2 matches LV_DEF_REFR_PERIOD
+#define VSYNC_MAX_DIVIDER 3
+
+// 自动选择渲染模式：每种模式下重绘整屏和一个涟漪大小的区域，按耗时加权打分
+#define TUNE_FULL_FRAMES 6
+#define TUNE_SMALL_FRAMES 12
+#define TUNE_SMALL_SIZE 96             // About one ripple
+#define TUNE_SMALL_WEIGHT 4            // The animation mostly redraws small areas
+#define TUNE_MIN_FREE_INTERNAL (48 * 1024) // SRAM that has to stay free with WiFi/MQTT running
+#define TUNE_SRAM_RESERVE (40 * 1024)      // SRAM taken after boot (network, screens), until measured
+
+static const char * mode_names[DISPLAY_MODE_MAX] = {
+  "direct", "zero-copy", "partial", "double-partial"
+};
+
+static display_mode_t current_mode = DISPLAY_MODE_MAX;
+static display_mode_t l8_return_mode = DEFAULT_DISPLAY_MODE; // Mode to restore when L8 is turned off
+static bool l8_active = false;
+static uint8_t * l8_buf = NULL;
+static uint32_t l8_lines = 0;   // Lines of the SRAM strip, 0: full frame in PSRAM
+static uint16_t l8_lut[256];
+
+static void free_draw_buffers(void);
+static bool sram_margin_ok(uint32_t free_internal);
+static uint8_t * draw_buf_1 = NULL;
+static uint8_t * draw_buf_2 = NULL;
+static word screen_w = 0;
+static word screen_h = 0;
+static Preferences display_prefs;
+
+static uint32_t render_start_cycles = 0;
+
+// SRAM allocated after lv_screen_init() picked the mode, mostly by WiFi/MQTT.
+// Measured the first time the network comes up and saved; until then the
+// tuner and the boot check have to leave room for it on top of the margin.
+static uint32_t sram_reserve = TUNE_SRAM_RESERVE;
+static uint32_t sram_baseline = 0; // Free SRAM plus draw buffers, at lv_screen_init()
+static bool network_up = false;
+
+static vsync_pacer_t vsync_pacer;
+static int vsync_pin = -1;
+static bool render_suspended = false;
+// Rotated and no mode's buffers could be allocated: rendering stays paused
+// until lv_screen_set_mode() succeeds, whatever lv_screen_set_suspended() says
+static bool draw_buffers_lost = false;
+
+static void render_pause(bool pause);
+
+static area_coalesce_cb_t area_coalesce_cb = AreaCoalesce_CostModel;
+// Areas and pixels LVGL would have rendered vs. what is left after coalescing, reset by lv_screen_print_stats()
+static uint32_t coalesce_areas_in = 0;
+static uint32_t coalesce_areas_out = 0;
+static uint64_t coalesce_px_in = 0;
+static uint64_t coalesce_px_out = 0;
+
+// 用显示事件给 LVGL 渲染计时，只有真正有脏区域的刷新才会触发 RENDER_START
+static void render_timing_cb(lv_event_t * e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        render_start_cycles = PerfMonitor_Begin();
+    } else {
+        PerfMonitor_End(PERF_PHASE_RENDER, render_start_cycles);
+        VsyncPacer_FrameRendered(&vsync_pacer);
+    }
+}
+
+static void count_areas(lv_display_t * disp, uint32_t * areas, uint64_t * px)
+{
+    for (uint32_t i = 0; i < disp->inv_p; i++) {
+        if (disp->inv_area_joined[i]) continue;
+        (*areas)++;
+        *px += lv_area_get_size(&disp->inv_areas[i]);
+    }
+}
+
+// RENDER_START comes after LVGL's own joining and before the first area is rendered
+static void coalesce_areas_cb(lv_event_t * e)
+{
+    lv_display_t * disp = (lv_display_t *)lv_event_get_target(e);
+    count_areas(disp, &coalesce_areas_in, &coalesce_px_in);
+    if (area_coalesce_cb) {
+        PerfMonitor_Count(PERF_COUNTER_COALESCE_PASSES,
+                          area_coalesce_cb(disp->inv_areas, disp->inv_area_joined, disp->inv_p));
+    }
+    count_areas(disp, &coalesce_areas_out, &coalesce_px_out);
+}
+
+static void render_timing_attach(lv_display_t * disp)
+{
+    lv_display_add_event_cb(disp, coalesce_areas_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, render_timing_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, render_timing_cb, LV_EVENT_RENDER_READY, NULL);
+}
 
-#ifdef DIRECT_MODE
+// =================================================================
+// --- Direct: full frame PSRAM buffer, dirty areas copied ---
+// =================================================================
 
 /* LVGL calls it when a rendered image needs to copied to the display*/
 void my_disp_flush_direct(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
 {
+    uint32_t flush_start = PerfMonitor_Begin();
     int32_t disp_hres = lv_display_get_horizontal_resolution(disp);
     int32_t disp_vres = lv_display_get_vertical_resolution(disp);
     lv_color_format_t cf = lv_display_get_color_format(disp);
@@ -22,7 +137,7 @@ void my_disp_flush_direct(lv_display_t * disp, const lv_area_t * area, uint8_t *
     lv_area_t rotated_area = *area;
     lv_display_rotate_area(disp, &rotated_area);
 
-    /*Calculate the source stride (bytes in a line) from the width of the area*/    
+    /*Calculate the source stride (bytes in a line) from the width of the area*/
     uint32_t src_stride = lv_draw_buf_width_to_stride(disp_hres, cf);
 
     /*Calculate the stride of the destination (rotated) area too*/
@@ -33,69 +148,105 @@ void my_disp_flush_direct(lv_display_t * disp, const lv_area_t * area, uint8_t *
 
     px_map += area->y1 * src_stride + area->x1 * px_size;
 
+    // Recorded first so the tint below already counts this area
+    FlushHeatmap_Record(disp, area);
+
     lv_display_rotation_t rotation = lv_display_get_rotation(disp);
     if(rotation == LV_DISPLAY_ROTATION_0) {
-        // Direct copy !!
+        // Direct copy !! Only the dirty columns of each row
+        uint32_t row_bytes = lv_area_get_width(area) * px_size;
         int32_t y;
         for(y = area->y1; y <= area->y2; y++) {
-            lv_memcpy(fb_start, px_map, src_stride);
+            lv_memcpy(fb_start, px_map, row_bytes);
             px_map += src_stride;
             fb_start += fb_stride;
         }
+        PerfMonitor_Count(PERF_COUNTER_COPIED_BYTES, row_bytes * lv_area_get_height(area));
+        FlushHeatmap_Tint((uint16_t *)gfxdisplay->getFramebuffer(), disp_hres, area);
     }
     else
     {
       /*Calculate the properties of the source buffer*/
       int32_t src_w = lv_area_get_width(area);
       int32_t src_h = lv_area_get_height(area);
-      // Rotate
-      lv_draw_sw_rotate(px_map, fb_start, src_w, src_h, src_stride, fb_stride, rotation, cf);
+      // Rotate, cache-blocked for RGB565
+      if (cf == LV_COLOR_FORMAT_RGB565) {
+        RotateRGB565((const uint16_t *)px_map, (uint16_t *)fb_start, src_w, src_h, src_stride, fb_stride, rotation);
+      } else {
+        lv_draw_sw_rotate(px_map, fb_start, src_w, src_h, src_stride, fb_stride, rotation, cf);
+      }
+      PerfMonitor_Count(PERF_COUNTER_COPIED_BYTES, src_w * src_h * px_size);
     }
     if (lv_display_flush_is_last(disp))
     {
       gfxdisplay->flush();
     }
+    PerfMonitor_End(PERF_PHASE_FLUSH, flush_start);
+    PerfMonitor_Count(PERF_COUNTER_FLUSHES, 1);
+    PerfMonitor_Count(PERF_COUNTER_FLUSHED_PX, lv_area_get_size(area));
     lv_disp_flush_ready(disp);
 }
 
-void lv_screen_init(void * gfx, word W, word H)
+// =================================================================
+// --- Zero-copy: LVGL renders into the panel framebuffer ---
+// =================================================================
+
+/* Write the dirty rows of the panel framebuffer back from the CPU cache so the LCD DMA sees them */
+static void fb_writeback(uint8_t * fb, int32_t fb_stride, const lv_area_t * area, uint32_t px_size)
 {
-  gfxdisplay = (Arduino_RGB_Display*) gfx;
+    uint8_t * start = fb + area->y1 * fb_stride + area->x1 * px_size;
+    size_t size = (area->y2 - area->y1) * fb_stride + lv_area_get_width(area) * px_size;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    esp_cache_msync(start, size, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+#else
+    Cache_WriteBack_Addr((uint32_t)start, size);
+#endif
+}
 
-  static uint8_t * sbuf2_1 = (uint8_t *)heap_caps_aligned_alloc(4, W * H * BYTE_PER_PIXEL, MALLOC_CAP_SPIRAM);
-  static uint8_t * sbuf2_2 = NULL;
-  //sbuf2_2 = (uint8_t *)heap_caps_aligned_alloc(4, screenWidth * screenHeight * BYTE_PER_PIXEL, MALLOC_CAP_SPIRAM);
+/* px_map is the panel framebuffer itself, nothing to copy.
+ * Arduino_RGB_Display only exposes a single framebuffer, so there is no back
+ * buffer to swap to; LVGL's direct mode redraws only the dirty areas in place,
+ * which can tear on fast motion but halves the PSRAM traffic of the copy path.
+ * Rotation 0 only. */
+void my_disp_flush_zero_copy(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    uint32_t flush_start = PerfMonitor_Begin();
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    int32_t fb_stride = lv_draw_buf_width_to_stride(lv_display_get_horizontal_resolution(disp), cf);
 
-  disp = lv_display_create(W, H);
+    fb_writeback(px_map, fb_stride, area, lv_color_format_get_size(cf));
 
-  lv_display_set_flush_cb(disp, my_disp_flush_direct);
-  lv_display_set_buffers(disp, sbuf2_1, sbuf2_2, W * H * BYTE_PER_PIXEL, LV_DISPLAY_RENDER_MODE_DIRECT);
-  lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    PerfMonitor_End(PERF_PHASE_FLUSH, flush_start);
+    PerfMonitor_Count(PERF_COUNTER_FLUSHES, 1);
+    PerfMonitor_Count(PERF_COUNTER_FLUSHED_PX, lv_area_get_size(area));
+    FlushHeatmap_Record(disp, area);
+    lv_disp_flush_ready(disp);
 }
 
-#else
+// =================================================================
+// --- Partial: one SRAM strip drawn through Arduino_GFX ---
+// =================================================================
 
-/* LVGL calls it when a rendered image needs to copied to the display*/
-void my_disp_flush_simple(lv_display_t *disp, const lv_area_t *area, uint8_t * px_map)
+/* Draw one rendered area into the panel framebuffer via Arduino_GFX (handles rotation) */
+static void gfx_draw_area(lv_display_rotation_t rotation, const lv_area_t *area, uint8_t * px_map)
 {
   uint32_t w = lv_area_get_width(area);
   uint32_t h = lv_area_get_height(area);
 
   uint16_t * buf16 = (uint16_t *)px_map; /* Let's say it's a 16 bit (RGB565) display */
 
-  lv_display_rotation_t rotation = lv_display_get_rotation(disp);
   switch(rotation) {
       case LV_DISPLAY_ROTATION_0:
         gfxdisplay->setRotation(0);
         break;
       case LV_DISPLAY_ROTATION_90:
-        gfxdisplay->setRotation(3);      
+        gfxdisplay->setRotation(3);
         break;
       case LV_DISPLAY_ROTATION_180:
-        gfxdisplay->setRotation(2);      
+        gfxdisplay->setRotation(2);
         break;
       case LV_DISPLAY_ROTATION_270:
-        gfxdisplay->setRotation(1);      
+        gfxdisplay->setRotation(1);
         break;
   }
 
@@ -104,29 +255,741 @@ void my_disp_flush_simple(lv_display_t *disp, const lv_area_t *area, uint8_t * p
 #else
   gfxdisplay->draw16bitRGBBitmap(area->x1, area->y1, buf16, w, h);
 #endif
+}
+
+/* LVGL calls it when a rendered image needs to copied to the display*/
+void my_disp_flush_simple(lv_display_t *disp, const lv_area_t *area, uint8_t * px_map)
+{
+  uint32_t flush_start = PerfMonitor_Begin();
+  uint32_t w = lv_area_get_width(area);
+  uint32_t h = lv_area_get_height(area);
+
+  // Recorded before the tint, as in the other flush callbacks
+  FlushHeatmap_Record(disp, area);
+
+  lv_display_rotation_t rotation = lv_display_get_rotation(disp);
+  gfx_draw_area(rotation, area, px_map);
+  if (rotation == LV_DISPLAY_ROTATION_0)
+  {
+    FlushHeatmap_Tint((uint16_t *)gfxdisplay->getFramebuffer(), screen_w, area);
+  }
 
   if (lv_display_flush_is_last(disp))
   {
     gfxdisplay->flush();
   }
+  PerfMonitor_End(PERF_PHASE_FLUSH, flush_start);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHES, 1);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHED_PX, w * h);
 
   /*Call it to tell LVGL you are ready*/
   lv_disp_flush_ready(disp);
 }
 
+// =================================================================
+// --- Double-partial: two SRAM strips, asynchronous flush ---
+// =================================================================
+
+/* Two SRAM strips: LVGL renders the next area into one while the FlushPipe
+ * worker on the other core copies the previous one into the panel framebuffer.
+ * The flush callback only submits the area; LVGL blocks in my_disp_flush_wait()
+ * until the worker is done before it reuses a buffer.
+ * While an area is queued or being copied the worker owns gfxdisplay, the
+ * framebuffer and the heatmap tint; everyone else goes through
+ * lv_screen_flush_drain() first. */
+
+// Runs on the worker
+static void flush_sink(const flush_job_t * job)
+{
+  gfx_draw_area(job->rotation, &job->area, job->px_map);
+  if (job->rotation == LV_DISPLAY_ROTATION_0)
+  {
+    FlushHeatmap_Tint((uint16_t *)gfxdisplay->getFramebuffer(), screen_w, &job->area);
+  }
+  if (job->last)
+  {
+    gfxdisplay->flush();
+  }
+}
+
+void my_disp_flush_async(lv_display_t *disp, const lv_area_t *area, uint8_t * px_map)
+{
+  uint32_t flush_start = PerfMonitor_Begin();
+  flush_job_t job = { *area, px_map, lv_display_get_rotation(disp), lv_display_flush_is_last(disp) };
+  // LVGL has waited for the previous area, so this does not block
+  FlushPipe_Acquire();
+  // Recorded before the worker can tint from it
+  FlushHeatmap_Record(disp, area);
+  FlushPipe_Submit(&job);
+  PerfMonitor_End(PERF_PHASE_FLUSH, flush_start);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHES, 1);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHED_PX, lv_area_get_size(area));
+  PerfMonitor_Count(PERF_COUNTER_COPIED_BYTES, lv_area_get_size(area) * BYTE_PER_PIXEL);
+}
+
+void lv_screen_flush_drain(void)
+{
+  FlushPipe_Drain();
+}
+
+/* Called by LVGL only while a flush is outstanding */
+static void my_disp_flush_wait(lv_display_t *disp)
+{
+  FlushPipe_Wait();
+}
+
+// The worker is only started the first time double-partial mode is selected
+static bool async_flush_start(void)
+{
+  if (FlushPipe_IsStarted()) return true;
+  if (!FlushPipe_Start(flush_sink, BYTE_PER_PIXEL))
+  {
+    Serial.println("Display: failed to start the flush worker");
+    return false;
+  }
+  return true;
+}
+
+// =================================================================
+// --- L8: one byte per pixel, expanded through a palette ---
+// =================================================================
+
+/* LVGL renders luminance into an SRAM strip (partial) or a PSRAM frame
+ * (direct); each byte is looked up in l8_lut on the way into the panel
+ * framebuffer. Rotation 0 only. */
+void my_disp_flush_l8(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+  uint32_t flush_start = PerfMonitor_Begin();
+  int32_t w = lv_area_get_width(area);
+  uint32_t src_stride = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_L8);
+  if (!l8_lines)
+  {
+    // Direct: px_map is the whole frame
+    src_stride = lv_draw_buf_width_to_stride(screen_w, LV_COLOR_FORMAT_L8);
+    px_map += area->y1 * src_stride + area->x1;
+  }
+  uint16_t * fb = (uint16_t *)gfxdisplay->getFramebuffer() + area->y1 * screen_w + area->x1;
+
+  // Recorded before the tint, as in the other flush callbacks
+  FlushHeatmap_Record(disp, area);
+
+  for (int32_t y = area->y1; y <= area->y2; y++)
+  {
+    for (int32_t x = 0; x < w; x++)
+    {
+      fb[x] = l8_lut[px_map[x]];
+    }
+    px_map += src_stride;
+    fb += screen_w;
+  }
+  FlushHeatmap_Tint((uint16_t *)gfxdisplay->getFramebuffer(), screen_w, area);
+
+  if (lv_display_flush_is_last(disp))
+  {
+    gfxdisplay->flush();
+  }
+  PerfMonitor_End(PERF_PHASE_FLUSH, flush_start);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHES, 1);
+  PerfMonitor_Count(PERF_COUNTER_FLUSHED_PX, lv_area_get_size(area));
+  PerfMonitor_Count(PERF_COUNTER_COPIED_BYTES, lv_area_get_size(area) * BYTE_PER_PIXEL);
+  lv_disp_flush_ready(disp);
+}
+
+// Palette for the next flushes; what is already on the panel was expanded with the
+// old one, so the whole screen is redrawn
+void lv_screen_set_l8_palette(const lv_color_t * colors)
+{
+  for (uint32_t i = 0; i < 256; i++)
+  {
+    l8_lut[i] = lv_color_to_u16(colors[i]);
+  }
+  if (l8_active)
+  {
+    lv_obj_invalidate(lv_screen_active());
+  }
+}
+
+// L8 buffer in place of a mode's RGB565 one, half its size: same lines at one byte per pixel.
+//   partial          9.6 KB SRAM  ->  4.8 KB SRAM strip (PARTIAL_LINES)
+//   double-partial  76.8 KB SRAM  -> 38.4 KB SRAM strip (2 * ASYNC_FLUSH_LINES, flushed synchronously)
+//   direct         460.8 KB PSRAM -> 230.4 KB PSRAM frame
+//   zero-copy      renders into the 460.8 KB panel framebuffer -> 230.4 KB PSRAM frame, no SRAM
+static uint32_t l8_lines_for(display_mode_t mode)
+{
+  switch (mode)
+  {
+    case DISPLAY_MODE_PARTIAL:
+      return PARTIAL_LINES;
+    case DISPLAY_MODE_DOUBLE_PARTIAL:
+      return 2 * ASYNC_FLUSH_LINES;
+    default:
+      return 0;
+  }
+}
+
+static void l8_release(void)
+{
+  heap_caps_free(l8_buf);
+  l8_buf = NULL;
+  l8_active = false;
+  lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+}
+
+bool lv_screen_set_l8(bool enable)
+{
+  if (!disp || enable == l8_active) return true;
+
+  if (!enable)
+  {
+    l8_release();
+    current_mode = DISPLAY_MODE_MAX; // Buffers are gone, force set_mode to allocate again
+    return lv_screen_set_mode(l8_return_mode, false);
+  }
+
+  if (lv_display_get_rotation(disp) != LV_DISPLAY_ROTATION_0) return false;
+
+  FlushPipe_Drain();
+  lv_display_flush_ready(disp);
+
+  // Give the RGB565 buffers back first, that is where the saving comes from
+  l8_return_mode = current_mode < DISPLAY_MODE_MAX ? current_mode : DEFAULT_DISPLAY_MODE;
+  free_draw_buffers();
+  current_mode = DISPLAY_MODE_MAX;
+
+  l8_lines = l8_lines_for(l8_return_mode);
+  if (l8_lines)
+  {
+    uint32_t size = screen_w * l8_lines;
+    uint32_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (size > free_internal || !sram_margin_ok(free_internal - size) ||
+        !(l8_buf = (uint8_t *)heap_caps_aligned_alloc(4, size, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL)))
+    {
+      Serial.println("Display: L8 strip leaves too little SRAM, using a PSRAM frame");
+      l8_lines = 0;
+    }
+  }
+  if (!l8_lines)
+  {
+    l8_buf = (uint8_t *)heap_caps_aligned_alloc(4, screen_w * screen_h, MALLOC_CAP_SPIRAM);
+  }
+  if (!l8_buf)
+  {
+    Serial.println("Display: not enough memory for L8 mode");
+    lv_screen_set_mode(l8_return_mode, false);
+    return false;
+  }
+
+  lv_display_set_color_format(disp, LV_COLOR_FORMAT_L8);
+  lv_display_set_flush_wait_cb(disp, NULL);
+  lv_display_set_flush_cb(disp, my_disp_flush_l8);
+  if (l8_lines)
+  {
+    lv_display_set_buffers(disp, l8_buf, NULL, screen_w * l8_lines, LV_DISPLAY_RENDER_MODE_PARTIAL);
+  }
+  else
+  {
+    lv_display_set_buffers(disp, l8_buf, NULL, screen_w * screen_h, LV_DISPLAY_RENDER_MODE_DIRECT);
+  }
+  l8_active = true;
+  lv_obj_invalidate(lv_screen_active());
+  return true;
+}
+
+bool lv_screen_is_l8(void)
+{
+  return l8_active;
+}
+
+// =================================================================
+// --- Mode switching ---
+// =================================================================
+
+static void free_draw_buffers(void)
+{
+  heap_caps_free(draw_buf_1);
+  heap_caps_free(draw_buf_2);
+  draw_buf_1 = NULL;
+  draw_buf_2 = NULL;
+}
+
+// Allocate the draw buffers a mode needs, false if they do not fit
+static bool alloc_draw_buffers(display_mode_t mode)
+{
+  uint32_t strip_size;
+  switch (mode)
+  {
+    case DISPLAY_MODE_DIRECT:
+      draw_buf_1 = (uint8_t *)heap_caps_aligned_alloc(4, screen_w * screen_h * BYTE_PER_PIXEL, MALLOC_CAP_SPIRAM);
+      return draw_buf_1 != NULL;
+    case DISPLAY_MODE_ZERO_COPY:
+      return true;
+    case DISPLAY_MODE_PARTIAL:
+      draw_buf_1 = (uint8_t *)heap_caps_aligned_alloc(4, screen_w * PARTIAL_LINES * BYTE_PER_PIXEL, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+      return draw_buf_1 != NULL;
+    case DISPLAY_MODE_DOUBLE_PARTIAL:
+      strip_size = screen_w * ASYNC_FLUSH_LINES * BYTE_PER_PIXEL;
+      draw_buf_1 = (uint8_t *)heap_caps_aligned_alloc(4, strip_size, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+      draw_buf_2 = (uint8_t *)heap_caps_aligned_alloc(4, strip_size, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+      return draw_buf_1 != NULL && draw_buf_2 != NULL;
+    default:
+      return false;
+  }
+}
+
+bool lv_screen_set_mode(display_mode_t mode, bool persist)
+{
+  if (!disp || mode >= DISPLAY_MODE_MAX) return false;
+  // The panel framebuffer is not rotated, LVGL would have to render into it rotated
+  if (mode == DISPLAY_MODE_ZERO_COPY && lv_display_get_rotation(disp) != LV_DISPLAY_ROTATION_0) return false;
+  if (mode == DISPLAY_MODE_DOUBLE_PARTIAL && !async_flush_start()) return false;
+
+  // The worker may still be reading the old buffers
+  FlushPipe_Drain();
+  lv_display_flush_ready(disp);
+
+  if (l8_active)
+  {
+    l8_release();
+  }
+
+  if (mode != current_mode)
+  {
+    free_draw_buffers();
+    if (!alloc_draw_buffers(mode))
+    {
+      Serial.printf("Display: not enough memory for %s mode\n", mode_names[mode]);
+      free_draw_buffers();
+      // The old buffers are gone, so restore the previous mode or fall back to direct
+      display_mode_t fallback = current_mode < DISPLAY_MODE_MAX ? current_mode : DEFAULT_DISPLAY_MODE;
+      if (fallback == mode || !alloc_draw_buffers(fallback))
+      {
+        free_draw_buffers();
+        if (lv_display_get_rotation(disp) != LV_DISPLAY_ROTATION_0)
+        {
+          // Zero-copy cannot render rotated; LVGL must not touch the freed buffers either
+          Serial.println("Display: no render mode fits, rendering paused until one can be set");
+          current_mode = DISPLAY_MODE_MAX;
+          if (!draw_buffers_lost && !render_suspended) render_pause(true);
+          draw_buffers_lost = true;
+          return false;
+        }
+        fallback = DISPLAY_MODE_ZERO_COPY; // Needs no buffer at all
+      }
+      mode = fallback;
+      persist = false;
+    }
+  }
+
+  switch (mode)
+  {
+    case DISPLAY_MODE_DIRECT:
+      lv_display_set_flush_wait_cb(disp, NULL);
+      lv_display_set_flush_cb(disp, my_disp_flush_direct);
+      lv_display_set_buffers(disp, draw_buf_1, NULL, screen_w * screen_h * BYTE_PER_PIXEL, LV_DISPLAY_RENDER_MODE_DIRECT);
+      break;
+    case DISPLAY_MODE_ZERO_COPY:
+      lv_display_set_flush_wait_cb(disp, NULL);
+      lv_display_set_flush_cb(disp, my_disp_flush_zero_copy);
+      lv_display_set_buffers(disp, gfxdisplay->getFramebuffer(), NULL, screen_w * screen_h * BYTE_PER_PIXEL, LV_DISPLAY_RENDER_MODE_DIRECT);
+      break;
+    case DISPLAY_MODE_PARTIAL:
+      lv_display_set_flush_wait_cb(disp, NULL);
+      lv_display_set_flush_cb(disp, my_disp_flush_simple);
+      lv_display_set_buffers(disp, draw_buf_1, NULL, screen_w * PARTIAL_LINES * BYTE_PER_PIXEL, LV_DISPLAY_RENDER_MODE_PARTIAL);
+      break;
+    case DISPLAY_MODE_DOUBLE_PARTIAL:
+      lv_display_set_flush_cb(disp, my_disp_flush_async);
+      lv_display_set_flush_wait_cb(disp, my_disp_flush_wait);
+      lv_display_set_buffers(disp, draw_buf_1, draw_buf_2, screen_w * ASYNC_FLUSH_LINES * BYTE_PER_PIXEL, LV_DISPLAY_RENDER_MODE_PARTIAL);
+      break;
+    default:
+      break;
+  }
+  current_mode = mode;
+  if (draw_buffers_lost)
+  {
+    draw_buffers_lost = false;
+    if (!render_suspended) render_pause(false);
+  }
+
+  // Direct modes only redraw dirty areas, a new buffer needs one full frame first
+  lv_obj_invalidate(lv_screen_active());
+
+  if (persist)
+  {
+    display_prefs.putUChar("mode", mode);
+  }
+  return true;
+}
+
+display_mode_t lv_screen_get_mode(void)
+{
+  return current_mode;
+}
+
+const char * lv_screen_mode_name(display_mode_t mode)
+{
+  if (mode >= DISPLAY_MODE_MAX) return l8_active ? "l8" : "unknown";
+  return mode_names[mode];
+}
+
+bool lv_screen_has_saved_mode(void)
+{
+  return display_prefs.isKey("mode");
+}
+
+// =================================================================
+// --- SRAM margin ---
+// =================================================================
+
+// Internal SRAM held by the current mode's draw buffers
+static uint32_t draw_buffers_internal(void)
+{
+  if (l8_active) return screen_w * l8_lines;
+  switch (current_mode)
+  {
+    case DISPLAY_MODE_PARTIAL:
+      return screen_w * PARTIAL_LINES * BYTE_PER_PIXEL;
+    case DISPLAY_MODE_DOUBLE_PARTIAL:
+      return 2 * screen_w * ASYNC_FLUSH_LINES * BYTE_PER_PIXEL;
+    default:
+      return 0;
+  }
+}
+
+// Whether the current mode still leaves TUNE_MIN_FREE_INTERNAL once the network is up
+static bool sram_margin_ok(uint32_t free_internal)
+{
+  uint32_t reserve = network_up ? 0 : sram_reserve;
+  return free_internal >= reserve + TUNE_MIN_FREE_INTERNAL;
+}
+
+// Back to the PSRAM-only default when the margin is gone
+static void sram_fallback(const char * when, bool persist)
+{
+  Serial.printf("Display: %s mode leaves too little SRAM %s, using %s\n",
+                lv_screen_mode_name(current_mode), when, mode_names[DEFAULT_DISPLAY_MODE]);
+  lv_screen_set_mode(DEFAULT_DISPLAY_MODE, persist);
+}
+
+void lv_screen_network_up(void)
+{
+  uint32_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  if (sram_baseline)
+  {
+    // WiFi first, MQTT later: the first measurement of a boot replaces the
+    // saved one, later ones can only grow it
+    int32_t used = (int32_t)(sram_baseline - (free_internal + draw_buffers_internal()));
+    if (used > 0 && (!network_up || (uint32_t)used > sram_reserve))
+    {
+      sram_reserve = used;
+      display_prefs.putUInt("sram_reserve", sram_reserve);
+      Serial.printf("Display: %u bytes of SRAM taken since boot, reserved for the next tune\n", sram_reserve);
+    }
+  }
+  network_up = true;
+
+  if (draw_buffers_internal() && !sram_margin_ok(free_internal))
+  {
+    sram_fallback("with the network up", true);
+  }
+}
+
+// =================================================================
+// --- Auto-tuner ---
+// =================================================================
+
+// Average time of one synchronous refresh of area, or of the whole screen if NULL
+static uint32_t tune_measure(const lv_area_t * area, int frames)
+{
+  uint32_t total = 0;
+  for (int i = 0; i < frames; i++)
+  {
+    if (area)
+    {
+      lv_obj_invalidate_area(lv_screen_active(), area);
+    }
+    else
+    {
+      lv_obj_invalidate(lv_screen_active());
+    }
+    uint32_t start = micros();
+    lv_refr_now(disp);
+    FlushPipe_Drain();
+    total += micros() - start;
+  }
+  return total / frames;
+}
+
+display_mode_t lv_screen_autotune(void)
+{
+  display_mode_t best = DISPLAY_MODE_MAX;
+  uint32_t best_score = UINT32_MAX;
+
+  lv_area_t small;
+  small.x1 = (screen_w - TUNE_SMALL_SIZE) / 2;
+  small.y1 = (screen_h - TUNE_SMALL_SIZE) / 2;
+  small.x2 = small.x1 + TUNE_SMALL_SIZE - 1;
+  small.y2 = small.y1 + TUNE_SMALL_SIZE - 1;
+
+  Serial.printf("Display: auto-tuning render mode, keeping %u bytes of SRAM free%s\n",
+                TUNE_MIN_FREE_INTERNAL + (network_up ? 0 : sram_reserve),
+                network_up ? "" : " (network not up yet)");
+  for (int m = 0; m < DISPLAY_MODE_MAX; m++)
+  {
+    display_mode_t mode = (display_mode_t)m;
+    if (!lv_screen_set_mode(mode, false) || current_mode != mode)
+    {
+      Serial.printf("  %-14s unavailable\n", mode_names[m]);
+      continue;
+    }
+
+    // The first frame after a switch is a full redraw anyway
+    lv_refr_now(disp);
+    FlushPipe_Drain();
+
+    uint32_t full_us = tune_measure(NULL, TUNE_FULL_FRAMES);
+    uint32_t small_us = tune_measure(&small, TUNE_SMALL_FRAMES);
+    uint32_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t score = full_us + TUNE_SMALL_WEIGHT * small_us;
+    bool fits = sram_margin_ok(free_internal);
+
+    Serial.printf("  %-14s full %6u us, small %5u us, internal free %6u, score %u%s\n",
+                  mode_names[m], full_us, small_us, free_internal, score, fits ? "" : " (too little SRAM left)");
+    if (fits && score < best_score)
+    {
+      best_score = score;
+      best = mode;
+    }
+  }
+
+  if (best == DISPLAY_MODE_MAX) best = DEFAULT_DISPLAY_MODE;
+  lv_screen_set_mode(best, true);
+  Serial.printf("Display: using %s mode\n", mode_names[current_mode]);
+  return current_mode;
+}
+
+// =================================================================
+// --- Area coalescing ---
+// =================================================================
+
+void lv_screen_set_area_coalescer(area_coalesce_cb_t cb)
+{
+  area_coalesce_cb = cb;
+}
+
+// Average refresh time of count separate size x size areas spread over the screen
+static uint32_t calibrate_measure(int32_t size, int32_t count)
+{
+  const int frames = 8;
+  int32_t step = screen_w / count;
+  uint32_t total = 0;
+  for (int f = 0; f < frames; f++)
+  {
+    for (int32_t i = 0; i < count; i++)
+    {
+      lv_area_t a;
+      a.x1 = i * step;
+      a.y1 = (i % 2) * (screen_h / 2);
+      a.x2 = a.x1 + size - 1;
+      a.y2 = a.y1 + size - 1;
+      lv_obj_invalidate_area(lv_screen_active(), &a);
+    }
+    uint32_t start = micros();
+    lv_refr_now(disp);
+    FlushPipe_Drain();
+    total += micros() - start;
+  }
+  return total / frames;
+}
+
+// Fit refresh time = overhead * areas + px_cost * pixels in the current render mode
+void lv_screen_calibrate_coalescing(void)
+{
+  const int32_t small = 8, big = 128, many = 16;
+  area_coalesce_cb_t saved = area_coalesce_cb;
+  area_coalesce_cb = NULL;
+
+  uint32_t t_one = calibrate_measure(small, 1);
+  uint32_t t_many = calibrate_measure(small, many);
+  uint32_t t_big = calibrate_measure(big, 1);
+  area_coalesce_cb = saved;
+
+  area_cost_model_t model;
+  int64_t px_cost_ns = (int64_t)(t_big - LV_MIN(t_one, t_big)) * 1000 / (big * big - small * small);
+  int64_t overhead_ns = (int64_t)(t_many - LV_MIN(t_one, t_many)) * 1000 / (many - 1) - px_cost_ns * small * small;
+  model.px_cost_ns = LV_MAX(px_cost_ns, 1);
+  model.area_overhead_ns = LV_MAX(overhead_ns, 0);
+  AreaCoalesce_SetModel(&model);
+
+  Serial.printf("Coalesce: 1x%d^2 %u us, %dx%d^2 %u us, 1x%d^2 %u us -> %u ns/area, %u ns/px (%s mode)\n",
+                small, t_one, many, small, t_many, big, t_big,
+                model.area_overhead_ns, model.px_cost_ns, lv_screen_mode_name(current_mode));
+}
+
+// =================================================================
+// --- VSYNC pacing ---
+// =================================================================
+
+static void IRAM_ATTR vsync_isr(void * arg)
+{
+  VsyncPacer_OnVsync(&vsync_pacer);
+}
+
+bool lv_screen_attach_vsync(int pin)
+{
+  // The pin is driven by the LCD peripheral; enabling its input lets the GPIO block see the edges
+  gpio_input_enable((gpio_num_t)pin);
+  gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_POSEDGE);
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;
+  if (gpio_isr_handler_add((gpio_num_t)pin, vsync_isr, NULL) != ESP_OK) return false;
+  gpio_intr_enable((gpio_num_t)pin);
+  vsync_pin = pin;
+  return lv_screen_set_vsync_divider(VSYNC_DEFAULT_DIVIDER);
+}
+
+bool lv_screen_set_vsync_divider(uint8_t divider)
+{
+  if (!disp || divider > VSYNC_MAX_DIVIDER) return false;
+  if (divider && vsync_pin < 0) return false;
+
+  // Keep LVGL's refresh timer, but stop it from firing on its own while paced
+  lv_timer_t * refr_timer = lv_display_get_refr_timer(disp);
+  lv_timer_set_period(refr_timer, divider ? UINT32_MAX / 2 : LV_DEF_REFR_PERIOD);
+  VsyncPacer_SetDivider(&vsync_pacer, divider);
+  VsyncPacer_ResetStats(&vsync_pacer);
+  return true;
+}
+
+uint8_t lv_screen_get_vsync_divider(void)
+{
+  return vsync_pacer.divider;
+}
+
+void lv_screen_vsync_poll(void)
+{
+  if (render_suspended || draw_buffers_lost) return;
+  if (VsyncPacer_Poll(&vsync_pacer))
+  {
+    lv_lock();
+    lv_display_refr_timer(lv_display_get_refr_timer(disp));
+    lv_unlock();
+  }
+}
+
+// =================================================================
+// --- Render suspension ---
+// =================================================================
+
+static void render_pause(bool pause)
+{
+  lv_timer_t * refr_timer = lv_display_get_refr_timer(disp);
+  if (pause)
+  {
+    // Every invalidation resumes the refresh timer, so stop them at the source.
+    // Whatever changes meanwhile is not tracked, hence the full redraw on resume.
+    FlushPipe_Drain();
+    lv_display_enable_invalidation(disp, false);
+    lv_timer_pause(refr_timer);
+    return;
+  }
+
+  lv_display_enable_invalidation(disp, true);
+  lv_timer_resume(refr_timer);
+  lv_obj_invalidate(lv_display_get_screen_active(disp));
+  lv_obj_invalidate(lv_display_get_layer_top(disp));
+  if (!vsync_pacer.divider)
+  {
+    lv_timer_ready(refr_timer);
+  }
+  else
+  {
+    // Fire on the next VSYNC, and don't count the suspended scan-outs as duplicated frames
+    vsync_pacer.slot_vsync = vsync_pacer.vsync_count - (vsync_pacer.divider - 1);
+  }
+}
+
+void lv_screen_set_suspended(bool suspended)
+{
+  if (!disp || suspended == render_suspended) return;
+  render_suspended = suspended;
+  if (!draw_buffers_lost) render_pause(suspended);
+}
+
+bool lv_screen_is_suspended(void)
+{
+  return render_suspended;
+}
+
 void lv_screen_init(void * gfx, word W, word H)
 {
   gfxdisplay = (Arduino_RGB_Display*) gfx;
+  screen_w = W;
+  screen_h = H;
 
-  static uint8_t * sbuf1_1 = (uint8_t *)heap_caps_aligned_alloc(4, W * 10 * BYTE_PER_PIXEL, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
-  static uint8_t * sbuf1_2 = NULL;
-  //sbuf1_2 = (uint8_t *)heap_caps_aligned_alloc(4, W * 10 * BYTE_PER_PIXEL, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+  display_prefs.begin("display_cfg", false);
+  display_mode_t mode = (display_mode_t)display_prefs.getUChar("mode", DEFAULT_DISPLAY_MODE);
+  sram_reserve = display_prefs.getUInt("sram_reserve", TUNE_SRAM_RESERVE);
 
   disp = lv_display_create(W, H);
-  lv_display_set_flush_cb(disp, my_disp_flush_simple);
-  
-  lv_display_set_buffers(disp, sbuf1_1, sbuf1_2, W * 10 * BYTE_PER_PIXEL, LV_DISP_RENDER_MODE_PARTIAL);
   lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+  render_timing_attach(disp);
+  VsyncPacer_Init(&vsync_pacer, 0);
+  // Plain luminance until someone sets a palette
+  for (uint32_t i = 0; i < 256; i++)
+  {
+    l8_lut[i] = lv_color_to_u16(lv_color_make(i, i, i));
+  }
+
+  if (!lv_screen_set_mode(mode, false))
+  {
+    lv_screen_set_mode(DEFAULT_DISPLAY_MODE, false);
+  }
+
+  // The saved mode was tuned on another boot; it is kept saved, only not used
+  uint32_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  if (draw_buffers_internal() && !sram_margin_ok(free_internal))
+  {
+    sram_fallback("for the network", false);
+    free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  }
+  sram_baseline = free_internal + draw_buffers_internal();
 }
 
-#endif
+void lv_screen_print_stats(void)
+{
+  Serial.printf("Display: %s mode\n", lv_screen_mode_name(current_mode));
+  if (vsync_pin >= 0)
+  {
+    Serial.printf("VSYNC: %u vsyncs, divider %u%s, %u frames rendered, %u dropped, %u duplicated\n",
+                  vsync_pacer.vsync_count, vsync_pacer.divider, vsync_pacer.divider ? "" : " (LVGL timer)",
+                  vsync_pacer.frames_rendered, vsync_pacer.frames_dropped, vsync_pacer.frames_duplicated);
+    VsyncPacer_ResetStats(&vsync_pacer);
+  }
+  const area_cost_model_t * model = AreaCoalesce_GetModel();
+  Serial.printf("Coalesce: %s, %u ns/area + %u ns/px, areas %u -> %u, px %llu -> %llu\n",
+                area_coalesce_cb ? "on" : "off", model->area_overhead_ns, model->px_cost_ns,
+                coalesce_areas_in, coalesce_areas_out, coalesce_px_in, coalesce_px_out);
+  coalesce_areas_in = coalesce_areas_out = 0;
+  coalesce_px_in = coalesce_px_out = 0;
+
+  if (current_mode != DISPLAY_MODE_DOUBLE_PARTIAL)
+  {
+    Serial.println("Flush: synchronous, see the 'perf' flush histogram");
+    return;
+  }
+
+  flush_pipe_stats_t stats;
+  FlushPipe_GetStats(&stats);
+  uint32_t hidden_permille = FlushPipe_OverlapPermille(&stats);
+  uint32_t busy_permille = stats.window_us ? stats.busy_us * 1000ULL / stats.window_us : 0;
+
+  Serial.printf("Async flush: %u areas, %u frames in %u ms\n", stats.jobs, stats.frames, stats.window_us / 1000);
+  Serial.printf("  copy %.2f MB/s, %.1f frames/s, worker busy %u.%u%%, stall %u us, overlap %u.%u%%\n",
+                stats.busy_us ? (float)stats.bytes / stats.busy_us : 0.0f,
+                stats.window_us ? stats.frames * 1000000.0f / stats.window_us : 0.0f,
+                busy_permille / 10, busy_permille % 10,
+                stats.stall_us, hidden_permille / 10, hidden_permille % 10);
+  FlushPipe_ResetStats();
+}
@@ -4,14 +4,69 @@
 #include <Arduino.h>
 #include <lvgl.h>
 #include <Arduino_GFX_Library.h>
+#include "AreaCoalesce.h"
 
 extern lv_display_t *disp;
 
+// 渲染模式，运行时可切换，选中的模式保存在 NVS
+typedef enum {
+  DISPLAY_MODE_DIRECT,         // Full frame PSRAM buffer, dirty areas copied to the panel
+  DISPLAY_MODE_ZERO_COPY,      // LVGL renders into the panel framebuffer (rotation 0 only)
+  DISPLAY_MODE_PARTIAL,        // One small SRAM strip
+  DISPLAY_MODE_DOUBLE_PARTIAL, // Two larger SRAM strips, flushed by a worker on the other core
+  DISPLAY_MODE_MAX
+} display_mode_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void lv_screen_init(void * gfx, word W, word H);
+void lv_screen_print_stats(void); // Flush pipeline statistics over Serial, restarts the window
+
+// false if the mode is not usable now. If its buffers do not fit either, the previous mode
+// (or zero-copy at rotation 0) is restored; rotated with nothing left, rendering pauses
+// and false is returned until a later call succeeds.
+bool lv_screen_set_mode(display_mode_t mode, bool persist);
+display_mode_t lv_screen_get_mode(void);
+const char * lv_screen_mode_name(display_mode_t mode);
+bool lv_screen_has_saved_mode(void);
+display_mode_t lv_screen_autotune(void); // Measures every mode on the active screen, saves the best
+// Call when WiFi or MQTT connects (from loop()): measures the SRAM they took for the next
+// tune and drops to a PSRAM-only mode if the current one no longer fits
+void lv_screen_network_up(void);
+
+// In double-partial mode a worker on the other core copies areas into the panel
+// framebuffer after the flush callback returns. Call this before reading or
+// changing the framebuffer, gfxdisplay or the heatmap outside of LVGL's flush.
+void lv_screen_flush_drain(void);
+
+// VSYNC pacing: refresh LVGL on every divider-th panel VSYNC instead of its own timer.
+// Call lv_screen_vsync_poll() from loop() after lv_task_handler(); divider 0 goes back to the timer.
+bool lv_screen_attach_vsync(int pin);
+bool lv_screen_set_vsync_divider(uint8_t divider);
+uint8_t lv_screen_get_vsync_divider(void);
+void lv_screen_vsync_poll(void);
+
+// Stops all rendering and flushing (display blanked); resuming redraws the whole screen
+void lv_screen_set_suspended(bool suspended);
+bool lv_screen_is_suspended(void);
+
+// Dirty-area coalescing before render/flush, NULL turns it off (default: AreaCoalesce_CostModel)
+void lv_screen_set_area_coalescer(area_coalesce_cb_t cb);
+void lv_screen_calibrate_coalescing(void); // Measures the cost model in the current render mode
+
+// L8: LVGL renders 1 byte per pixel, expanded to RGB565 through a 256-entry
+// palette on flush (a grey ramp until lv_screen_set_l8_palette()). The buffer is half the one of the mode it
+// replaces: partial 9.6 -> 4.8 KB and double-partial 76.8 -> 38.4 KB of SRAM (same
+// lines, one strip), direct and zero-copy a 230.4 KB PSRAM frame. An SRAM strip that
+// would break the SRAM margin becomes the PSRAM frame too. Meant for dark scenes
+// like WindChime; turning it off restores the previous render mode.
+bool lv_screen_set_l8(bool enable);
+bool lv_screen_is_l8(void);
+// Byte value -> colour. LVGL blends the byte values, so a screen that uses colours
+// must keep them apart itself (WindChimePalette); redraws the screen if L8 is on
+void lv_screen_set_l8_palette(const lv_color_t * colors);
 
 #ifdef __cplusplus
 } /*extern "C"*/
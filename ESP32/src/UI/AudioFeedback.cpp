@@ -73,6 +73,16 @@ void SetAudioVolume(uint8_t volume)
     SaveAudioVolume(volume);
 }
 
+void SetAudioEnabled(bool enabled)
+{
+    audio_enabled = enabled;
+}
+
+bool IsAudioEnabled(void)
+{
+    return audio_enabled;
+}
+
 uint8_t GetAudioVolume(void)
 {
     return current_volume;
@@ -20,6 +20,10 @@ void UpdateAmbientSound(int16_t wind_speed);
 // 设置音量
 void SetAudioVolume(uint8_t volume);
 
+// 临时静音 (不保存，用于基准测试等)
+void SetAudioEnabled(bool enabled);
+bool IsAudioEnabled(void);
+
 // 获取当前音量
 uint8_t GetAudioVolume(void);
 
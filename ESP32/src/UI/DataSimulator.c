@@ -37,6 +37,15 @@ static const char* github_users[] = {
     "dev_guru"
 };
 
+// 随机位置，颜色用数据源默认色 (a = 0)
+static void random_circle_style(circle_style_t* style)
+{
+    memset(style, 0, sizeof(*style));
+    style->x_coord = 40 + rand() % 400;
+    style->y_coord = 40 + rand() % 400;
+    style->radius = 50;
+}
+
 // 定时器回调函数
 static void github_event_callback(lv_timer_t * timer)
 {
@@ -45,6 +54,7 @@ static void github_event_callback(lv_timer_t * timer)
     event.timestamp = lv_tick_get();
     event.intensity = 20 + (rand() % 60);  // 20-80
     event.color_hash = rand();
+    random_circle_style(&event.circle_style);
     
     int repo_idx = rand() % (sizeof(github_repos) / sizeof(github_repos[0]));
     int user_idx = rand() % (sizeof(github_users) / sizeof(github_users[0]));
@@ -62,6 +72,7 @@ static void wiki_event_callback(lv_timer_t * timer)
     event.timestamp = lv_tick_get();
     event.intensity = 15 + (rand() % 50);  // 15-65
     event.color_hash = rand();
+    random_circle_style(&event.circle_style);
     
     int article_idx = rand() % (sizeof(wiki_articles) / sizeof(wiki_articles[0]));
     
@@ -96,6 +107,7 @@ static void weather_update_callback(lv_timer_t * timer)
         event.timestamp = lv_tick_get();
         event.intensity = wind_speed * 2;
         event.color_hash = rand();
+        memset(&event.circle_style, 0, sizeof(event.circle_style)); // 天气事件在中心
         
         snprintf(event.description, sizeof(event.description), 
                  "Wind: %d km/h, Temp: %d°C", wind_speed, temperature);
@@ -0,0 +1,40 @@
+#include "EffectPool.h"
+
+void EffectPoolInit(effect_pool_t * pool, uint16_t * storage, uint16_t capacity)
+{
+    pool->capacity = capacity;
+    pool->free_stack = storage;
+    pool->active = storage + capacity;
+    pool->position = storage + 2 * capacity;
+    EffectPoolReset(pool);
+}
+
+void EffectPoolReset(effect_pool_t * pool)
+{
+    pool->live = 0;
+    pool->free_top = pool->capacity;
+    // Hand out low slot numbers first
+    for (uint16_t i = 0; i < pool->capacity; i++) {
+        pool->free_stack[i] = pool->capacity - 1 - i;
+    }
+}
+
+int32_t EffectPoolAlloc(effect_pool_t * pool)
+{
+    if (pool->free_top == 0) return -1;
+
+    uint16_t slot = pool->free_stack[--pool->free_top];
+    pool->position[slot] = pool->live;
+    pool->active[pool->live++] = slot;
+    return slot;
+}
+
+void EffectPoolRelease(effect_pool_t * pool, uint16_t slot)
+{
+    uint16_t pos = pool->position[slot];
+    uint16_t last = pool->active[--pool->live];
+
+    pool->active[pos] = last;
+    pool->position[last] = pos;
+    pool->free_stack[pool->free_top++] = slot;
+}
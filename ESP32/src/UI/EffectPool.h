@@ -0,0 +1,38 @@
+#ifndef LV_EFFECT_POOL_H
+#define LV_EFFECT_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// 定长效果池：空闲槽位栈 + 活动槽位的紧凑索引表
+// 分配/释放 O(1)，逐帧遍历只与活动数量成正比，而不是容量
+typedef struct {
+    uint16_t capacity;
+    uint16_t live;         // active[] 中的有效数量
+    uint16_t free_top;     // free_stack[] 中的有效数量
+    uint16_t * free_stack;
+    uint16_t * active;     // 活动槽位，紧凑排列
+    uint16_t * position;   // 槽位 -> 在 active[] 中的下标
+} effect_pool_t;
+
+// 池所需的 uint16_t 存储数量
+#define EFFECT_POOL_STORAGE(capacity) (3 * (capacity))
+
+void EffectPoolInit(effect_pool_t * pool, uint16_t * storage, uint16_t capacity);
+void EffectPoolReset(effect_pool_t * pool);
+
+// 返回槽位号，池满时返回 -1
+int32_t EffectPoolAlloc(effect_pool_t * pool);
+
+// 释放槽位：最后一个活动槽位会被移到它的位置，
+// 所以边遍历边释放时请从 live - 1 倒序遍历
+void EffectPoolRelease(effect_pool_t * pool, uint16_t slot);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_EFFECT_POOL_H*/
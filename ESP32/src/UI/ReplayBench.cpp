@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+#include "ReplayBench.h"
+#include "ReplayTrace.h"
+#include "WindChime.h"
+#include "WindChimeConfig.h"
+#include "DataSimulator.h"
+#include "AudioFeedback.h"
+#include "../Core/PerfMonitor.h"
+#include "../Display/lvgldriver.h"
+
+#define BENCH_WIND_SPEED 10
+#define BENCH_TEMPERATURE 20
+
+// 轨迹见 ReplayTrace.h：每次定时器回调前进一帧，负载只取决于种子和帧编号，
+// 主机上的 tests/host/bench_replay 会送入完全相同的事件
+static lv_timer_t * bench_timer = NULL;
+static replay_trace_t bench_trace;
+static uint8_t last_phase = 0;
+static uint32_t last_phase_emitted = 0;
+
+static uint32_t start_free_internal = 0;
+static uint32_t start_free_psram = 0;
+static uint32_t min_free_internal = 0;
+static uint32_t min_free_psram = 0;
+
+static bool restore_simulator = false;
+static bool restore_audio = false;
+
+static void sample_heap(void)
+{
+    uint32_t internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    if (internal < min_free_internal) min_free_internal = internal;
+    if (psram < min_free_psram) min_free_psram = psram;
+}
+
+static void print_report(void)
+{
+    perf_summary_t frame;
+    PerfMonitor_GetSummary(PERF_PHASE_FRAME, &frame);
+    perf_summary_t render;
+    PerfMonitor_GetSummary(PERF_PHASE_RENDER, &render);
+    uint32_t invalidated = PerfMonitor_GetCounter(PERF_COUNTER_INVALIDATED_PX);
+
+    Serial.println("ReplayBench: done");
+    Serial.printf("  seed %u, %u events, %u trace frames, %u frames\n",
+                  bench_trace.seed, bench_trace.emitted, bench_trace.frame, frame.count);
+    Serial.printf("  config: %d particles, %d ripples, %d fps, ring cache %u bytes, %d draw units, %s mode\n",
+                  WINDCHIME_MAX_PARTICLES, WINDCHIME_MAX_RIPPLES, WINDCHIME_ANIMATION_FPS,
+                  (unsigned)WINDCHIME_RING_CACHE_BUDGET, LV_DRAW_SW_DRAW_UNIT_CNT,
+                  lv_screen_mode_name(lv_screen_get_mode()));
+    Serial.printf("  frame cpu us: p50 %u, p95 %u, p99 %u, max %u\n",
+                  frame.p50_us, frame.p95_us, frame.p99_us, frame.max_us);
+    Serial.printf("  render us: p50 %u, p95 %u, p99 %u, max %u\n",
+                  render.p50_us, render.p95_us, render.p99_us, render.max_us);
+    Serial.printf("  invalidated px/frame: %u\n", frame.count ? invalidated / frame.count : 0);
+    Serial.printf("  flushes: %u (%u px)\n",
+                  PerfMonitor_GetCounter(PERF_COUNTER_FLUSHES), PerfMonitor_GetCounter(PERF_COUNTER_FLUSHED_PX));
+    Serial.printf("  peak heap use: internal %u bytes, psram %u bytes\n",
+                  start_free_internal - min_free_internal, start_free_psram - min_free_psram);
+    PerfMonitor_PrintReport();
+}
+
+static void finish(void)
+{
+    lv_timer_delete(bench_timer);
+    bench_timer = NULL;
+
+    print_report();
+
+    SetAudioEnabled(restore_audio);
+    if (restore_simulator) {
+        DataSimulatorStart();
+    }
+}
+
+static void bench_tick(lv_timer_t * timer)
+{
+    sample_heap();
+
+    ReplayTraceStep(&bench_trace);
+    if (bench_trace.phase != last_phase) {
+        Serial.printf("ReplayBench: phase '%s' done, %u events\n",
+                      ReplayTracePhaseName(last_phase), bench_trace.emitted - last_phase_emitted);
+        last_phase = bench_trace.phase;
+        last_phase_emitted = bench_trace.emitted;
+    }
+    if (bench_trace.phase >= ReplayTracePhaseCount()) {
+        finish();
+    }
+}
+
+extern "C" {
+
+void ReplayBenchStart(uint32_t seed)
+{
+    if (bench_timer) {
+        Serial.println("ReplayBench: already running");
+        return;
+    }
+
+    ReplayTraceInit(&bench_trace, seed);
+    last_phase = 0;
+    last_phase_emitted = 0;
+
+    restore_simulator = DataSimulatorIsRunning();
+    restore_audio = IsAudioEnabled();
+    DataSimulatorStop();
+    SetAudioEnabled(false); // 蜂鸣器会阻塞，测试时关闭
+
+    lv_screen_load(windchime_screen);
+    WindChimeUpdateWeather(BENCH_WIND_SPEED, BENCH_TEMPERATURE);
+
+    PerfMonitor_Reset();
+    start_free_internal = min_free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    start_free_psram = min_free_psram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    bench_timer = lv_timer_create(bench_tick, ReplayTraceFrameMs(), NULL);
+    Serial.printf("ReplayBench: started, seed %u\n", seed);
+}
+
+bool ReplayBenchIsRunning(void)
+{
+    return bench_timer != NULL;
+}
+
+} // extern "C"
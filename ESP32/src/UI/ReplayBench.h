@@ -0,0 +1,22 @@
+#ifndef REPLAY_BENCH_H
+#define REPLAY_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 风铃回放基准测试：用固定种子生成的事件轨迹 (ReplayTrace.h，按帧编号) 驱动 WindChime 屏幕，
+// 与主机上的 tests/host/bench_replay 负载相同，// 结束后在串口输出每帧 CPU 时间、失效面积、flush 次数和内存峰值。
+// 运行期间暂停数据模拟器并静音，结束后恢复。
+
+// 开始回放 (已在运行则忽略)
+void ReplayBenchStart(uint32_t seed);
+bool ReplayBenchIsRunning(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*REPLAY_BENCH_H*/
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ReplayTrace.h"
+#include "WindChimeConfig.h"
+
+#define TRACE_FRAME_MS (1000 / WINDCHIME_ANIMATION_FPS)
+#define TRACE_JITTER 32 // 热点周围的随机偏移(px)
+
+typedef struct {
+    const char * name;
+    uint32_t duration_ms;    // 换算成帧数，与帧率无关的时长
+    uint16_t events_per_sec;
+} trace_phase_t;
+
+static const trace_phase_t trace_phases[] = {
+    {"quiet",  5000,   2},
+    {"steady", 5000,  20},
+    {"burst",  5000, 200},
+    {"drain",  8000,   0},
+};
+static const uint8_t trace_phase_count = sizeof(trace_phases) / sizeof(trace_phases[0]);
+
+// xorshift32，与 rand() 分开，轨迹不受其他模块取随机数的影响
+static uint32_t trace_rand(replay_trace_t * trace)
+{
+    trace->rng ^= trace->rng << 13;
+    trace->rng ^= trace->rng >> 17;
+    trace->rng ^= trace->rng << 5;
+    return trace->rng;
+}
+
+static void emit_event(replay_trace_t * trace)
+{
+    wind_chime_event_t event;
+    memset(&event, 0, sizeof(event));
+
+    uint32_t r = trace_rand(trace) % 100;
+    event.source = r < 45 ? DATA_SOURCE_GITHUB : (r < 90 ? DATA_SOURCE_WIKIPEDIA : DATA_SOURCE_WEATHER);
+    event.timestamp = trace->frame * TRACE_FRAME_MS;
+    event.intensity = 10 + trace_rand(trace) % 80;
+
+    int h = trace_rand(trace) % REPLAY_TRACE_HOTSPOTS;
+    event.circle_style.x_coord = trace->hotspot_x[h] + (int)(trace_rand(trace) % (2 * TRACE_JITTER)) - TRACE_JITTER;
+    event.circle_style.y_coord = trace->hotspot_y[h] + (int)(trace_rand(trace) % (2 * TRACE_JITTER)) - TRACE_JITTER;
+    event.circle_style.radius = 50;
+
+    snprintf(event.description, sizeof(event.description), "bench event %u", (unsigned)trace->emitted);
+    WindChimeAddEvent(&event);
+    trace->emitted++;
+}
+
+void ReplayTraceInit(replay_trace_t * trace, uint32_t seed)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->seed = seed;
+    trace->rng = seed ? seed : 1;
+    srand(seed);
+    for (int i = 0; i < REPLAY_TRACE_HOTSPOTS; i++) {
+        trace->hotspot_x[i] = 60 + trace_rand(trace) % 360;
+        trace->hotspot_y[i] = 60 + trace_rand(trace) % 360;
+    }
+}
+
+bool ReplayTraceStep(replay_trace_t * trace)
+{
+    if (trace->phase >= trace_phase_count) return false;
+
+    const trace_phase_t * phase = &trace_phases[trace->phase];
+    trace->phase_frame++;
+    // Events due by the end of this frame, so the rate is exact over the phase
+    uint32_t due = (uint32_t)((uint64_t)trace->phase_frame * TRACE_FRAME_MS * phase->events_per_sec / 1000);
+    while (trace->phase_emitted < due) {
+        emit_event(trace);
+        trace->phase_emitted++;
+    }
+    trace->frame++;
+
+    if (trace->phase_frame >= ReplayTracePhaseFrames(trace->phase)) {
+        trace->phase++;
+        trace->phase_frame = 0;
+        trace->phase_emitted = 0;
+    }
+    return true;
+}
+
+uint8_t ReplayTracePhaseCount(void)
+{
+    return trace_phase_count;
+}
+
+const char * ReplayTracePhaseName(uint8_t phase)
+{
+    return phase < trace_phase_count ? trace_phases[phase].name : "end";
+}
+
+uint32_t ReplayTracePhaseFrames(uint8_t phase)
+{
+    return phase < trace_phase_count ? trace_phases[phase].duration_ms / TRACE_FRAME_MS : 0;
+}
+
+uint32_t ReplayTraceFrameMs(void)
+{
+    return TRACE_FRAME_MS;
+}
@@ -0,0 +1,44 @@
+#ifndef REPLAY_TRACE_H
+#define REPLAY_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+#include "WindChime.h"
+
+// 回放基准的事件轨迹：按帧编号而不是经过的时间生成，同一种子在设备和主机上
+// 每一帧送入的事件完全相同。分段：quiet / steady / burst，各有固定帧数和事件率，
+// 最后 drain 段不再产生事件，等效果消失。事件集中在几个热点附近，合并逻辑也会被覆盖。
+// 一帧即 WindChime 的一个动画帧 (1000 / WINDCHIME_ANIMATION_FPS 毫秒)。
+#define REPLAY_TRACE_HOTSPOTS 6
+
+typedef struct {
+    uint32_t seed;
+    uint32_t rng;
+    uint8_t phase;           // 当前分段，等于 ReplayTracePhaseCount() 时轨迹结束
+    uint32_t phase_frame;    // 当前分段已经过的帧数
+    uint32_t phase_emitted;  // 当前分段已送入的事件
+    uint32_t frame;          // 轨迹已经过的帧数
+    uint32_t emitted;        // 已送入的事件总数
+    int16_t hotspot_x[REPLAY_TRACE_HOTSPOTS];
+    int16_t hotspot_y[REPLAY_TRACE_HOTSPOTS];
+} replay_trace_t;
+
+// 同时用种子调用 srand()：粒子方向/寿命也用 rand()
+void ReplayTraceInit(replay_trace_t * trace, uint32_t seed);
+
+// 送入下一帧的事件 (WindChimeAddEvent)，前进一帧；轨迹已结束时返回 false
+bool ReplayTraceStep(replay_trace_t * trace);
+
+uint8_t ReplayTracePhaseCount(void);
+const char * ReplayTracePhaseName(uint8_t phase);
+uint32_t ReplayTracePhaseFrames(uint8_t phase);
+uint32_t ReplayTraceFrameMs(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*REPLAY_TRACE_H*/
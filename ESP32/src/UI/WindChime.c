@@ -5,6 +5,11 @@
 #include "WindChimeConfig.h"
 #include "Screenbase.h"
 #include "AudioFeedback.h"
+#include "WindChimeRender.h"
+#include "WindChimePalette.h"
+#include "EffectPool.h"
+#include "WindChimeParticle.h"
+#include "../Core/PerfMonitor.h"
 
 // --- Configuration Constants ---
 #define MAX_PARTICLES WINDCHIME_MAX_PARTICLES
@@ -15,55 +20,111 @@
 #define CANVAS_HEIGHT 480
 #define CENTER_X (CANVAS_WIDTH / 2)
 #define CENTER_Y (CANVAS_HEIGHT / 2)
-#define PARTICLE_GRAVITY 0.25f // Gentle gravity for a more floaty effect
+#define PARTICLE_LIFE_MIN 80
+#define PARTICLE_LIFE_RANGE 60 // Longer life for more visible effect
+#define PARTICLE_LIFE_MAX (PARTICLE_LIFE_MIN + PARTICLE_LIFE_RANGE - 1)
+
+#define RIPPLE_BORDER_WIDTH 2
 
 // --- Data Structures ---
-// --- MODIFICATION START: Using float for smoother physics ---
+// Particles live in a structure of arrays with Q16.16 positions and
+// velocities, so the per-frame integrate/fade loops stay tight and free of
+// float math and divisions. Slots are handed out by particle_pool;
+// life == 0 marks a particle that died this frame and still has to be
+// erased from the canvas before its slot is released.
 typedef struct {
-    bool active;
-    float x;
-    float y;
-    float vx;
-    float vy;
-    int16_t life;
-    int16_t max_life;
-    lv_color_t color;
-    uint8_t size;
-} particle_t;
-// --- MODIFICATION END ---
+    int32_t x[MAX_PARTICLES];
+    int32_t y[MAX_PARTICLES];
+    int32_t vx[MAX_PARTICLES];
+    int32_t vy[MAX_PARTICLES];
+    int16_t life[MAX_PARTICLES];
+    uint16_t fade[MAX_PARTICLES];   // Alpha lost per life frame, Q8.8
+    lv_color_t color[MAX_PARTICLES];
+    uint8_t size[MAX_PARTICLES];
+    int16_t drawn_x[MAX_PARTICLES]; // Footprint left on the canvas last frame,
+    int16_t drawn_y[MAX_PARTICLES]; // erased before the next one is drawn
+    uint8_t drawn_size[MAX_PARTICLES];
+} particle_store_t;
 
 typedef struct {
-    bool active;
+    bool active;           // false: finished, released after its last erase
     int16_t x;
     int16_t y;
     uint16_t radius;
     uint16_t max_radius;
     uint8_t alpha;
     lv_color_t color;
+    uint16_t drawn_radius; // Ring left on the canvas last frame, 0: none
 } ripple_t;
 
+// What a log row shows, kept so the row can be rewritten in other colours
+typedef struct {
+    data_source_t source;
+    uint16_t count;        // 0: empty or the placeholder
+    char description[64];
+} log_row_t;
+
+
+// An event waiting for the next animation frame; events from the same
+// source landing close together are folded into one with summed intensity
+typedef struct {
+    wind_chime_event_t event;
+    int16_t x;
+    int16_t y;
+    lv_color_t color;
+    uint16_t count;
+} pending_event_t;
+
 
 // --- Global Variables ---
 lv_obj_t * windchime_screen = NULL;
 static lv_obj_t * main_canvas = NULL;
+static uint32_t main_canvas_index = 0; // Place among the screen's children in RGB rendering
+static lv_obj_t * settings_icon = NULL;
 static lv_obj_t * center_orb = NULL;
 // --- MODIFICATION START: Replaced volume bar with an arc ---
 static lv_obj_t * volume_arc = NULL;
 // --- MODIFICATION END ---
-static lv_obj_t * event_log_label = NULL;
+// Event log: one single-line label per row, reused as a ring. A new event
+// rewrites only the oldest label and the rows are moved, so the other lines
+// are never re-parsed or re-measured.
+static lv_obj_t * event_log_box = NULL;
+static lv_obj_t * event_log_lines[MAX_LOG_LINES];
+static log_row_t event_log_rows[MAX_LOG_LINES];
+static uint8_t event_log_newest = 0;   // Ring index of the bottom row
+static int32_t event_log_line_height = 0;
 
 // --- Animation & Effect Data ---
-static particle_t particles[MAX_PARTICLES];
+static particle_store_t particles;
 static ripple_t ripples[MAX_RIPPLES];
+static effect_pool_t particle_pool;
+static effect_pool_t ripple_pool;
+static uint16_t particle_pool_storage[EFFECT_POOL_STORAGE(MAX_PARTICLES)];
+static uint16_t ripple_pool_storage[EFFECT_POOL_STORAGE(MAX_RIPPLES)];
 static wind_chime_event_t event_history[MAX_EVENTS_HISTORY];
 static uint8_t event_count = 0;
+static pending_event_t pending_events[WINDCHIME_MAX_PENDING_EVENTS];
+static uint8_t pending_count = 0;
 static lv_timer_t * animation_timer = NULL;
+static bool animation_idle = false;
+static bool animation_suspended = false;
 
 // --- Environmental Parameters ---
 static int16_t current_wind_speed = 0;
 static int16_t current_temperature = 20;
 static uint8_t audio_volume = 50;
 static uint32_t last_event_time = 0;
+static windchime_palette_cb_t palette_cb = NULL;
+static windchime_event_cb_t event_cb = NULL;
+// L8 rendering: effects are drawn as palette indices, widgets in the palette's greys
+static bool windchime_indexed = false;
+static lv_color_t palette_colors[WINDCHIME_PALETTE_SIZE];
+
+// --- Orb State (style is only touched when it changes) ---
+static lv_opa_t orb_shadow_opa = LV_OPA_50;
+static lv_color_t orb_glow_color = LV_COLOR_MAKE(0x4A, 0x90, 0xE2);
+static int16_t orb_shake_x = 0;
+static int16_t orb_shake_y = 0;
 
 // --- Color Theme ---
 static const lv_color_t source_colors[DATA_SOURCE_MAX] = {
@@ -72,6 +133,19 @@ static const lv_color_t source_colors[DATA_SOURCE_MAX] = {
     LV_COLOR_MAKE(0x50, 0xC8, 0x78)    // Weather - Green
 };
 static const char* source_names[] = {"GitHub", "Wikipedia", "Weather"};
+#define LOG_TEXT_COLOR lv_color_hex(0xAAAAAA)
+#define LOG_BADGE_COLOR lv_color_hex(0xFFFFFF)
+#define ICON_COLOR lv_color_hex(0xCCCCCC)
+#define ORB_BG_COLOR lv_color_hex(0x2A2A2A)
+#define ORB_BORDER_COLOR lv_color_hex(0x4A4A4A)
+#define ARC_BG_COLOR lv_color_hex(0x3A3A3A)
+#define ARC_COLOR lv_color_hex(0x66CCFF)
+#define ARC_GRAD_COLOR lv_color_hex(0x3377FF)
+
+// --- Lookup Tables ---
+// Alpha ramp: fade step for a particle of a given lifetime, so that
+// alpha = life * fade >> 8 without a per-frame division
+static uint16_t fade_table[PARTICLE_LIFE_MAX + 1];
 
 // --- Forward Declarations ---
 static void animation_callback(lv_timer_t * timer);
@@ -79,10 +153,46 @@ static void create_ripple(int16_t x, int16_t y, lv_color_t color, uint16_t max_r
 static void create_particles(int16_t x, int16_t y, lv_color_t color, uint8_t count);
 static void update_particles(void);
 static void update_ripples(void);
-static void update_center_orb(void);
-static void add_event_to_log(wind_chime_event_t* event);
+static bool update_center_orb(void);
+static void wake_animation(void);
+static void add_event_to_log(wind_chime_event_t* event, uint16_t count);
+static void set_log_row_text(uint8_t slot);
+static void stage_event(const wind_chime_event_t* event, int16_t x, int16_t y, lv_color_t color);
+static void drain_pending_events(void);
 static void create_visual_objects(void);
 static void update_visual_objects(void);
+static void init_fade_table(void);
+static void apply_widget_colors(void);
+
+
+// =================================================================
+// --- L8 Palette ---
+// =================================================================
+
+// Colour for an LVGL-drawn widget: itself, or in L8 its grey from the palette's neutral band
+static lv_color_t ui_color(lv_color_t color) {
+    return windchime_indexed ? WindChimePaletteNeutral(color) : color;
+}
+
+static void notify_palette(void) {
+    if (!palette_cb) return;
+    WindChimePaletteGetColors(palette_colors);
+    palette_cb(palette_colors);
+}
+
+static void apply_widget_colors(void) {
+    for (int i = 0; i < MAX_LOG_LINES; i++) {
+        lv_obj_set_style_text_color(event_log_lines[i], ui_color(LOG_TEXT_COLOR), 0);
+        if (event_log_rows[i].count) set_log_row_text(i);
+    }
+    lv_obj_set_style_text_color(settings_icon, ui_color(ICON_COLOR), 0);
+    lv_obj_set_style_bg_color(center_orb, ui_color(ORB_BG_COLOR), LV_PART_MAIN);
+    lv_obj_set_style_border_color(center_orb, ui_color(ORB_BORDER_COLOR), LV_PART_MAIN);
+    lv_obj_set_style_shadow_color(center_orb, ui_color(orb_glow_color), LV_PART_MAIN);
+    lv_obj_set_style_arc_color(volume_arc, ui_color(ARC_BG_COLOR), LV_PART_MAIN);
+    lv_obj_set_style_bg_color(volume_arc, ui_color(ARC_COLOR), LV_PART_INDICATOR);
+    lv_obj_set_style_bg_grad_color(volume_arc, ui_color(ARC_GRAD_COLOR), LV_PART_INDICATOR);
+}
 
 
 // =================================================================
@@ -94,20 +204,32 @@ void WindChimeScreenCreate(lv_event_cb_t event_cb)
     lv_obj_set_style_bg_color(windchime_screen, lv_color_black(), LV_PART_MAIN);
     lv_obj_set_style_bg_opa(windchime_screen, LV_OPA_COVER, LV_PART_MAIN);
 
-    event_log_label = lv_label_create(windchime_screen);
-    lv_obj_set_width(event_log_label, lv_pct(95));
-    lv_obj_align(event_log_label, LV_ALIGN_BOTTOM_LEFT, 10, -10);
-    lv_label_set_recolor(event_log_label, true);
-    lv_obj_set_style_text_font(event_log_label, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(event_log_label, lv_color_hex(0xAAAAAA), 0);
-    lv_obj_set_style_text_line_space(event_log_label, 4, 0);
-    lv_label_set_text(event_log_label, "Awaiting events from the digital ether...");
-    lv_obj_move_background(event_log_label);
+    event_log_line_height = lv_font_get_line_height(&lv_font_montserrat_14) + 4;
+    event_log_box = lv_obj_create(windchime_screen);
+    lv_obj_remove_style_all(event_log_box);
+    lv_obj_set_size(event_log_box, lv_pct(95), event_log_line_height * MAX_LOG_LINES);
+    lv_obj_align(event_log_box, LV_ALIGN_BOTTOM_LEFT, 10, -10);
+    lv_obj_remove_flag(event_log_box, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    for (int i = 0; i < MAX_LOG_LINES; i++) {
+        lv_obj_t * line = lv_label_create(event_log_box);
+        lv_obj_set_width(line, lv_pct(100));
+        lv_label_set_long_mode(line, LV_LABEL_LONG_CLIP);
+        lv_label_set_recolor(line, true);
+        lv_obj_set_style_text_font(line, &lv_font_montserrat_14, 0);
+        lv_label_set_text_static(line, "");
+        lv_obj_set_y(line, event_log_line_height * i);
+        event_log_lines[i] = line;
+    }
+    event_log_newest = MAX_LOG_LINES - 1;
+    lv_label_set_text_static(event_log_lines[event_log_newest], "Awaiting events from the digital ether...");
+    lv_obj_move_background(event_log_box);
 
     main_canvas = lv_canvas_create(windchime_screen);
     lv_obj_set_size(main_canvas, CANVAS_WIDTH, CANVAS_HEIGHT);
     lv_obj_align(main_canvas, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_style_bg_opa(main_canvas, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_remove_flag(main_canvas, LV_OBJ_FLAG_CLICKABLE); // Touches reach the button even when it is on top
+    main_canvas_index = lv_obj_get_index(main_canvas);
 
     lv_obj_t * settings_btn = lv_btn_create(windchime_screen);
     lv_obj_align(settings_btn, LV_ALIGN_TOP_RIGHT, -10, 10);
@@ -116,22 +238,18 @@ void WindChimeScreenCreate(lv_event_cb_t event_cb)
     lv_obj_set_style_border_width(settings_btn, 0, LV_PART_MAIN);
     lv_obj_set_style_shadow_width(settings_btn, 0, LV_PART_MAIN);
 
-    lv_obj_t * icon = lv_label_create(settings_btn);
-    lv_label_set_text(icon, LV_SYMBOL_SETTINGS);
-    lv_obj_set_style_text_color(icon, lv_color_hex(0xCCCCCC), 0);
-    lv_obj_set_style_text_font(icon, &lv_font_montserrat_24, 0);
-    lv_obj_center(icon);
+    settings_icon = lv_label_create(settings_btn);
+    lv_label_set_text(settings_icon, LV_SYMBOL_SETTINGS);
+    lv_obj_set_style_text_font(settings_icon, &lv_font_montserrat_24, 0);
+    lv_obj_center(settings_icon);
 
     center_orb = lv_obj_create(windchime_screen);
     lv_obj_set_size(center_orb, 80, 80);
     lv_obj_align(center_orb, LV_ALIGN_CENTER, 0, 0);
     lv_obj_set_style_radius(center_orb, LV_RADIUS_CIRCLE, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(center_orb, lv_color_make(0x2a, 0x2a, 0x2a), LV_PART_MAIN);
     lv_obj_set_style_bg_opa(center_orb, LV_OPA_80, LV_PART_MAIN);
     lv_obj_set_style_border_width(center_orb, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(center_orb, lv_color_make(0x4a, 0x4a, 0x4a), LV_PART_MAIN);
     lv_obj_set_style_shadow_width(center_orb, 40, LV_PART_MAIN);
-    lv_obj_set_style_shadow_color(center_orb, lv_color_make(0x4A, 0x90, 0xE2), LV_PART_MAIN);
     lv_obj_set_style_shadow_opa(center_orb, LV_OPA_50, LV_PART_MAIN);
     lv_obj_set_style_shadow_spread(center_orb, 5, LV_PART_MAIN);
     
@@ -149,23 +267,25 @@ void WindChimeScreenCreate(lv_event_cb_t event_cb)
     lv_obj_clear_flag(volume_arc, LV_OBJ_FLAG_CLICKABLE); // It's for display only
 
     // Background style
-    lv_obj_set_style_arc_color(volume_arc, lv_color_make(0x3a, 0x3a, 0x3a), LV_PART_MAIN);
     lv_obj_set_style_arc_width(volume_arc, 6, LV_PART_MAIN);
     lv_obj_set_style_arc_opa(volume_arc, LV_OPA_80, LV_PART_MAIN);
 
     // Indicator style (the filled part) with a gradient
     lv_obj_set_style_arc_width(volume_arc, 6, LV_PART_INDICATOR);
     lv_obj_set_style_bg_grad_dir(volume_arc, LV_GRAD_DIR_HOR, LV_PART_INDICATOR);
-    lv_obj_set_style_bg_grad_color(volume_arc, lv_color_make(0x33, 0x77, 0xFF), LV_PART_INDICATOR);
     lv_obj_set_style_bg_main_stop(volume_arc, 0, LV_PART_INDICATOR);
     lv_obj_set_style_bg_grad_stop(volume_arc, 255, LV_PART_INDICATOR);
-    lv_obj_set_style_bg_color(volume_arc, lv_color_make(0x66, 0xCC, 0xFF), LV_PART_INDICATOR);
     // --- MODIFICATION END ---
+    apply_widget_colors();
 
-    memset(particles, 0, sizeof(particles));
+    memset(&particles, 0, sizeof(particles));
     memset(ripples, 0, sizeof(ripples));
     memset(event_history, 0, sizeof(event_history));
+    EffectPoolInit(&particle_pool, particle_pool_storage, MAX_PARTICLES);
+    EffectPoolInit(&ripple_pool, ripple_pool_storage, MAX_RIPPLES);
 
+    init_fade_table();
+    WindChimePalettePreset(source_colors, DATA_SOURCE_MAX);
     create_visual_objects();
 
     WindChimeStartAnimation();
@@ -178,20 +298,18 @@ void WindChimeScreenCreate(lv_event_cb_t event_cb)
 void WindChimeAddEvent(wind_chime_event_t* event)
 {
     if (!event) return;
+    // May wake the display (and resume us) before the event is staged
+    if (event_cb) event_cb(event);
 
     event_history[event_count % MAX_EVENTS_HISTORY] = *event;
     event_count++;
 
     int16_t x, y;
-    // lv_color_t color = source_colors[event->source];
-    circle_style_t style = event.circle_style
-    lv_color_t colot = lv_color_make(style.r, style.g, style.b)
-
     switch(event->source) {
         case DATA_SOURCE_GITHUB:
         case DATA_SOURCE_WIKIPEDIA:
-            x = event->circle_style.x_coord;
-            y = event->circle_style.y_coord;
+            x = LV_CLAMP(0, event->circle_style.x_coord, CANVAS_WIDTH - 1);
+            y = LV_CLAMP(0, event->circle_style.y_coord, CANVAS_HEIGHT - 1);
             break;
         case DATA_SOURCE_WEATHER:
         default:
@@ -200,17 +318,91 @@ void WindChimeAddEvent(wind_chime_event_t* event)
             break;
     }
 
-    uint16_t ripple_size = 50 + (event->intensity * 2);
-    create_ripple(x, y, color, ripple_size);
-    uint8_t particle_count = 5 + (event->intensity / 15);
-    create_particles(x, y, color, particle_count);
+    const circle_style_t * style = &event->circle_style;
+    lv_color_t color = style->a > 0 ? lv_color_make(style->r, style->g, style->b)
+                                    : source_colors[event->source];
 
-    PlayEventSound(event->source, event->intensity);
+    // Effects are spawned once per animation frame, see drain_pending_events()
+    stage_event(event, x, y, color);
+    // Display blanked: keep merging into the pending queue, spawn on resume
+    if (animation_suspended) return;
+    if (!animation_timer) {
+        drain_pending_events();
+        return;
+    }
+    wake_animation();
+}
 
-    add_event_to_log(event);
+static void stage_event(const wind_chime_event_t* event, int16_t x, int16_t y, lv_color_t color)
+{
+    // Closest pending event from the same source; when the queue is full,
+    // fold into the closest one regardless of distance (or source)
+    int best = -1;
+    int32_t best_dist = INT32_MAX;
+    for (int i = 0; i < pending_count; i++) {
+        pending_event_t * p = &pending_events[i];
+        bool same_source = p->event.source == event->source;
+        if (!same_source && pending_count < WINDCHIME_MAX_PENDING_EVENTS) continue;
+
+        int32_t dist = LV_MAX(LV_ABS(p->x - x), LV_ABS(p->y - y));
+        if (!same_source) dist += CANVAS_WIDTH; // Prefer any same-source slot
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = i;
+        }
+    }
+
+    if (best >= 0 && (best_dist <= WINDCHIME_EVENT_MERGE_RADIUS || pending_count == WINDCHIME_MAX_PENDING_EVENTS)) {
+        pending_event_t * p = &pending_events[best];
+        p->event.intensity += event->intensity;
+        p->count++;
+        // The log line shows the latest description
+        memcpy(p->event.description, event->description, sizeof(p->event.description));
+        return;
+    }
+
+    pending_event_t * p = &pending_events[pending_count++];
+    p->event = *event;
+    p->x = x;
+    p->y = y;
+    p->color = color;
+    p->count = 1;
+}
+
+// Turns this frame's merged events into effects: one ripple, particle burst
+// and log line each, but only one sound (the buzzer blocks) and one orb
+// colour change, both from the strongest effect
+static void drain_pending_events(void)
+{
+    if (pending_count == 0) return;
+
+    pending_event_t * strongest = &pending_events[0];
+    bool palette_changed = false;
+    for (int i = 0; i < pending_count; i++) {
+        pending_event_t * p = &pending_events[i];
+        int32_t intensity = LV_CLAMP(0, p->event.intensity, WINDCHIME_MAX_INTENSITY);
+        // A palette slot before anything is drawn in this colour
+        WindChimePaletteSlot(p->color, &palette_changed);
+
+        uint16_t ripple_size = 50 + (intensity * 2);
+        create_ripple(p->x, p->y, p->color, ripple_size);
+        uint8_t particle_count = 5 + (intensity / 15);
+        create_particles(p->x, p->y, p->color, particle_count);
+
+        add_event_to_log(&p->event, p->count);
+
+        if (p->event.intensity > strongest->event.intensity) {
+            strongest = p;
+        }
+    }
 
-    lv_obj_set_style_shadow_color(center_orb, color, LV_PART_MAIN);
+    PlayEventSound(strongest->event.source,
+                   LV_CLAMP(0, strongest->event.intensity, WINDCHIME_MAX_INTENSITY));
+    orb_glow_color = strongest->color;
+    lv_obj_set_style_shadow_color(center_orb, ui_color(orb_glow_color), LV_PART_MAIN);
+    if (palette_changed && windchime_indexed) notify_palette();
     last_event_time = lv_tick_get();
+    pending_count = 0;
 }
 
 // MQTT事件触发函数
@@ -221,6 +413,13 @@ void TriggerWindChimeEvent(data_source_t source, int32_t intensity, const char*
     event.timestamp = lv_tick_get();
     event.intensity = intensity;
     event.color_hash = 0; // 将使用默认颜色
+    if (circle_style) {
+        event.circle_style = *circle_style;
+    } else {
+        memset(&event.circle_style, 0, sizeof(event.circle_style));
+        event.circle_style.x_coord = CENTER_X;
+        event.circle_style.y_coord = CENTER_Y;
+    }
     
     // 复制描述，确保不超过缓冲区大小
     if (description) {
@@ -241,60 +440,67 @@ void TriggerWindChimeEvent(data_source_t source, int32_t intensity, const char*
 // --- Log & Animation Updates ---
 // =================================================================
 
-static void add_event_to_log(wind_chime_event_t* event) {
-    static bool first_event = true;
-    const char * current_log_text = lv_label_get_text(event_log_label);
-    char new_log_buffer[1024];
-
+// Writes a row's label from event_log_rows, in the current colours
+static void set_log_row_text(uint8_t slot) {
+    const log_row_t * row = &event_log_rows[slot];
     // This method for getting color components is robust in LVGL v9
-    uint32_t color32 = lv_color_to_u32(source_colors[event->source]);
-    uint8_t r = (color32 >> 16) & 0xFF;
-    uint8_t g = (color32 >> 8) & 0xFF;
-    uint8_t b = color32 & 0xFF;
-
-    char color_hex_str[7];
-    sprintf(color_hex_str, "%02X%02X%02X", r, g, b);
+    uint32_t color32 = lv_color_to_u32(ui_color(source_colors[row->source]));
 
     char new_line[256];
-    snprintf(new_line, sizeof(new_line), "#%s>>[%s]# %s",
-             color_hex_str,
-             source_names[event->source],
-             event->description);
+    int len = snprintf(new_line, sizeof(new_line), "#%06lX>>[%s]# %s",
+                       (unsigned long)(color32 & 0xFFFFFF),
+                       source_names[row->source],
+                       row->description);
+    // Badge for events merged into this one
+    if (row->count > 1 && len > 0 && len < (int)sizeof(new_line)) {
+        uint32_t badge32 = lv_color_to_u32(ui_color(LOG_BADGE_COLOR));
+        snprintf(new_line + len, sizeof(new_line) - len, " #%06lX x%u#",
+                 (unsigned long)(badge32 & 0xFFFFFF), row->count);
+    }
+    lv_label_set_text(event_log_lines[slot], new_line);
+}
+
+static void add_event_to_log(wind_chime_event_t* event, uint16_t count) {
+    static bool first_event = true;
+
+    // The first event replaces the placeholder in the bottom row, after that
+    // the oldest (top) row is reused and every row moves up one
+    if (!first_event) {
+        event_log_newest = (event_log_newest + 1) % MAX_LOG_LINES;
+    }
+    log_row_t * row = &event_log_rows[event_log_newest];
+    row->source = event->source;
+    row->count = count;
+    memcpy(row->description, event->description, sizeof(row->description));
+    set_log_row_text(event_log_newest);
 
     if (first_event) {
-        lv_label_set_text(event_log_label, new_line);
         first_event = false;
         return;
     }
-
-    int line_count = 1;
-    for (const char* t = current_log_text; *t; t++) {
-        if (*t == '\n') line_count++;
+    for (int r = 0; r < MAX_LOG_LINES; r++) {
+        uint8_t slot = (event_log_newest + 1 + r) % MAX_LOG_LINES;
+        lv_obj_set_y(event_log_lines[slot], event_log_line_height * r);
     }
-
-    if (line_count < MAX_LOG_LINES) {
-        snprintf(new_log_buffer, sizeof(new_log_buffer), "%s\n%s", current_log_text, new_line);
-    } else {
-        const char* start_of_second_line = strchr(current_log_text, '\n');
-        if (start_of_second_line) {
-            snprintf(new_log_buffer, sizeof(new_log_buffer), "%s\n%s", start_of_second_line + 1, new_line);
-        } else { // Should not happen if line_count > 1, but as a fallback
-            snprintf(new_log_buffer, sizeof(new_log_buffer), "%s", new_line);
-        }
-    }
-    lv_label_set_text(event_log_label, new_log_buffer);
 }
 
-static void update_center_orb(void)
+// Returns true once the glow has faded out and the orb is not shaking
+static bool update_center_orb(void)
 {
     uint32_t time_since_event = lv_tick_get() - last_event_time;
+    bool settled = false;
 
+    lv_opa_t shadow_opa;
     if (time_since_event < 2000) {
         // Fade out the glow effect
-        uint8_t brightness = LV_OPA_COVER - (time_since_event * LV_OPA_COVER / 2000);
-        lv_obj_set_style_shadow_opa(center_orb, brightness, LV_PART_MAIN);
+        shadow_opa = LV_OPA_COVER - (time_since_event * LV_OPA_COVER / 2000);
     } else {
-        lv_obj_set_style_shadow_opa(center_orb, LV_OPA_20, LV_PART_MAIN);
+        shadow_opa = LV_OPA_20;
+        settled = true;
+    }
+    if (shadow_opa != orb_shadow_opa) {
+        orb_shadow_opa = shadow_opa;
+        lv_obj_set_style_shadow_opa(center_orb, shadow_opa, LV_PART_MAIN);
     }
 
     // Shake effect based on wind speed
@@ -304,8 +510,15 @@ static void update_center_orb(void)
         if (shake_range < 1) shake_range = 1;
         shake_x = (rand() % (shake_range * 2)) - shake_range;
         shake_y = (rand() % (shake_range * 2)) - shake_range;
+        settled = false;
+    }
+    if (shake_x != orb_shake_x || shake_y != orb_shake_y) {
+        orb_shake_x = shake_x;
+        orb_shake_y = shake_y;
+        lv_obj_align(center_orb, LV_ALIGN_CENTER, shake_x, shake_y);
     }
-    lv_obj_align(center_orb, LV_ALIGN_CENTER, shake_x, shake_y);
+
+    return settled;
 }
 
 
@@ -314,6 +527,9 @@ static void update_center_orb(void)
 // =================================================================
 
 void WindChimeUpdateWeather(int16_t wind_speed, int16_t temperature) {
+    if (wind_speed != current_wind_speed) {
+        wake_animation();
+    }
     current_wind_speed = wind_speed;
     current_temperature = temperature;
     UpdateAmbientSound(wind_speed);
@@ -330,61 +546,62 @@ void WindChimeSetVolume(uint8_t volume) {
 }
 
 static void create_ripple(int16_t x, int16_t y, lv_color_t color, uint16_t max_radius) {
-    for (int i = 0; i < MAX_RIPPLES; i++) {
-        if (!ripples[i].active) {
-            ripples[i] = (ripple_t){.active = true, .x = x, .y = y, .radius = 0, .max_radius = max_radius, .alpha = 255, .color = color};
-            return; // Found a spot, exit
-        }
+    int32_t i = EffectPoolAlloc(&ripple_pool);
+    if (i < 0) return; // All ripples busy
+
+    ripples[i] = (ripple_t){.active = true, .x = x, .y = y, .radius = 0, .max_radius = max_radius, .alpha = 255, .color = color};
+}
+
+static void init_fade_table(void) {
+    for (int life = 1; life <= PARTICLE_LIFE_MAX; life++) {
+        fade_table[life] = particle_fade_step(life);
     }
 }
 
 static void create_particles(int16_t x, int16_t y, lv_color_t color, uint8_t count) {
-    int created = 0;
-    for (int i = 0; i < MAX_PARTICLES && created < count; i++) {
-        if (particles[i].life == 0) { // Find an inactive particle
-            float angle = (rand() % 360) * M_PI / 180.0f;
-            float speed = 0.5f + ((rand() % 100) / 100.0f) * 2.5f; // Random speed from 0.5 to 3.0
-            particles[i].vx = cos(angle) * speed;
-            particles[i].vy = sin(angle) * speed;
-            particles[i].life = 80 + (rand() % 60); // Longer life for more visible effect
-            particles[i].max_life = particles[i].life;
-            particles[i].x = x;
-            particles[i].y = y;
-            particles[i].color = color;
-            particles[i].size = 2 + (rand() % 2);
-            created++;
-        }
+    for (uint8_t n = 0; n < count; n++) {
+        int32_t i = EffectPoolAlloc(&particle_pool);
+        if (i < 0) break; // Pool exhausted
+
+        int32_t deg = rand() % 360;
+        // Random speed from 0.5 to 3.0 px per frame
+        int32_t speed_step = rand() % PARTICLE_SPEED_STEPS;
+        int16_t life = PARTICLE_LIFE_MIN + (rand() % PARTICLE_LIFE_RANGE);
+        particle_launch(deg, speed_step, &particles.vx[i], &particles.vy[i]);
+        particles.life[i] = life;
+        particles.fade[i] = fade_table[life];
+        particles.x[i] = INT_TO_FIX(x);
+        particles.y[i] = INT_TO_FIX(y);
+        particles.color[i] = color;
+        particles.size[i] = 2 + (rand() % 2);
+        particles.drawn_size[i] = 0;
     }
 }
 
-// --- MODIFICATION START: Fixed particle lifecycle and physics ---
 static void update_particles(void) {
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (particles[i].life > 0) {
-            // Update position with float values
-            particles[i].x += particles[i].vx;
-            particles[i].y += particles[i].vy;
-
-            // Apply wind and gravity
-            particles[i].x += (current_wind_speed / 20.0f);
-            particles[i].vy += PARTICLE_GRAVITY;
-
-            // Check if particle is out of bounds
-            if (particles[i].x < 0 || particles[i].x >= CANVAS_WIDTH ||
-                particles[i].y < 0 || particles[i].y >= CANVAS_HEIGHT)
-            {
-                particles[i].life = 0; // Mark as dead, will be collected next frame
-            } else {
-                particles[i].life--; // Decrement life only if it's still on screen
-            }
+    // Wind drifts particles sideways by wind_speed / 20 px per frame
+    const int32_t wind = particle_wind(current_wind_speed);
+    const uint32_t max_x = INT_TO_FIX(CANVAS_WIDTH);
+    const uint32_t max_y = INT_TO_FIX(CANVAS_HEIGHT);
+    const uint16_t * active = particle_pool.active;
+
+    // Only live slots are visited, dead ones were released after their last erase
+    for (uint16_t k = 0; k < particle_pool.live; k++) {
+        uint16_t i = active[k];
+        // Out of bounds dies right away, otherwise the particle ages by one frame
+        if (!particle_step(&particles.x[i], &particles.y[i], particles.vx[i], &particles.vy[i],
+                           wind, max_x, max_y)) {
+            particles.life[i] = 0;
+        } else {
+            particles.life[i]--;
         }
     }
 }
-// --- MODIFICATION END ---
 
 
 static void update_ripples(void) {
-    for (int i = 0; i < MAX_RIPPLES; i++) {
+    for (uint16_t k = 0; k < ripple_pool.live; k++) {
+        uint16_t i = ripple_pool.active[k];
         if (ripples[i].active) {
             ripples[i].radius += 2; // Slightly slower ripple
             if (ripples[i].radius >= ripples[i].max_radius) {
@@ -399,54 +616,67 @@ static void update_ripples(void) {
 }
 
 
-static lv_obj_t * particle_objects[MAX_PARTICLES];
-static lv_obj_t * ripple_objects[MAX_RIPPLES];
-
 static void create_visual_objects(void) {
-    // Parent all effects to the main_canvas
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        particle_objects[i] = lv_obj_create(main_canvas);
-        lv_obj_set_size(particle_objects[i], 4, 4); // Initial size, will be updated
-        lv_obj_set_style_radius(particle_objects[i], LV_RADIUS_CIRCLE, LV_PART_MAIN);
-        lv_obj_set_style_border_width(particle_objects[i], 0, LV_PART_MAIN);
-        lv_obj_add_flag(particle_objects[i], LV_OBJ_FLAG_HIDDEN);
-    }
-    for (int i = 0; i < MAX_RIPPLES; i++) {
-        ripple_objects[i] = lv_obj_create(main_canvas);
-        lv_obj_set_style_radius(ripple_objects[i], LV_RADIUS_CIRCLE, LV_PART_MAIN);
-        lv_obj_set_style_bg_opa(ripple_objects[i], LV_OPA_TRANSP, LV_PART_MAIN);
-        lv_obj_set_style_border_width(ripple_objects[i], 2, LV_PART_MAIN);
-        lv_obj_add_flag(ripple_objects[i], LV_OBJ_FLAG_HIDDEN);
+    // Particles and ripples are rasterized straight into the main_canvas buffer
+    if (!WindChimeRenderInit(main_canvas, CANVAS_WIDTH, CANVAS_HEIGHT)) {
+        LV_LOG_WARN("WindChime: canvas buffer allocation failed, effects disabled");
     }
 }
 
 
 static void update_visual_objects(void) {
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        if (particles[i].life > 0) {
-            lv_obj_clear_flag(particle_objects[i], LV_OBJ_FLAG_HIDDEN);
-            // Use integer cast for setting position
-            lv_obj_set_pos(particle_objects[i], (int16_t)particles[i].x, (int16_t)particles[i].y);
-            lv_obj_set_size(particle_objects[i], particles[i].size, particles[i].size);
-            uint8_t alpha = (particles[i].life * 255) / particles[i].max_life;
-            lv_obj_set_style_bg_color(particle_objects[i], particles[i].color, LV_PART_MAIN);
-            lv_obj_set_style_bg_opa(particle_objects[i], alpha, LV_PART_MAIN);
-        } else {
-            lv_obj_add_flag(particle_objects[i], LV_OBJ_FLAG_HIDDEN);
+    // Erase everything drawn last frame first, so an erase never punches a
+    // hole into an effect that has already been redrawn this frame. Effects
+    // that died are released here, after their last erase; walk backwards
+    // because a release moves the last live slot into the freed position.
+    for (int32_t k = ripple_pool.live - 1; k >= 0; k--) {
+        uint16_t i = ripple_pool.active[k];
+        uint16_t r = ripples[i].drawn_radius;
+        if (r > 0) {
+            WindChimeRenderRing(ripples[i].x, ripples[i].y, r, RIPPLE_BORDER_WIDTH, 0);
+        }
+        if (!ripples[i].active) {
+            if (r > 0) {
+                WindChimeRenderInvalidateRing(ripples[i].x, ripples[i].y, r - RIPPLE_BORDER_WIDTH, r);
+            }
+            EffectPoolRelease(&ripple_pool, i);
         }
     }
-    for (int i = 0; i < MAX_RIPPLES; i++) {
-        if (ripples[i].active) {
-            lv_obj_clear_flag(ripple_objects[i], LV_OBJ_FLAG_HIDDEN);
-            int16_t size = ripples[i].radius * 2;
-            lv_obj_set_size(ripple_objects[i], size, size);
-            lv_obj_set_pos(ripple_objects[i], ripples[i].x - ripples[i].radius, ripples[i].y - ripples[i].radius);
-            lv_obj_set_style_border_color(ripple_objects[i], ripples[i].color, LV_PART_MAIN);
-            lv_obj_set_style_border_opa(ripple_objects[i], ripples[i].alpha, LV_PART_MAIN);
-        } else {
-            lv_obj_add_flag(ripple_objects[i], LV_OBJ_FLAG_HIDDEN);
+    for (int32_t k = particle_pool.live - 1; k >= 0; k--) {
+        uint16_t i = particle_pool.active[k];
+        if (particles.drawn_size[i] > 0) {
+            WindChimeRenderDot(particles.drawn_x[i], particles.drawn_y[i], particles.drawn_size[i], 0);
+            particles.drawn_size[i] = 0;
+        }
+        if (particles.life[i] == 0) {
+            EffectPoolRelease(&particle_pool, i);
+        }
+    }
+
+    for (uint16_t k = 0; k < ripple_pool.live; k++) {
+        uint16_t i = ripple_pool.active[k];
+        uint16_t r = ripples[i].radius;
+        if (r > 0) {
+            WindChimeRenderRing(ripples[i].x, ripples[i].y, r, RIPPLE_BORDER_WIDTH,
+                                WindChimeRenderPixel(ripples[i].color, ripples[i].alpha));
+            // Only the band between last frame's ring and this one changed
+            uint16_t r_old = ripples[i].drawn_radius > 0 ? ripples[i].drawn_radius : r;
+            WindChimeRenderInvalidateRing(ripples[i].x, ripples[i].y,
+                                          LV_MIN(r_old, r) - RIPPLE_BORDER_WIDTH, LV_MAX(r_old, r));
+            ripples[i].drawn_radius = r;
         }
     }
+    for (uint16_t k = 0; k < particle_pool.live; k++) {
+        uint16_t i = particle_pool.active[k];
+        lv_opa_t alpha = particle_alpha(particles.life[i], particles.fade[i]);
+        particles.drawn_x[i] = FIX_TO_INT(particles.x[i]);
+        particles.drawn_y[i] = FIX_TO_INT(particles.y[i]);
+        particles.drawn_size[i] = particles.size[i];
+        WindChimeRenderDot(particles.drawn_x[i], particles.drawn_y[i], particles.drawn_size[i],
+                           WindChimeRenderPixel(particles.color[i], alpha));
+    }
+
+    WindChimeRenderFlush();
 }
 
 // =================================================================
@@ -454,23 +684,103 @@ static void update_visual_objects(void) {
 // =================================================================
 
 static void animation_callback(lv_timer_t * timer) {
+    uint32_t frame_start = PerfMonitor_Begin();
+
+    // Spawn whatever arrived since the last frame
+    drain_pending_events();
+
     // Update data models first
+    uint32_t t = PerfMonitor_Begin();
     update_particles();
+    PerfMonitor_End(PERF_PHASE_PARTICLES, t);
+
+    t = PerfMonitor_Begin();
     update_ripples();
-    update_center_orb();
+    PerfMonitor_End(PERF_PHASE_RIPPLES, t);
+
+    t = PerfMonitor_Begin();
+    bool orb_settled = update_center_orb();
+    PerfMonitor_End(PERF_PHASE_ORB, t);
 
     // Then update the GUI objects based on the new data
+    t = PerfMonitor_Begin();
     update_visual_objects();
+    PerfMonitor_End(PERF_PHASE_VISUALS, t);
+    PerfMonitor_Count(PERF_COUNTER_INVALIDATED_PX, WindChimeRenderGetStats()->invalidated_px);
+    PerfMonitor_End(PERF_PHASE_FRAME, frame_start);
+
+    // The canvas is written directly, update_visual_objects() invalidates
+    // only the areas it touched.
+
+    // Nothing left to move or erase: sleep until an event or a wind change
+    if (orb_settled && particle_pool.live == 0 && ripple_pool.live == 0) {
+        lv_timer_pause(timer);
+        animation_idle = true;
+        // No effect uses a custom colour's indices any more
+        WindChimePaletteReleaseCustom();
+    }
+}
 
-    // In LVGL v9, you don't typically need to call lv_canvas_invalidate.
-    // Object property changes automatically trigger redraws.
+static void wake_animation(void) {
+    if (animation_timer && animation_idle && !animation_suspended) {
+        animation_idle = false;
+        lv_timer_resume(animation_timer);
+        lv_timer_ready(animation_timer);
+    }
 }
 
 void WindChimeStartAnimation(void) {
     if (!animation_timer) {
         uint32_t period = 1000 / WINDCHIME_ANIMATION_FPS;
         animation_timer = lv_timer_create(animation_callback, period, NULL);
+        animation_idle = false;
+    }
+}
+
+bool WindChimeIsAnimationIdle(void) {
+    return !animation_timer || animation_idle;
+}
+
+void WindChimeSetPaletteCallback(windchime_palette_cb_t cb) {
+    palette_cb = cb;
+}
+
+void WindChimeSetIndexed(bool indexed) {
+    if (!windchime_screen || indexed == windchime_indexed) return;
+    windchime_indexed = indexed;
+    WindChimeRenderSetIndexed(indexed);
+    apply_widget_colors();
+    // The canvas holds opaque indices: on top, so LVGL never blends them with a widget
+    if (indexed) {
+        lv_obj_move_foreground(main_canvas);
+        notify_palette();
+    } else {
+        lv_obj_move_to_index(main_canvas, main_canvas_index);
+    }
+    // Redraw live effects in the new format
+    wake_animation();
+}
+
+void WindChimeSetEventCallback(windchime_event_cb_t cb) {
+    event_cb = cb;
+}
+
+void WindChimeSetSuspended(bool suspended) {
+    if (suspended == animation_suspended) return;
+    animation_suspended = suspended;
+    if (suspended) {
+        if (animation_timer) {
+            lv_timer_pause(animation_timer);
+            animation_idle = true;
+        }
+        return;
+    }
+    if (!animation_timer) {
+        if (pending_count) drain_pending_events();
+        return;
     }
+    // Let the first frame after the pause decide whether there is anything left to animate
+    wake_animation();
 }
 
 void WindChimeStopAnimation(void) {
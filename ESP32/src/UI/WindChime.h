@@ -15,6 +15,17 @@ typedef enum {
     DATA_SOURCE_MAX
 } data_source_t;
 
+// 事件圆形样式 (来自MQTT消息的 style 字段)
+typedef struct {
+    int r;
+    int g;
+    int b;
+    float a;                // a <= 0 时使用数据源默认颜色
+    int x_coord;
+    int y_coord;
+    int radius;
+} circle_style_t;
+
 // 事件数据结构
 typedef struct {
     data_source_t source;
@@ -30,16 +41,31 @@ extern lv_obj_t * windchime_screen;
 
 // 主要函数
 void WindChimeScreenCreate(lv_event_cb_t event_cb);
+// 事件先暂存，在下一动画帧合并后统一生成效果
 void WindChimeAddEvent(wind_chime_event_t* event);
 void WindChimeUpdateWeather(int16_t wind_speed, int16_t temperature);
 void WindChimeSetVolume(uint8_t volume);
 
-// MQTT事件触发函数
+// MQTT事件触发函数，circle_style 可为 NULL
 void TriggerWindChimeEvent(data_source_t source, int32_t intensity, const char* description, circle_style_t* circle_style);
 
 // 动画和效果函数
 void WindChimeStartAnimation(void);
 void WindChimeStopAnimation(void);
+bool WindChimeIsAnimationIdle(void);   // 没有活动效果时动画定时器暂停
+
+// L8 渲染：粒子和涟漪按 WindChimePalette 的索引写入画布，控件改用灰阶，画布移到最上层。
+// 切换后以及索引模式下分配了新颜色槽时，用 256 项调色板回调 (驱动据此重建查找表并重绘)
+typedef void (*windchime_palette_cb_t)(const lv_color_t * colors);
+void WindChimeSetPaletteCallback(windchime_palette_cb_t cb);
+void WindChimeSetIndexed(bool indexed);
+
+// 每个事件到达时先回调 (在暂存之前)，显示休眠用它按强度唤醒屏幕
+typedef void (*windchime_event_cb_t)(const wind_chime_event_t* event);
+void WindChimeSetEventCallback(windchime_event_cb_t cb);
+
+// 屏幕熄灭时暂停动画定时器，事件照常合并暂存，恢复后在下一帧生成效果
+void WindChimeSetSuspended(bool suspended);
 
 #ifdef __cplusplus
 } /*extern "C"*/
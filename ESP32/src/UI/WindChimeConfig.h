@@ -2,10 +2,27 @@
 #define WINDCHIME_CONFIG_H
 
 // 视觉效果配置
-#define WINDCHIME_MAX_PARTICLES 30        // max粒子数量
+#define WINDCHIME_MAX_PARTICLES 1024      // max粒子数量 (画布光栅化，不再受 lv_obj 数量限制)
 #define WINDCHIME_MAX_RIPPLES 8           // max涟漪数量
 #define WINDCHIME_ANIMATION_FPS 20        // 帧率
 
+// 事件合并：同一帧内同来源、位置相近的事件合并为一个效果，强度相加
+#define WINDCHIME_MAX_PENDING_EVENTS 8    // 每帧最多生成的效果数
+#define WINDCHIME_EVENT_MERGE_RADIUS 48   // 合并距离(px)
+#define WINDCHIME_MAX_INTENSITY 100       // 合并后强度上限 (用于效果大小)
+
+// 涟漪抗锯齿圆环缓存 (PSRAM, A8 四分之一圆环遮罩，按半径分桶，首次用到时生成)
+#define WINDCHIME_RING_CACHE_BUDGET (128 * 1024) // 缓存内存上限(字节)，超出后直接绘制不抗锯齿的圆环
+#define WINDCHIME_RING_CACHE_MAX_RADIUS 256      // 超过此半径不缓存
+#define WINDCHIME_RING_CACHE_STEP 2              // 半径分桶步长 (涟漪每帧扩大2px)
+
+// L8 渲染：风铃界面显示时 LVGL 每像素只渲染 1 字节调色板索引，flush 时查表展开成 RGB565。
+// 绘制缓冲是被替换模式的一半：partial 9.6 → 4.8 KB、double-partial 76.8 → 38.4 KB SRAM，
+// direct/zero-copy 换成 230.4 KB 的 PSRAM 整帧。调色板见 WindChimePalette.h：控件变成灰阶，
+// 粒子和涟漪保留各自的颜色，但只有 16 级亮度，同时最多 8 种颜色 (更多时取最接近的)。
+// 串口命令 "l8 on|off" 可在运行时切换
+#define WINDCHIME_L8_RENDER 0
+
 // 音频配置
 #define WINDCHIME_BUZZER_PIN 42           // 蜂鸣器引脚
 #define WINDCHIME_DEFAULT_VOLUME 50       // 默认音量
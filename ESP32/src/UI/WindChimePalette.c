@@ -0,0 +1,90 @@
+#include "WindChimePalette.h"
+
+static lv_color_t slot_colors[WINDCHIME_PALETTE_SLOTS];
+static uint8_t slot_count = 0;   // Slots in use
+static uint8_t fixed_count = 0;  // Of those, never released
+
+static uint32_t color_rgb(lv_color_t c)
+{
+    return ((uint32_t)c.red << 16) | ((uint32_t)c.green << 8) | c.blue;
+}
+
+static int32_t color_distance(lv_color_t c, uint32_t rgb)
+{
+    int32_t dr = (int32_t)c.red - (int32_t)((rgb >> 16) & 0xFF);
+    int32_t dg = (int32_t)c.green - (int32_t)((rgb >> 8) & 0xFF);
+    int32_t db = (int32_t)c.blue - (int32_t)(rgb & 0xFF);
+    return dr * dr + dg * dg + db * db;
+}
+
+void WindChimePalettePreset(const lv_color_t * fixed, uint8_t count)
+{
+    if (count > WINDCHIME_PALETTE_SLOTS) count = WINDCHIME_PALETTE_SLOTS;
+    for (uint8_t i = 0; i < count; i++) {
+        slot_colors[i] = fixed[i];
+    }
+    for (uint8_t i = count; i < WINDCHIME_PALETTE_SLOTS; i++) {
+        slot_colors[i] = fixed[0];
+    }
+    slot_count = count;
+    fixed_count = count;
+}
+
+uint8_t WindChimePaletteFind(uint32_t rgb)
+{
+    uint8_t best = 0;
+    int32_t best_dist = INT32_MAX;
+    for (uint8_t i = 0; i < slot_count; i++) {
+        int32_t dist = color_distance(slot_colors[i], rgb);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = i;
+            if (dist == 0) break;
+        }
+    }
+    return best;
+}
+
+uint8_t WindChimePaletteSlot(lv_color_t color, bool * changed)
+{
+    uint32_t rgb = color_rgb(color);
+    uint8_t slot = WindChimePaletteFind(rgb);
+    if (slot_count == 0 || (color_distance(slot_colors[slot], rgb) != 0 && slot_count < WINDCHIME_PALETTE_SLOTS)) {
+        slot = slot_count++;
+        slot_colors[slot] = color;
+        *changed = true;
+    }
+    return slot;
+}
+
+void WindChimePaletteReleaseCustom(void)
+{
+    slot_count = fixed_count;
+}
+
+lv_color_t WindChimePaletteNeutral(lv_color_t color)
+{
+    // Same weights as LVGL's lv_color_luminance(); a grey converts back exactly
+    uint32_t l = (color.red * 77 + color.green * 151 + color.blue * 28) >> 8;
+    uint8_t level = (uint8_t)((l * (WINDCHIME_PALETTE_NEUTRAL - 1) + 127) / 255);
+    lv_color_t grey;
+    grey.red = grey.green = grey.blue = level;
+    return grey;
+}
+
+void WindChimePaletteGetColors(lv_color_t * colors)
+{
+    for (uint32_t i = 0; i < WINDCHIME_PALETTE_NEUTRAL; i++) {
+        uint8_t v = (uint8_t)(i * 255 / (WINDCHIME_PALETTE_NEUTRAL - 1));
+        colors[i].red = colors[i].green = colors[i].blue = v;
+    }
+    for (uint32_t s = 0; s < WINDCHIME_PALETTE_SLOTS; s++) {
+        lv_color_t c = slot_colors[s];
+        for (uint32_t j = 0; j < WINDCHIME_PALETTE_LEVELS; j++) {
+            lv_color_t * out = &colors[WINDCHIME_PALETTE_NEUTRAL + s * WINDCHIME_PALETTE_LEVELS + j];
+            out->red = (uint8_t)(c.red * (j + 1) / WINDCHIME_PALETTE_LEVELS);
+            out->green = (uint8_t)(c.green * (j + 1) / WINDCHIME_PALETTE_LEVELS);
+            out->blue = (uint8_t)(c.blue * (j + 1) / WINDCHIME_PALETTE_LEVELS);
+        }
+    }
+}
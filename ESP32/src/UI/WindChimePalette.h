@@ -0,0 +1,50 @@
+#ifndef LV_WINDCHIME_PALETTE_H
+#define LV_WINDCHIME_PALETTE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// L8 渲染用的固定索引调色板。L8 缓冲里每个字节是索引，不再是亮度：
+//   0 .. 127    灰阶 (0 黑, 127 白)。LVGL 绘制的控件在 L8 下改用 WindChimePaletteNeutral()
+//               的灰色，抗锯齿和半透明在黑底上混合后仍落在这一段
+//   128 .. 255  8 个颜色槽，每槽 16 级，从 1/16 亮度到槽的颜色。粒子和涟漪由光栅化器
+//               直接写入不透明的索引，透明度量化成级别，LVGL 不会把两个槽混在一起
+// 前几个槽固定给数据源颜色，其余按先到先得分给 MQTT 自定义颜色；槽满了就用最接近的颜色，
+// 已在屏幕上的索引不会改变含义。只有分配新槽时调色板才变化。
+#define WINDCHIME_PALETTE_NEUTRAL 128
+#define WINDCHIME_PALETTE_SLOTS 8
+#define WINDCHIME_PALETTE_LEVELS 16
+#define WINDCHIME_PALETTE_SIZE 256
+
+// 固定颜色占用槽 0 .. count-1，清空其余的槽
+void WindChimePalettePreset(const lv_color_t * fixed, uint8_t count);
+
+// 颜色所在的槽，还没有时分配一个空闲槽 (*changed 置 true)，没有空槽时用最接近的
+uint8_t WindChimePaletteSlot(lv_color_t color, bool * changed);
+// 不分配：完全相同的槽，否则最接近的 (rgb 为 0xRRGGBB)
+uint8_t WindChimePaletteFind(uint32_t rgb);
+// 没有效果在画布上时调用：自定义颜色的槽可以重新分配 (颜色保留到被覆盖为止)
+void WindChimePaletteReleaseCustom(void);
+
+// 槽内按透明度选级别，透明度量化后为 0 时返回 0 (透明/黑)
+static inline uint8_t WindChimePaletteIndex(uint8_t slot, uint8_t opa)
+{
+    uint32_t level = (opa * WINDCHIME_PALETTE_LEVELS + 128) >> 8;
+    if (level == 0) return 0;
+    return (uint8_t)(WINDCHIME_PALETTE_NEUTRAL + slot * WINDCHIME_PALETTE_LEVELS + level - 1);
+}
+
+// LVGL 绘制的控件在 L8 下使用的颜色：亮度相同的灰，索引落在灰阶段
+lv_color_t WindChimePaletteNeutral(lv_color_t color);
+
+// 256 项调色板
+void WindChimePaletteGetColors(lv_color_t * colors);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_WINDCHIME_PALETTE_H*/
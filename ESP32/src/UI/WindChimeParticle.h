@@ -0,0 +1,85 @@
+#ifndef LV_WINDCHIME_PARTICLE_H
+#define LV_WINDCHIME_PARTICLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 粒子物理 (Q16.16 定点)：不依赖 LVGL，WindChime.c 和主机测试共用
+
+#define FIX_SHIFT 16
+#define FIX_ONE (1 << FIX_SHIFT)
+#define INT_TO_FIX(v) ((int32_t)(v) << FIX_SHIFT)
+#define FIX_TO_INT(v) ((v) >> FIX_SHIFT)
+#define PARTICLE_GRAVITY (FIX_ONE / 4) // Gentle gravity for a more floaty effect
+#define PARTICLE_SPEED_STEPS 100       // 速度档位 0..99 -> 0.5 .. 3.0 px/帧
+#define PARTICLE_ALPHA_MAX 255         // LV_OPA_COVER
+
+// sin() for 0..90 degrees in Q16.16, the other quadrants are mirrored
+static const int32_t particle_sin_quarter[91] = {
+    0, 1144, 2287, 3430, 4572, 5712, 6850, 7987,
+    9121, 10252, 11380, 12505, 13626, 14742, 15855, 16962,
+    18064, 19161, 20252, 21336, 22415, 23486, 24550, 25607,
+    26656, 27697, 28729, 29753, 30767, 31772, 32768, 33754,
+    34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+    42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930,
+    48703, 49461, 50203, 50931, 51643, 52339, 53020, 53684,
+    54332, 54963, 55578, 56175, 56756, 57319, 57865, 58393,
+    58903, 59396, 59870, 60326, 60764, 61183, 61584, 61966,
+    62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+    64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446,
+    65496, 65526, 65536
+};
+
+static inline int32_t particle_sin_fix(int32_t deg) // deg in 0..359
+{
+    if (deg <= 90) return particle_sin_quarter[deg];
+    if (deg <= 180) return particle_sin_quarter[180 - deg];
+    if (deg <= 270) return -particle_sin_quarter[deg - 180];
+    return -particle_sin_quarter[360 - deg];
+}
+
+// 发射速度：方向 deg (0..359)，速度档位 speed_step (0..99)
+static inline void particle_launch(int32_t deg, int32_t speed_step, int32_t * vx, int32_t * vy)
+{
+    int32_t speed = FIX_ONE / 2 + speed_step * (FIX_ONE * 5 / 2 / PARTICLE_SPEED_STEPS);
+    *vx = (int32_t)(((int64_t)particle_sin_fix((deg + 90) % 360) * speed) >> FIX_SHIFT);
+    *vy = (int32_t)(((int64_t)particle_sin_fix(deg) * speed) >> FIX_SHIFT);
+}
+
+// 风速 wind_speed / 20 px/帧 的横向漂移
+static inline int32_t particle_wind(int16_t wind_speed)
+{
+    return INT_TO_FIX(wind_speed) / 20;
+}
+
+// 积分一帧；粒子离开 max_x x max_y (Q16.16) 的画布时返回 false
+static inline bool particle_step(int32_t * x, int32_t * y, int32_t vx, int32_t * vy,
+                                 int32_t wind, uint32_t max_x, uint32_t max_y)
+{
+    *x += vx + wind;
+    *y += *vy;
+    *vy += PARTICLE_GRAVITY;
+    // 负坐标转成无符号后是很大的数，一次比较同时判断两侧
+    return (uint32_t)*x < max_x && (uint32_t)*y < max_y;
+}
+
+// 淡出步长 (Q8.8)：alpha = life * fade >> 8，逐帧不做除法
+static inline uint16_t particle_fade_step(int16_t life)
+{
+    return (uint16_t)((PARTICLE_ALPHA_MAX << 8) / life);
+}
+
+static inline uint8_t particle_alpha(int16_t life, uint16_t fade)
+{
+    return (uint8_t)(((uint32_t)life * fade) >> 8);
+}
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_WINDCHIME_PARTICLE_H*/
@@ -0,0 +1,539 @@
+#include <Arduino.h>
+#include <lvgl.h>
+#include <esp_heap_caps.h>
+#include <math.h>
+#include "WindChimeRender.h"
+#include "WindChimeConfig.h"
+#include "WindChimePalette.h"
+
+// Number of dirty rectangles kept per frame before they get merged together
+#define RENDER_INV_SLOTS 8
+
+// Ring invalidation splits each quadrant of the annulus into up to this many
+// angular segments, one rectangle each
+#define RING_SEGMENTS_MAX 4
+#define RING_SEGMENT_RADIUS 48 // One more segment per this many px of radius
+
+#define RING_CACHE_BUCKETS (WINDCHIME_RING_CACHE_MAX_RADIUS / WINDCHIME_RING_CACHE_STEP + 1)
+
+// Dots up to this diameter use an anti-aliased mask, bigger ones plain spans
+#define DOT_MASK_MAX 8
+
+// Anti-aliased quarter ring, mirrored into the other three quadrants when
+// blitted. Row dy (0..radius) holds one run of coverage bytes starting at
+// x = span[dy].x0; all of it lives in the same PSRAM block as the header.
+typedef struct {
+    uint16_t x0;
+    uint16_t len;
+} ring_span_t;
+
+typedef struct {
+    uint16_t radius;
+    uint16_t width;
+    uint16_t rows;
+    ring_span_t * span;
+    uint8_t * cov;
+} ring_sprite_t;
+
+static lv_obj_t * render_canvas = NULL;
+static uint32_t * render_buf = NULL;
+static int32_t render_width = 0;
+static int32_t render_height = 0;
+static int32_t render_stride = 0; // in pixels
+static bool render_indexed = false;
+static bool render_invalidate_all = false;
+
+static lv_area_t inv_slots[RENDER_INV_SLOTS];
+static uint8_t inv_count = 0;
+
+// cos() of the segment boundaries in Q16.16, [segments - 1][boundary]
+static int32_t segment_cos[RING_SEGMENTS_MAX][RING_SEGMENTS_MAX + 1];
+
+static windchime_render_stats_t frame_stats;
+static windchime_render_stats_t last_stats;
+
+// Anti-aliased filled circles, [diameter - 1]: one run per row, coverage bytes
+// row by row (DOT_MASK_MAX per row, only the first span.len used)
+static ring_span_t dot_spans[DOT_MASK_MAX][DOT_MASK_MAX];
+static uint8_t dot_cov[DOT_MASK_MAX][DOT_MASK_MAX * DOT_MASK_MAX];
+
+static ring_sprite_t * ring_cache[RING_CACHE_BUCKETS];
+static bool ring_cache_skip[RING_CACHE_BUCKETS]; // Did not fit, always draw directly
+static ring_span_t ring_build_spans[WINDCHIME_RING_CACHE_MAX_RADIUS + 1];
+static windchime_ring_cache_stats_t ring_cache_stats;
+
+// =================================================================
+// --- Dirty Area Tracking ---
+// =================================================================
+
+static int32_t area_size(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    return (x2 - x1 + 1) * (y2 - y1 + 1);
+}
+
+// Hands one area (canvas coordinates) to LVGL, returns the pixels invalidated
+static uint32_t submit_area(const lv_area_t * coords, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= render_width) x2 = render_width - 1;
+    if (y2 >= render_height) y2 = render_height - 1;
+    if (x1 > x2 || y1 > y2) return 0;
+
+    lv_area_t a;
+    lv_area_set(&a, x1 + coords->x1, y1 + coords->y1, x2 + coords->x1, y2 + coords->y1);
+    lv_obj_invalidate_area(render_canvas, &a);
+    frame_stats.areas++;
+    return lv_area_get_size(&a);
+}
+
+static void render_invalidate(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    // Join with a slot if that is no bigger than keeping both apart
+    for (int i = 0; i < inv_count; i++) {
+        lv_area_t * s = &inv_slots[i];
+        int32_t jx1 = LV_MIN(s->x1, x1), jy1 = LV_MIN(s->y1, y1);
+        int32_t jx2 = LV_MAX(s->x2, x2), jy2 = LV_MAX(s->y2, y2);
+        if (area_size(jx1, jy1, jx2, jy2) <= (int32_t)lv_area_get_size(s) + area_size(x1, y1, x2, y2)) {
+            lv_area_set(s, jx1, jy1, jx2, jy2);
+            return;
+        }
+    }
+
+    if (inv_count < RENDER_INV_SLOTS) {
+        lv_area_set(&inv_slots[inv_count++], x1, y1, x2, y2);
+        return;
+    }
+
+    // Out of slots: grow the one that gets the least extra area
+    int best = 0;
+    int32_t best_growth = INT32_MAX;
+    for (int i = 0; i < inv_count; i++) {
+        lv_area_t * s = &inv_slots[i];
+        int32_t growth = area_size(LV_MIN(s->x1, x1), LV_MIN(s->y1, y1),
+                                   LV_MAX(s->x2, x2), LV_MAX(s->y2, y2)) - (int32_t)lv_area_get_size(s);
+        if (growth < best_growth) {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    lv_area_t * s = &inv_slots[best];
+    lv_area_set(s, LV_MIN(s->x1, x1), LV_MIN(s->y1, y1), LV_MAX(s->x2, x2), LV_MAX(s->y2, y2));
+}
+
+// =================================================================
+// --- Blitter ---
+// =================================================================
+
+// Indexed: the palette index as an opaque grey, which LVGL converts to
+// exactly that L8 value; nothing on the canvas is ever blended
+static inline uint32_t indexed_pixel(uint8_t index)
+{
+    return index ? 0xFF000000 | index * 0x010101u : 0;
+}
+
+// A packed colour + opacity as the canvas stores it in the current mode
+static uint32_t target_pixel(uint32_t pixel)
+{
+    if (!render_indexed || pixel == 0) return pixel;
+    uint8_t slot = WindChimePaletteFind(pixel & 0x00FFFFFF);
+    return indexed_pixel(WindChimePaletteIndex(slot, pixel >> 24));
+}
+
+static void fill_span(int32_t y, int32_t x1, int32_t x2, uint32_t pixel)
+{
+    if (y < 0 || y >= render_height) return;
+    if (x1 < 0) x1 = 0;
+    if (x2 >= render_width) x2 = render_width - 1;
+    uint32_t * p = render_buf + y * render_stride + x1;
+    for (int32_t x = x1; x <= x2; x++) {
+        *p++ = pixel;
+    }
+}
+
+static uint32_t isqrt(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+static void ring_fill_spans(int32_t cx, int32_t cy, int32_t radius, int32_t width, uint32_t pixel)
+{
+    int32_t ro2 = radius * radius;
+    int32_t ri = radius - width;
+    int32_t ri2 = ri > 0 ? ri * ri : 0;
+
+    // One or two horizontal spans per row instead of testing the whole bounding box
+    for (int32_t dy = -radius; dy <= radius; dy++) {
+        int32_t dy2 = dy * dy;
+        int32_t xo = isqrt(ro2 - dy2);
+        if (dy2 < ri2) {
+            int32_t t = ri2 - dy2;
+            int32_t xi = isqrt(t);
+            if (xi * xi < t) xi++;
+            fill_span(cy + dy, cx - xo, cx - xi, pixel);
+            fill_span(cy + dy, cx + xi, cx + xo, pixel);
+        } else {
+            fill_span(cy + dy, cx - xo, cx + xo, pixel);
+        }
+    }
+}
+
+// Coverage of pixel (k, row) by a filled circle of the given diameter whose
+// bounding square starts at (0, 0), same one pixel ramp as ring_coverage()
+static uint8_t dot_coverage(int32_t k, int32_t row, int32_t size)
+{
+    float r = size * 0.5f;
+    float dx = k + 0.5f - r, dy = row + 0.5f - r;
+    float d = sqrtf(dx * dx + dy * dy);
+    return (uint8_t)(LV_CLAMP(0.0f, r + 0.5f - d, 1.0f) * 255.0f + 0.5f);
+}
+
+static void dot_masks_build(void)
+{
+    for (int32_t size = 1; size <= DOT_MASK_MAX; size++) {
+        for (int32_t row = 0; row < size; row++) {
+            int32_t lo = 0, hi = size - 1;
+            while (lo <= hi && dot_coverage(lo, row, size) == 0) lo++;
+            while (hi >= lo && dot_coverage(hi, row, size) == 0) hi--;
+            ring_span_t * sp = &dot_spans[size - 1][row];
+            sp->x0 = lo;
+            sp->len = hi >= lo ? hi - lo + 1 : 0;
+            uint8_t * cov = &dot_cov[size - 1][row * DOT_MASK_MAX];
+            for (int32_t k = 0; k < sp->len; k++) {
+                cov[k] = dot_coverage(lo + k, row, size);
+            }
+        }
+    }
+}
+
+// Small dot from its mask; pixel 0 clears the same runs
+static void dot_blit(int32_t x, int32_t y, int32_t size, uint32_t pixel)
+{
+    uint32_t rgb = pixel & 0x00FFFFFF;
+    uint32_t opa = pixel >> 24;
+    if (opa == 0) rgb = 0;
+    else if (render_indexed) rgb = WindChimePaletteFind(rgb);
+
+    for (int32_t row = 0; row < size; row++) {
+        if (y + row < 0 || y + row >= render_height) continue;
+        const ring_span_t * sp = &dot_spans[size - 1][row];
+        const uint8_t * cov = &dot_cov[size - 1][row * DOT_MASK_MAX];
+        int32_t first = x + sp->x0;
+        int32_t k0 = 0, k1 = sp->len - 1;
+        if (first < 0) k0 = -first;
+        if (first + k1 >= render_width) k1 = render_width - 1 - first;
+
+        uint32_t * p = render_buf + (y + row) * render_stride + first;
+        for (int32_t k = k0; k <= k1; k++) {
+            uint32_t a = (cov[k] * opa + 255) >> 8;
+            if (opa == 0) p[k] = 0;
+            else if (render_indexed) p[k] = indexed_pixel(WindChimePaletteIndex(rgb, a));
+            else p[k] = rgb | (a << 24);
+        }
+    }
+}
+
+// Bigger dots: the width of each row from the circle through the pixel
+// centres, in doubled coordinates so odd and even diameters stay centred
+static void dot_fill_spans(int32_t x, int32_t y, int32_t size, uint32_t pixel)
+{
+    int32_t size2 = size * size;
+    for (int32_t row = 0; row < size; row++) {
+        int32_t dy = 2 * row + 1 - size;
+        int32_t w = isqrt(size2 - dy * dy);
+        // Columns k with |2k + 1 - size| <= w
+        int32_t k0 = (size - w) / 2;
+        int32_t k1 = (size - 1 + w) / 2;
+        fill_span(y + row, x + k0, x + k1, pixel);
+    }
+}
+
+bool WindChimeRenderInit(lv_obj_t * canvas, int32_t width, int32_t height)
+{
+    uint32_t stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_ARGB8888);
+    render_buf = (uint32_t *)heap_caps_aligned_alloc(4, stride * height, MALLOC_CAP_SPIRAM);
+    if (!render_buf) {
+        return false;
+    }
+    memset(render_buf, 0, stride * height);
+
+    render_canvas = canvas;
+    render_width = width;
+    render_height = height;
+    render_stride = stride / sizeof(uint32_t);
+    inv_count = 0;
+
+    for (int n = 1; n <= RING_SEGMENTS_MAX; n++) {
+        for (int j = 0; j <= n; j++) {
+            segment_cos[n - 1][j] = (int32_t)lroundf(cosf((float)M_PI / 2 * j / n) * 65536.0f);
+        }
+    }
+
+    dot_masks_build();
+
+    lv_canvas_set_buffer(canvas, render_buf, width, height, LV_COLOR_FORMAT_ARGB8888);
+    return true;
+}
+
+void WindChimeRenderDot(int32_t x, int32_t y, int32_t size, uint32_t pixel)
+{
+    if (!render_buf || size <= 0) return;
+    if (x >= render_width || y >= render_height || x + size <= 0 || y + size <= 0) return;
+
+    if (size <= DOT_MASK_MAX) {
+        dot_blit(x, y, size, pixel);
+    } else {
+        dot_fill_spans(x, y, size, target_pixel(pixel));
+    }
+    render_invalidate(x, y, x + size - 1, y + size - 1);
+}
+
+// =================================================================
+// --- Ring Sprite Cache ---
+// =================================================================
+
+// Coverage of pixel (dx, dy) by the annulus ri..radius, edges measured
+// to pixel centres with a one pixel linear ramp
+static uint8_t ring_coverage(int32_t dx, int32_t dy, int32_t radius, int32_t ri)
+{
+    float d = sqrtf((float)(dx * dx + dy * dy));
+    float outer = LV_CLAMP(0.0f, radius + 0.5f - d, 1.0f);
+    float inner = ri > 0 ? LV_CLAMP(0.0f, d - ri + 0.5f, 1.0f) : 1.0f;
+    return (uint8_t)(outer * inner * 255.0f + 0.5f);
+}
+
+static ring_sprite_t * ring_sprite_build(int32_t radius, int32_t width)
+{
+    int32_t ri = radius - width;
+    int32_t rows = radius + 1;
+    ring_span_t * spans = ring_build_spans;
+
+    // First pass: trimmed run of every row, to size the block
+    uint32_t total = 0;
+    for (int32_t dy = 0; dy < rows; dy++) {
+        float ro = radius + 0.5f;
+        int32_t x_hi = (int32_t)sqrtf(ro * ro - (float)(dy * dy));
+        int32_t x_lo = 0;
+        float rin = ri - 0.5f;
+        if (rin > dy) {
+            x_lo = (int32_t)sqrtf(rin * rin - (float)(dy * dy));
+        }
+        while (x_lo <= x_hi && ring_coverage(x_lo, dy, radius, ri) == 0) x_lo++;
+        while (x_hi >= x_lo && ring_coverage(x_hi, dy, radius, ri) == 0) x_hi--;
+        spans[dy].x0 = x_lo;
+        spans[dy].len = x_hi >= x_lo ? x_hi - x_lo + 1 : 0;
+        total += spans[dy].len;
+    }
+
+    uint32_t bytes = sizeof(ring_sprite_t) + rows * sizeof(ring_span_t) + total;
+    if (ring_cache_stats.bytes + bytes > WINDCHIME_RING_CACHE_BUDGET) {
+        return NULL;
+    }
+    ring_sprite_t * sprite = (ring_sprite_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!sprite) {
+        return NULL;
+    }
+
+    sprite->radius = radius;
+    sprite->width = width;
+    sprite->rows = rows;
+    sprite->span = (ring_span_t *)(sprite + 1);
+    sprite->cov = (uint8_t *)(sprite->span + rows);
+    memcpy(sprite->span, spans, rows * sizeof(ring_span_t));
+
+    uint8_t * c = sprite->cov;
+    for (int32_t dy = 0; dy < rows; dy++) {
+        for (int32_t k = 0; k < spans[dy].len; k++) {
+            *c++ = ring_coverage(spans[dy].x0 + k, dy, radius, ri);
+        }
+    }
+
+    ring_cache_stats.bytes += bytes;
+    ring_cache_stats.sprites++;
+    return sprite;
+}
+
+// Cached sprite for this radius/width, built on first use; NULL when it
+// does not fit the budget. Buckets are never evicted or retried, so a given
+// radius always resolves the same way and an erase matches its draw.
+static ring_sprite_t * ring_sprite_get(int32_t radius, int32_t width, bool count)
+{
+    int32_t bucket = radius / WINDCHIME_RING_CACHE_STEP;
+    if (radius > WINDCHIME_RING_CACHE_MAX_RADIUS || bucket == 0 || ring_cache_skip[bucket]) {
+        if (count) ring_cache_stats.fallbacks++;
+        return NULL;
+    }
+
+    ring_sprite_t * sprite = ring_cache[bucket];
+    if (sprite) {
+        if (sprite->width != width) {
+            if (count) ring_cache_stats.fallbacks++;
+            return NULL;
+        }
+        if (count) ring_cache_stats.hits++;
+        return sprite;
+    }
+
+    sprite = ring_sprite_build(bucket * WINDCHIME_RING_CACHE_STEP, width);
+    if (count) {
+        if (sprite) ring_cache_stats.misses++;
+        else ring_cache_stats.fallbacks++;
+    }
+    ring_cache[bucket] = sprite;
+    ring_cache_skip[bucket] = (sprite == NULL);
+    return sprite;
+}
+
+// Writes one mirrored run: x = cx + dir * (x0 + k). Indexed, rgb is the
+// palette slot and coverage picks the level.
+static void ring_blit_run(uint32_t * row, int32_t cx, int32_t dir, const ring_span_t * sp,
+                          const uint8_t * cov, uint32_t rgb, uint32_t opa)
+{
+    int32_t first = cx + dir * sp->x0;
+    int32_t k0 = 0, k1 = sp->len - 1;
+    if (dir > 0) {
+        if (first < 0) k0 = -first;
+        if (first + k1 >= render_width) k1 = render_width - 1 - first;
+    } else {
+        if (first >= render_width) k0 = first - (render_width - 1);
+        if (first - k1 < 0) k1 = first;
+    }
+
+    uint32_t * p = row + first + dir * k0;
+    if (opa == 0) {
+        for (int32_t k = k0; k <= k1; k++, p += dir) *p = 0;
+    } else if (render_indexed) {
+        for (int32_t k = k0; k <= k1; k++, p += dir) {
+            *p = indexed_pixel(WindChimePaletteIndex(rgb, (cov[k] * opa + 255) >> 8));
+        }
+    } else {
+        for (int32_t k = k0; k <= k1; k++, p += dir) {
+            *p = rgb | (((cov[k] * opa + 255) >> 8) << 24);
+        }
+    }
+}
+
+static void ring_sprite_blit(const ring_sprite_t * sprite, int32_t cx, int32_t cy, uint32_t pixel)
+{
+    uint32_t rgb = pixel & 0x00FFFFFF;
+    uint32_t opa = pixel >> 24;
+    if (opa == 0) rgb = 0; // Erase: clear the whole footprint
+    else if (render_indexed) rgb = WindChimePaletteFind(rgb);
+
+    const uint8_t * cov = sprite->cov;
+    for (int32_t dy = 0; dy < sprite->rows; cov += sprite->span[dy].len, dy++) {
+        const ring_span_t * sp = &sprite->span[dy];
+        if (sp->len == 0) continue;
+
+        for (int32_t side = 0; side < 2; side++) {
+            int32_t y = side ? cy - dy : cy + dy;
+            if (side && dy == 0) break;
+            if (y < 0 || y >= render_height) continue;
+            uint32_t * row = render_buf + y * render_stride;
+            ring_blit_run(row, cx, 1, sp, cov, rgb, opa);
+            ring_blit_run(row, cx, -1, sp, cov, rgb, opa);
+        }
+    }
+}
+
+void WindChimeRenderRing(int32_t cx, int32_t cy, int32_t radius, int32_t width, uint32_t pixel)
+{
+    if (!render_buf || radius <= 0) return;
+
+    ring_sprite_t * sprite = ring_sprite_get(radius, width, pixel != 0);
+    if (sprite) {
+        ring_sprite_blit(sprite, cx, cy, pixel);
+    } else {
+        ring_fill_spans(cx, cy, radius, width, target_pixel(pixel));
+    }
+}
+
+void WindChimeRenderInvalidateRing(int32_t cx, int32_t cy, int32_t inner, int32_t outer)
+{
+    if (!render_canvas || outer <= 0) return;
+    if (inner < 0) inner = 0;
+
+    lv_area_t coords;
+    lv_obj_get_coords(render_canvas, &coords);
+
+    int32_t n = outer / RING_SEGMENT_RADIUS + 1;
+    if (n > RING_SEGMENTS_MAX) n = RING_SEGMENTS_MAX;
+    const int32_t * c = segment_cos[n - 1];
+
+    // A quadrant segment between angles a0 < a1 is bounded by
+    // x in [inner * cos(a1), outer * cos(a0)] and y in [inner * sin(a0), outer * sin(a1)],
+    // with sin(a) = cos(90 - a) read from the mirrored boundary. Pad by one
+    // pixel for rounding and mirror into all four quadrants.
+    uint32_t px = 0;
+    for (int32_t j = 0; j < n; j++) {
+        int32_t x0 = ((inner * c[j + 1]) >> 16) - 1;
+        int32_t x1 = ((outer * c[j] + 0xFFFF) >> 16) + 1;
+        int32_t y0 = ((inner * c[n - j]) >> 16) - 1;
+        int32_t y1 = ((outer * c[n - j - 1] + 0xFFFF) >> 16) + 1;
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+
+        px += submit_area(&coords, cx + x0, cy + y0, cx + x1, cy + y1);
+        px += submit_area(&coords, cx - x1, cy + y0, cx - x0, cy + y1);
+        px += submit_area(&coords, cx + x0, cy - y1, cx + x1, cy - y0);
+        px += submit_area(&coords, cx - x1, cy - y1, cx - x0, cy - y0);
+    }
+
+    frame_stats.ring_px += px;
+    frame_stats.ring_bbox_px += (2 * outer + 1) * (2 * outer + 1);
+    frame_stats.invalidated_px += px;
+}
+
+void WindChimeRenderFlush(void)
+{
+    if (!render_canvas) return;
+
+    lv_area_t coords;
+    lv_obj_get_coords(render_canvas, &coords);
+    if (render_invalidate_all) {
+        // Everything was redrawn in the new pixel format
+        inv_count = 0;
+        frame_stats.invalidated_px += submit_area(&coords, 0, 0, render_width - 1, render_height - 1);
+        render_invalidate_all = false;
+    }
+    for (int i = 0; i < inv_count; i++) {
+        lv_area_t * a = &inv_slots[i];
+        frame_stats.invalidated_px += submit_area(&coords, a->x1, a->y1, a->x2, a->y2);
+    }
+    inv_count = 0;
+
+    last_stats = frame_stats;
+    memset(&frame_stats, 0, sizeof(frame_stats));
+}
+
+void WindChimeRenderSetIndexed(bool indexed)
+{
+    if (!render_buf || indexed == render_indexed) return;
+    render_indexed = indexed;
+    // Old pixels mean something else now; live effects are drawn again next frame
+    memset(render_buf, 0, render_stride * sizeof(uint32_t) * render_height);
+    lv_obj_invalidate(render_canvas);
+    render_invalidate_all = true;
+}
+
+const windchime_render_stats_t * WindChimeRenderGetStats(void)
+{
+    return &last_stats;
+}
+
+const windchime_ring_cache_stats_t * WindChimeRenderGetRingCacheStats(void)
+{
+    return &ring_cache_stats;
+}
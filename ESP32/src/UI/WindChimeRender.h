@@ -0,0 +1,65 @@
+#ifndef LV_WINDCHIME_RENDER_H
+#define LV_WINDCHIME_RENDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <lvgl.h>
+
+// 粒子/涟漪光栅化器：直接写入 main_canvas 的 ARGB8888 缓冲区，
+// 代替每个效果一个 lv_obj 的做法
+
+// 把颜色和透明度打包成画布像素 (ARGB8888, 非预乘)
+static inline uint32_t WindChimeRenderPixel(lv_color_t color, lv_opa_t opa)
+{
+    return (lv_color_to_u32(color) & 0x00FFFFFF) | ((uint32_t)opa << 24);
+}
+
+// 每帧交给 LVGL 的脏区域统计 (上一帧)
+typedef struct {
+    uint32_t invalidated_px;  // 总失效像素
+    uint32_t ring_px;         // 其中涟漪环带的像素
+    uint32_t ring_bbox_px;    // 按整个外接正方形失效时涟漪需要的像素 (对比用)
+    uint16_t areas;           // 矩形数量
+} windchime_render_stats_t;
+
+// 抗锯齿圆环缓存统计 (累计)
+typedef struct {
+    uint32_t hits;            // 命中已缓存的圆环
+    uint32_t misses;          // 未命中，新生成一个圆环
+    uint32_t fallbacks;       // 超出预算/半径，直接绘制
+    uint32_t bytes;           // 已占用的 PSRAM
+    uint16_t sprites;         // 已缓存的圆环数
+} windchime_ring_cache_stats_t;
+
+// 分配画布缓冲区 (PSRAM) 并挂到 canvas 上
+bool WindChimeRenderInit(lv_obj_t * canvas, int32_t width, int32_t height);
+
+// 圆形粒子点，直径 size，外接正方形左上角为 (x, y)。小点 (直径 ≤ 8) 边缘抗锯齿，
+// 和原来 LV_RADIUS_CIRCLE 的 lv_obj 一样；pixel 为 0 时擦除同样的像素
+void WindChimeRenderDot(int32_t x, int32_t y, int32_t size, uint32_t pixel);
+
+// 圆环：外半径 radius，向内宽度 width，边缘抗锯齿 (向外最多多出1px)
+// 用缓存的 A8 遮罩着色绘制；pixel 为 0 时擦除同样的区域
+// 不会自动失效，调用者用 WindChimeRenderInvalidateRing() 提交变化的环带
+void WindChimeRenderRing(int32_t cx, int32_t cy, int32_t radius, int32_t width, uint32_t pixel);
+
+// 只失效 inner..outer 之间的环带 (每个象限几个细矩形)，而不是整个外接正方形
+void WindChimeRenderInvalidateRing(int32_t cx, int32_t cy, int32_t inner, int32_t outer);
+
+// 把本帧累计的脏区域提交给 LVGL
+void WindChimeRenderFlush(void);
+
+// L8 渲染时打开：像素按 WindChimePalette 写成不透明的索引 (灰度值即索引)，
+// 透明度和涟漪边缘的覆盖率量化为槽内级别。切换时清空画布，效果下一帧重画
+void WindChimeRenderSetIndexed(bool indexed);
+
+const windchime_render_stats_t * WindChimeRenderGetStats(void);
+const windchime_ring_cache_stats_t * WindChimeRenderGetRingCacheStats(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_WINDCHIME_RENDER_H*/
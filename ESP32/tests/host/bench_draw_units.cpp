@@ -0,0 +1,110 @@
+// LVGL's SW renderer with one draw unit against two (LV_DRAW_SW_DRAW_UNIT_CNT,
+// threads on LV_OS_PTHREAD) on the WindChime screen. `make bench-draw-units`
+// builds LVGL and this program once per count and runs both:
+//
+//   bench_draw_units RESULT [REFERENCE]
+//
+// Two loads, wall time since the draw units run in parallel: the replay trace
+// of bench_replay frame by frame, then full-screen redraws with the burst's
+// particles, ripples, orb shadow and log labels all on screen. The result is
+// written to RESULT; given the one-unit REFERENCE, the speedup is printed and
+// the framebuffer has to be identical, only the time may change.
+
+#include <stdio.h>
+#include <Arduino.h>
+#include "host_test.h"
+#include "lvgl_host.h"
+#include "../../src/UI/ReplayTrace.h"
+#include "../../src/UI/WindChime.h"
+
+#define SCREEN 480
+#define SEED 12345
+#define FULL_REDRAWS 50
+
+struct Result
+{
+  double replay_us;   // Whole trace
+  double full_us;     // Per full-screen redraw
+  uint32_t replay_hash;
+  uint32_t full_hash;
+};
+
+static void noop_event_cb(lv_event_t * e)
+{
+  LV_UNUSED(e);
+}
+
+static Result run(void)
+{
+  Result res = {};
+  lvgl_host_init(SCREEN, SCREEN);
+  WindChimeScreenCreate(noop_event_cb);
+  lv_screen_load(windchime_screen);
+  WindChimeUpdateWeather(10, 20);
+  lvgl_host_refresh(NULL);
+
+  replay_trace_t trace;
+  ReplayTraceInit(&trace, SEED);
+  uint32_t burst_mid = ReplayTracePhaseFrames(0) + ReplayTracePhaseFrames(1) + ReplayTracePhaseFrames(2) / 2;
+  lvgl_host_stats stats;
+  while (ReplayTraceStep(&trace))
+  {
+    lvgl_host_step(ReplayTraceFrameMs(), &stats);
+    res.replay_us += stats.render_us;
+
+    // Half way into the burst the screen is at its busiest: redraw all of it,
+    // the effects stand still since no timer runs in between
+    if (trace.frame == burst_mid)
+    {
+      for (int i = 0; i < FULL_REDRAWS; i++)
+      {
+        lv_obj_invalidate(lv_screen_active());
+        lvgl_host_refresh(&stats);
+        res.full_us += stats.render_us;
+      }
+      res.full_hash = lvgl_host_hash();
+    }
+  }
+  res.full_us /= FULL_REDRAWS;
+  res.replay_hash = lvgl_host_hash();
+  return res;
+}
+
+int main(int argc, char ** argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "usage: %s RESULT [REFERENCE]\n", argv[0]);
+    return 2;
+  }
+
+  Result res = run();
+  printf("%d draw units: replay %8.1f ms, full redraw %8.1f us, framebuffer %08x / %08x\n",
+         LV_DRAW_SW_DRAW_UNIT_CNT, res.replay_us / 1000, res.full_us, res.replay_hash, res.full_hash);
+
+  FILE * out = fopen(argv[1], "w");
+  CHECK(out != NULL);
+  if (out)
+  {
+    fprintf(out, "%f %f %08x %08x\n", res.replay_us, res.full_us, res.replay_hash, res.full_hash);
+    fclose(out);
+  }
+
+  if (argc > 2)
+  {
+    Result ref = {};
+    FILE * in = fopen(argv[2], "r");
+    CHECK(in != NULL);
+    if (in)
+    {
+      CHECK_EQ(fscanf(in, "%lf %lf %x %x", &ref.replay_us, &ref.full_us, &ref.replay_hash, &ref.full_hash), 4);
+      fclose(in);
+    }
+    printf("speedup over the reference: replay %.2fx, full redraw %.2fx\n",
+           res.replay_us > 0 ? ref.replay_us / res.replay_us : 0.0,
+           res.full_us > 0 ? ref.full_us / res.full_us : 0.0);
+    CHECK_EQ(res.replay_hash, ref.replay_hash);
+    CHECK_EQ(res.full_hash, ref.full_hash);
+  }
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,376 @@
+// Particles and ripples drawn the old way, one styled lv_obj each (as in
+// WindChime.c before the canvas rasterizer), against WindChimeRender writing
+// into the canvas buffer. Both run the same deterministic effect simulation on
+// the real LVGL (make LVGL_DIR=... bench) and report the time per frame for
+// the object updates plus LVGL's rendering, the flushed pixels and the peak
+// LVGL heap. Before that, one dot of each kind is compared pixel by pixel:
+// the canvas dots must be round like the LV_RADIUS_CIRCLE objects.
+
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "host_test.h"
+#include "lvgl_host.h"
+#include "../../src/UI/WindChimeRender.h"
+
+#define SCREEN 480
+#define FRAMES 120
+#define FRAME_MS 50 // WINDCHIME_ANIMATION_FPS 20
+#define RIPPLES 8   // WINDCHIME_MAX_RIPPLES
+#define RIPPLE_BORDER_WIDTH 2
+
+struct Particle
+{
+  float x, y, vx, vy;
+  int16_t life, max_life;
+  uint8_t size;
+  lv_color_t color;
+  int32_t drawn_x, drawn_y, drawn_size;
+};
+
+struct Ripple
+{
+  int32_t x, y, radius, max_radius, drawn_radius;
+  uint8_t alpha;
+  lv_color_t color;
+};
+
+static std::vector<Particle> particles;
+static Ripple ripples[RIPPLES];
+static uint32_t seed;
+
+static uint32_t next_rand(void)
+{
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 16) & 0x7FFF;
+}
+
+static lv_color_t source_color(void)
+{
+  static const uint32_t colors[3] = { 0x4A90E2, 0x7B68EE, 0x50C878 };
+  return lv_color_hex(colors[next_rand() % 3]);
+}
+
+static void spawn_particle(Particle &p)
+{
+  float angle = (next_rand() % 360) * (float)M_PI / 180.0f;
+  float speed = 0.5f + (next_rand() % 100) / 40.0f;
+  p.x = 60 + next_rand() % (SCREEN - 120);
+  p.y = 60 + next_rand() % (SCREEN - 180);
+  p.vx = cosf(angle) * speed;
+  p.vy = sinf(angle) * speed - 2.0f;
+  p.life = p.max_life = 80 + next_rand() % 60;
+  p.size = 2 + next_rand() % 2;
+  p.color = source_color();
+}
+
+static void spawn_ripple(Ripple &r)
+{
+  r.x = 60 + next_rand() % (SCREEN - 120);
+  r.y = 60 + next_rand() % (SCREEN - 120);
+  r.radius = 0;
+  r.max_radius = 50 + next_rand() % 200;
+  r.alpha = 255;
+  r.color = source_color();
+}
+
+// Every effect is respawned as soon as it dies, so the live count stays at n
+static void effects_reset(int n)
+{
+  seed = 1;
+  particles.assign(n, Particle());
+  for (Particle &p : particles) spawn_particle(p);
+  for (Ripple &r : ripples)
+  {
+    spawn_ripple(r);
+    r.radius = next_rand() % r.max_radius;
+  }
+}
+
+static void effects_step(void)
+{
+  for (Particle &p : particles)
+  {
+    p.x += p.vx;
+    p.y += p.vy;
+    p.vy += 0.25f;
+    if (--p.life <= 0 || p.x < 0 || p.x >= SCREEN || p.y < 0 || p.y >= SCREEN) spawn_particle(p);
+  }
+  for (Ripple &r : ripples)
+  {
+    r.radius += 2;
+    if (r.radius >= r.max_radius) spawn_ripple(r);
+    r.alpha = (uint8_t)(255 * (1.0f - (float)r.radius / r.max_radius));
+  }
+}
+
+static uint8_t particle_alpha(const Particle &p)
+{
+  return (uint8_t)(p.life * 255 / p.max_life);
+}
+
+// --- One lv_obj per effect, the code WindChime.c had before the rasterizer ---
+
+static lv_obj_t * obj_layer = NULL;
+static std::vector<lv_obj_t *> particle_objects;
+static lv_obj_t * ripple_objects[RIPPLES];
+
+static void objects_create(size_t n)
+{
+  obj_layer = lv_obj_create(lv_screen_active());
+  lv_obj_remove_style_all(obj_layer);
+  lv_obj_set_size(obj_layer, SCREEN, SCREEN);
+  particle_objects.resize(n);
+  for (lv_obj_t *&o : particle_objects)
+  {
+    o = lv_obj_create(obj_layer);
+    lv_obj_set_size(o, 4, 4);
+    lv_obj_set_style_radius(o, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+    lv_obj_set_style_border_width(o, 0, LV_PART_MAIN);
+    lv_obj_add_flag(o, LV_OBJ_FLAG_HIDDEN);
+  }
+  for (lv_obj_t *&o : ripple_objects)
+  {
+    o = lv_obj_create(obj_layer);
+    lv_obj_set_style_radius(o, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(o, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(o, RIPPLE_BORDER_WIDTH, LV_PART_MAIN);
+    lv_obj_add_flag(o, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+static void objects_update(void)
+{
+  for (size_t i = 0; i < particles.size(); i++)
+  {
+    const Particle &p = particles[i];
+    lv_obj_t * o = particle_objects[i];
+    lv_obj_clear_flag(o, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_pos(o, (int16_t)p.x, (int16_t)p.y);
+    lv_obj_set_size(o, p.size, p.size);
+    lv_obj_set_style_bg_color(o, p.color, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(o, particle_alpha(p), LV_PART_MAIN);
+  }
+  for (int i = 0; i < RIPPLES; i++)
+  {
+    const Ripple &r = ripples[i];
+    lv_obj_t * o = ripple_objects[i];
+    lv_obj_clear_flag(o, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_size(o, r.radius * 2, r.radius * 2);
+    lv_obj_set_pos(o, r.x - r.radius, r.y - r.radius);
+    lv_obj_set_style_border_color(o, r.color, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(o, r.alpha, LV_PART_MAIN);
+  }
+}
+
+static void objects_delete(void)
+{
+  lv_obj_delete(obj_layer);
+  obj_layer = NULL;
+}
+
+// --- The canvas rasterizer, as update_visual_objects() drives it ---
+
+static lv_obj_t * canvas = NULL;
+
+static void canvas_erase(void)
+{
+  for (Ripple &r : ripples)
+  {
+    if (r.drawn_radius > 0)
+    {
+      WindChimeRenderRing(r.x, r.y, r.drawn_radius, RIPPLE_BORDER_WIDTH, 0);
+      WindChimeRenderInvalidateRing(r.x, r.y, r.drawn_radius - RIPPLE_BORDER_WIDTH, r.drawn_radius);
+      r.drawn_radius = 0;
+    }
+  }
+  for (Particle &p : particles)
+  {
+    if (p.drawn_size > 0)
+    {
+      WindChimeRenderDot(p.drawn_x, p.drawn_y, p.drawn_size, 0);
+      p.drawn_size = 0;
+    }
+  }
+}
+
+static void canvas_update(void)
+{
+  canvas_erase();
+  for (Ripple &r : ripples)
+  {
+    if (r.radius > 0)
+    {
+      WindChimeRenderRing(r.x, r.y, r.radius, RIPPLE_BORDER_WIDTH, WindChimeRenderPixel(r.color, r.alpha));
+      WindChimeRenderInvalidateRing(r.x, r.y, r.radius - RIPPLE_BORDER_WIDTH, r.radius);
+      r.drawn_radius = r.radius;
+    }
+  }
+  for (Particle &p : particles)
+  {
+    p.drawn_x = (int32_t)p.x;
+    p.drawn_y = (int32_t)p.y;
+    p.drawn_size = p.size;
+    WindChimeRenderDot(p.drawn_x, p.drawn_y, p.drawn_size, WindChimeRenderPixel(p.color, particle_alpha(p)));
+  }
+  WindChimeRenderFlush();
+}
+
+// --- Shape ---
+
+struct Dot3
+{
+  uint16_t px[3][3];
+};
+
+static Dot3 read_dot(int32_t x, int32_t y)
+{
+  Dot3 d;
+  for (int r = 0; r < 3; r++)
+    for (int c = 0; c < 3; c++) d.px[r][c] = lvgl_host_pixel(x + c, y + r);
+  return d;
+}
+
+static uint32_t red5(uint16_t px)
+{
+  return px >> 11;
+}
+
+static void print_dot(const char * name, const Dot3 &d)
+{
+  printf("%s 3px dot, red channel:", name);
+  for (int r = 0; r < 3; r++) printf(" %2u %2u %2u |", red5(d.px[r][0]), red5(d.px[r][1]), red5(d.px[r][2]));
+  printf("\n");
+}
+
+static void test_dot_shape(void)
+{
+  const int32_t x = 100, y = 100;
+  lv_color_t red = lv_color_hex(0xFF0000);
+
+  objects_create(1);
+  lv_obj_t * o = particle_objects[0];
+  lv_obj_clear_flag(o, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_set_pos(o, x, y);
+  lv_obj_set_size(o, 3, 3);
+  lv_obj_set_style_bg_color(o, red, LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(o, LV_OPA_COVER, LV_PART_MAIN);
+  lvgl_host_refresh(NULL);
+  Dot3 obj_dot = read_dot(x, y);
+  objects_delete();
+  lvgl_host_refresh(NULL);
+
+  lv_obj_clear_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  WindChimeRenderDot(x, y, 3, WindChimeRenderPixel(red, LV_OPA_COVER));
+  WindChimeRenderFlush();
+  lvgl_host_refresh(NULL);
+  Dot3 canvas_dot = read_dot(x, y);
+  WindChimeRenderDot(x, y, 3, 0);
+  WindChimeRenderFlush();
+  lvgl_host_refresh(NULL);
+  lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+
+  print_dot("lv_obj", obj_dot);
+  print_dot("canvas", canvas_dot);
+  // Full colour in the middle, dimmer corners, symmetric
+  CHECK_EQ(canvas_dot.px[1][1], obj_dot.px[1][1]);
+  CHECK(red5(canvas_dot.px[0][0]) < red5(canvas_dot.px[1][1]));
+  CHECK_EQ(canvas_dot.px[0][0], canvas_dot.px[2][2]);
+  CHECK_EQ(canvas_dot.px[0][1], canvas_dot.px[1][0]);
+  // The erase left nothing behind
+  CHECK_EQ(lvgl_host_pixel(x, y), 0);
+}
+
+// --- Benchmark ---
+
+struct CaseResult
+{
+  double frame_us;    // Effect updates + LVGL rendering
+  double render_us;   // LVGL rendering alone
+  uint32_t flushed_px;
+  uint32_t peak_mem;
+};
+
+static CaseResult run_case(size_t n, bool objects)
+{
+  effects_reset((int)n);
+  if (objects) objects_create(n);
+  else lv_obj_clear_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  lvgl_host_refresh(NULL);
+
+  CaseResult res = {};
+  for (int f = 0; f < FRAMES; f++)
+  {
+    effects_step();
+    auto start = std::chrono::steady_clock::now();
+    if (objects) objects_update();
+    else canvas_update();
+    double update_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    lvgl_host_stats stats;
+    lvgl_host_refresh(&stats);
+    res.frame_us += update_us + stats.render_us;
+    res.render_us += stats.render_us;
+    res.flushed_px += stats.flushed_px;
+  }
+  res.peak_mem = lvgl_host_peak_mem();
+
+  if (objects)
+  {
+    objects_delete();
+  }
+  else
+  {
+    canvas_erase();
+    WindChimeRenderFlush();
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  }
+  lvgl_host_refresh(NULL);
+
+  res.frame_us /= FRAMES;
+  res.render_us /= FRAMES;
+  res.flushed_px /= FRAMES;
+  return res;
+}
+
+static void print_case(const char * name, size_t n, const CaseResult &r)
+{
+  printf("%-6s %4zu particles + %d ripples: %8.1f us/frame (LVGL %8.1f), %6u px flushed/frame, peak LVGL heap %u B\n",
+         name, n, RIPPLES, r.frame_us, r.render_us, r.flushed_px, r.peak_mem);
+}
+
+static void test_bench(void)
+{
+  // The object counts stay within LV_MEM_SIZE; 30 was WINDCHIME_MAX_PARTICLES with objects
+  static const size_t obj_counts[] = { 30, 100, 200 };
+  for (size_t n : obj_counts)
+  {
+    CaseResult obj = run_case(n, true);
+    CaseResult cnv = run_case(n, false);
+    print_case("lv_obj", n, obj);
+    print_case("canvas", n, cnv);
+    printf("       canvas/lv_obj frame time %.2fx\n", obj.frame_us > 0 ? cnv.frame_us / obj.frame_us : 0.0);
+    CHECK(obj.flushed_px > 0);
+    CHECK(cnv.flushed_px > 0);
+  }
+  // WINDCHIME_MAX_PARTICLES now, out of reach for objects
+  CaseResult full = run_case(1024, false);
+  print_case("canvas", 1024, full);
+  CHECK(full.flushed_px > 0);
+}
+
+int main(void)
+{
+  lvgl_host_init(SCREEN, SCREEN);
+  lv_obj_set_style_bg_color(lv_screen_active(), lv_color_black(), LV_PART_MAIN);
+
+  canvas = lv_canvas_create(lv_screen_active());
+  lv_obj_set_size(canvas, SCREEN, SCREEN);
+  CHECK(WindChimeRenderInit(canvas, SCREEN, SCREEN));
+  lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+  lvgl_host_refresh(NULL);
+
+  test_dot_shape();
+  test_bench();
+  return HOST_TEST_RESULT();
+}
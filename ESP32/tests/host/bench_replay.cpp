@@ -0,0 +1,209 @@
+// The device's ReplayBench on the host: WindChime.c, DataSimulator.c and
+// Screenbase.c on the real LVGL (make LVGL_DIR=... bench), fed the same
+// frame-indexed trace (src/UI/ReplayTrace.c) one animation frame at a time on
+// the simulated clock. Per trace phase it reports the time per frame (LVGL
+// timers and rendering, and PerfMonitor's animation callback), the invalidated
+// and flushed pixels, then the peak LVGL heap and ring cache. After the trace,
+// DataSimulator drives the screen for a while and the screen is switched to a
+// BaseScreenSetup screen and back, as the buttons do on the device.
+//
+// The run is done twice in separate processes: event counts, pixels and the
+// final framebuffer must match exactly, only the times may differ.
+
+#include <algorithm>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include <Arduino.h>
+#include "host_test.h"
+#include "lvgl_host.h"
+#include "../../src/UI/ReplayTrace.h"
+#include "../../src/UI/WindChime.h"
+#include "../../src/UI/WindChimeConfig.h"
+#include "../../src/UI/WindChimeRender.h"
+#include "../../src/UI/DataSimulator.h"
+#include "../../src/UI/Screenbase.h"
+#include "../../src/Core/PerfMonitor.h"
+
+#define SCREEN 480
+#define SEED 12345
+#define SIMULATOR_FRAMES 600 // 30 s at 20 fps: a few GitHub/Wiki events and one weather update
+
+// What two runs must agree on
+struct Signature
+{
+  uint32_t events;
+  uint32_t frames;
+  uint32_t invalidated_px;
+  uint32_t flushes;
+  uint32_t flushed_px;
+  uint32_t peak_mem;
+  uint32_t ring_bytes;
+  uint32_t hash;
+};
+
+struct PhaseResult
+{
+  uint32_t frames;
+  uint32_t events;
+  uint32_t invalidated_px;
+  uint32_t flushes;
+  uint32_t flushed_px;
+  std::vector<double> step_us;
+  perf_summary_t callback;
+};
+
+static void noop_event_cb(lv_event_t * e)
+{
+  LV_UNUSED(e);
+}
+
+static double percentile(std::vector<double> v, int pct)
+{
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[std::min(v.size() - 1, v.size() * pct / 100)];
+}
+
+static void phase_begin(PhaseResult &r)
+{
+  r = PhaseResult();
+  PerfMonitor_Reset();
+}
+
+static void phase_frame(PhaseResult &r)
+{
+  lvgl_host_stats stats;
+  lvgl_host_step(ReplayTraceFrameMs(), &stats);
+  r.frames++;
+  r.step_us.push_back(stats.render_us);
+  r.flushes += stats.flushes;
+  r.flushed_px += stats.flushed_px;
+}
+
+static void phase_end(PhaseResult &r, Signature &sig)
+{
+  r.invalidated_px = PerfMonitor_GetCounter(PERF_COUNTER_INVALIDATED_PX);
+  PerfMonitor_GetSummary(PERF_PHASE_FRAME, &r.callback);
+  sig.frames += r.frames;
+  sig.invalidated_px += r.invalidated_px;
+  sig.flushes += r.flushes;
+  sig.flushed_px += r.flushed_px;
+}
+
+static void print_phase(const char * name, const PhaseResult &r)
+{
+  uint32_t frames = r.frames ? r.frames : 1;
+  printf("%-9s %4u frames %5u events | step us p50 %7.1f p95 %7.1f max %7.1f | callback us p50 %5u p95 %5u max %5u"
+         " | %6u px invalidated/frame, %6u px in %4u flushes/frame\n",
+         name, r.frames, r.events, percentile(r.step_us, 50), percentile(r.step_us, 95), percentile(r.step_us, 100),
+         r.callback.p50_us, r.callback.p95_us, r.callback.max_us,
+         r.invalidated_px / frames, r.flushed_px / frames, r.flushes / frames);
+}
+
+static Signature run_replay(bool report)
+{
+  Signature sig = {};
+  lvgl_host_init(SCREEN, SCREEN);
+  WindChimeScreenCreate(noop_event_cb);
+  lv_screen_load(windchime_screen);
+  WindChimeUpdateWeather(10, 20);
+  lvgl_host_refresh(NULL);
+
+  if (report)
+  {
+    printf("config: %d particles, %d ripples, %d fps, ring cache %u bytes, %d draw units, seed %u\n",
+           WINDCHIME_MAX_PARTICLES, WINDCHIME_MAX_RIPPLES, WINDCHIME_ANIMATION_FPS,
+           (unsigned)WINDCHIME_RING_CACHE_BUDGET, LV_DRAW_SW_DRAW_UNIT_CNT, SEED);
+  }
+
+  replay_trace_t trace;
+  ReplayTraceInit(&trace, SEED);
+  PhaseResult r;
+  while (trace.phase < ReplayTracePhaseCount())
+  {
+    uint8_t phase = trace.phase;
+    uint32_t emitted = trace.emitted;
+    phase_begin(r);
+    while (trace.phase == phase)
+    {
+      ReplayTraceStep(&trace);
+      phase_frame(r);
+    }
+    r.events = trace.emitted - emitted;
+    phase_end(r, sig);
+    if (report) print_phase(ReplayTracePhaseName(phase), r);
+  }
+  sig.events = trace.emitted;
+
+  // The event sources of the device without MQTT, on the same clock
+  phase_begin(r);
+  DataSimulatorInit();
+  DataSimulatorStart();
+  for (int f = 0; f < SIMULATOR_FRAMES; f++) phase_frame(r);
+  DataSimulatorStop();
+  phase_end(r, sig);
+  if (report) print_phase("simulator", r);
+
+  // Away to a navigation screen and back: two full redraws
+  lv_obj_t * other = lv_obj_create(NULL);
+  BaseScreenSetup(other, noop_event_cb);
+  phase_begin(r);
+  lv_screen_load(other);
+  phase_frame(r);
+  lv_screen_load(windchime_screen);
+  phase_frame(r);
+  phase_end(r, sig);
+  if (report) print_phase("switch", r);
+
+  sig.peak_mem = lvgl_host_peak_mem();
+  sig.ring_bytes = WindChimeRenderGetRingCacheStats()->bytes;
+  sig.hash = lvgl_host_hash();
+  if (report)
+  {
+    printf("total: %u events, %u frames, peak LVGL heap %u B, ring cache %u B, framebuffer %08x\n",
+           sig.events, sig.frames, sig.peak_mem, sig.ring_bytes, sig.hash);
+  }
+  return sig;
+}
+
+// LVGL and WindChime keep their state in globals: a fresh process per run
+static bool run_child(bool report, Signature * sig)
+{
+  int fds[2];
+  if (pipe(fds) != 0) return false;
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0)
+  {
+    close(fds[0]);
+    Signature s = run_replay(report);
+    fflush(stdout);
+    _exit(write(fds[1], &s, sizeof(s)) == (ssize_t)sizeof(s) ? 0 : 1);
+  }
+  close(fds[1]);
+  bool ok = pid > 0 && read(fds[0], sig, sizeof(*sig)) == (ssize_t)sizeof(*sig);
+  close(fds[0]);
+  int status = 0;
+  if (pid > 0) waitpid(pid, &status, 0);
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(void)
+{
+  Signature a = {}, b = {};
+  CHECK(run_child(true, &a));
+  CHECK(run_child(false, &b));
+
+  CHECK(a.events > 0);
+  CHECK(a.flushed_px > 0);
+  CHECK_EQ(a.events, b.events);
+  CHECK_EQ(a.frames, b.frames);
+  CHECK_EQ(a.invalidated_px, b.invalidated_px);
+  CHECK_EQ(a.flushes, b.flushes);
+  CHECK_EQ(a.flushed_px, b.flushed_px);
+  CHECK_EQ(a.peak_mem, b.peak_mem);
+  CHECK_EQ(a.ring_bytes, b.ring_bytes);
+  CHECK_EQ(a.hash, b.hash);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,37 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+// 主机测试的断言：失败时打印位置，不中断，main() 最后返回 HOST_TEST_RESULT()
+
+#include <stdio.h>
+#include <stdint.h>
+
+static int host_test_checks = 0;
+static int host_test_failures = 0;
+
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    host_test_checks++;                                                      \
+    if (!(cond)) {                                                           \
+      host_test_failures++;                                                  \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    }                                                                        \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                       \
+  do {                                                                       \
+    long long _a = (long long)(a), _b = (long long)(b);                      \
+    host_test_checks++;                                                      \
+    if (_a != _b) {                                                          \
+      host_test_failures++;                                                  \
+      fprintf(stderr, "%s:%d: %s == %s failed: %lld != %lld\n",              \
+              __FILE__, __LINE__, #a, #b, _a, _b);                           \
+    }                                                                        \
+  } while (0)
+
+#define HOST_TEST_RESULT()                                                   \
+  (printf("%s: %d checks, %d failed\n", __FILE__, host_test_checks,          \
+          host_test_failures),                                               \
+   host_test_failures ? 1 : 0)
+
+#endif // HOST_TEST_H
@@ -0,0 +1,14 @@
+#ifndef HOST_LV_CONF_H
+#define HOST_LV_CONF_H
+
+// Host builds of the real LVGL (make LVGL_DIR=... bench) use the sketch's own
+// configuration; only what cannot work on a desktop is changed below.
+#include "../../../lv_conf.h.readymade"
+
+// Fail the run instead of spinning forever
+#undef LV_ASSERT_HANDLER
+#define LV_ASSERT_HANDLER abort();
+#undef LV_ASSERT_HANDLER_INCLUDE
+#define LV_ASSERT_HANDLER_INCLUDE <stdlib.h>
+
+#endif // HOST_LV_CONF_H
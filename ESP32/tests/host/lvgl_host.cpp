@@ -0,0 +1,88 @@
+#include <chrono>
+#include <stdlib.h>
+#include "lvgl_host.h"
+#include <Arduino.h>
+
+static lv_display_t * host_disp = NULL;
+static uint8_t * host_fb = NULL;
+static uint32_t host_fb_size = 0;
+static lvgl_host_stats host_counts;
+
+static uint32_t host_tick(void)
+{
+  return millis();
+}
+
+static void host_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+  LV_UNUSED(px_map);
+  host_counts.flushes++;
+  host_counts.flushed_px += lv_area_get_size(area);
+  if (lv_display_flush_is_last(disp))
+  {
+    host_counts.refreshes++;
+  }
+  lv_display_flush_ready(disp);
+}
+
+lv_display_t * lvgl_host_init(int32_t w, int32_t h)
+{
+  lv_init();
+  lv_tick_set_cb(host_tick);
+
+  host_disp = lv_display_create(w, h);
+  lv_display_set_color_format(host_disp, LV_COLOR_FORMAT_RGB565);
+  host_fb_size = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB565) * h;
+  host_fb = (uint8_t *)aligned_alloc(64, (host_fb_size + 63) / 64 * 64);
+  memset(host_fb, 0, host_fb_size);
+  lv_display_set_buffers(host_disp, host_fb, NULL, host_fb_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+  lv_display_set_flush_cb(host_disp, host_flush);
+  lv_display_set_default(host_disp);
+  return host_disp;
+}
+
+template <typename F>
+static void host_measure(lvgl_host_stats * stats, F run)
+{
+  memset(&host_counts, 0, sizeof(host_counts));
+  auto start = std::chrono::steady_clock::now();
+  run();
+  host_counts.render_us =
+      std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  if (stats) *stats = host_counts;
+}
+
+void lvgl_host_step(uint32_t ms, lvgl_host_stats * stats)
+{
+  delay(ms);
+  host_measure(stats, [] { lv_timer_handler(); });
+}
+
+void lvgl_host_refresh(lvgl_host_stats * stats)
+{
+  host_measure(stats, [] { lv_refr_now(host_disp); });
+}
+
+uint16_t lvgl_host_pixel(int32_t x, int32_t y)
+{
+  uint32_t stride = lv_draw_buf_width_to_stride(lv_display_get_horizontal_resolution(host_disp),
+                                                LV_COLOR_FORMAT_RGB565);
+  return *(const uint16_t *)(host_fb + y * stride + x * 2);
+}
+
+uint32_t lvgl_host_hash(void)
+{
+  uint32_t h = 2166136261u;
+  for (uint32_t i = 0; i < host_fb_size; i++)
+  {
+    h = (h ^ host_fb[i]) * 16777619u;
+  }
+  return h;
+}
+
+uint32_t lvgl_host_peak_mem(void)
+{
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  return mon.max_used;
+}
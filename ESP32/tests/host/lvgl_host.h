@@ -0,0 +1,34 @@
+#ifndef HOST_LVGL_HOST_H
+#define HOST_LVGL_HOST_H
+
+// Headless LVGL for the benchmarks that link the real library (make bench):
+// a direct-mode RGB565 framebuffer that is never shown, and an LVGL tick that
+// only moves with the simulated Arduino clock (stubs/Arduino.h), so timers,
+// animations and refreshes happen at the same frames on every run.
+
+#include <lvgl.h>
+
+struct lvgl_host_stats
+{
+  double render_us;      // Wall time spent in LVGL (timers, layout, rendering)
+  uint32_t refreshes;    // Frames LVGL rendered
+  uint32_t flushes;      // Areas handed to the flush callback
+  uint32_t flushed_px;
+};
+
+// lv_init() and a w x h display, made the default one
+lv_display_t * lvgl_host_init(int32_t w, int32_t h);
+
+// Moves the clock on by ms and runs the due LVGL timers (the display refresh among them)
+void lvgl_host_step(uint32_t ms, lvgl_host_stats * stats);
+// Renders whatever is invalid right now
+void lvgl_host_refresh(lvgl_host_stats * stats);
+
+// RGB565 framebuffer pixel
+uint16_t lvgl_host_pixel(int32_t x, int32_t y);
+// FNV-1a of the framebuffer, to compare the output of two runs
+uint32_t lvgl_host_hash(void);
+// Peak use of LVGL's heap (LV_MEM_SIZE) since lv_init()
+uint32_t lvgl_host_peak_mem(void);
+
+#endif // HOST_LVGL_HOST_H
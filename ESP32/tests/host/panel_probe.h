@@ -0,0 +1,141 @@
+#ifndef PANEL_PROBE_H
+#define PANEL_PROBE_H
+
+// What the ST7701 sees on its 3-wire command bus, for the panel bus tests.
+// The probe watches SCK/MOSI through the digitalWrite() stub (Indicator_SWSPI),
+// takes bits from the SPI host stub (Indicator_HWSPI) and follows CS on the
+// expander stub. Words are 9-bit, D/C first, sampled on the rising SCK edge
+// while CS is low; each word is stamped with the simulated time.
+
+#include <vector>
+#include "Arduino.h"
+#include "../../Indicator_Extender.h"
+
+struct PanelWord
+{
+  uint16_t value;
+  uint32_t time_us;
+  bool operator==(const PanelWord &o) const { return value == o.value && time_us == o.time_us; }
+};
+
+struct PanelEdge
+{
+  int level;
+  uint32_t time_us;
+  size_t bits_before; // Bits clocked in before this edge
+};
+
+struct PanelProbe
+{
+  std::vector<uint8_t> bits;
+  std::vector<PanelWord> words;
+  std::vector<PanelEdge> cs_edges;
+  uint32_t mosi_writes = 0;      // digitalWrite() calls on MOSI
+  uint32_t clocks_cs_high = 0;   // Rising SCK edges with CS high, the panel ignores them
+  uint32_t partial_releases = 0; // CS released in the middle of a word
+  int cs = 1, sck = 0, mosi = 0;
+
+  void clear()
+  {
+    bits.clear();
+    words.clear();
+    cs_edges.clear();
+    mosi_writes = clocks_cs_high = partial_releases = 0;
+  }
+
+  void clock_bit(int bit)
+  {
+    if (cs)
+    {
+      clocks_cs_high++;
+      return;
+    }
+    bits.push_back(bit);
+    if (bits.size() % 9 == 0)
+    {
+      uint16_t w = 0;
+      for (size_t i = bits.size() - 9; i < bits.size(); i++) w = (w << 1) | bits[i];
+      words.push_back({w, host_time_us});
+    }
+  }
+
+  // An SPI host transaction: length bits of buf, MSB first
+  void clock_buffer(const uint8_t *buf, size_t length)
+  {
+    for (size_t i = 0; i < length; i++) clock_bit((buf[i >> 3] >> (7 - (i & 7))) & 1);
+  }
+
+  void set_cs(int level)
+  {
+    if (level == cs) return;
+    if (level && bits.size() % 9) partial_releases++;
+    cs = level;
+    cs_edges.push_back({level, host_time_us, bits.size()});
+  }
+};
+
+extern PanelProbe probe;
+
+static void probe_digital_write(uint8_t pin, uint8_t val)
+{
+  if (pin == SPI_SCLK)
+  {
+    if (!probe.sck && val) probe.clock_bit(probe.mosi);
+    probe.sck = val;
+  }
+  else if (pin == SPI_MOSI)
+  {
+    probe.mosi = val;
+    probe.mosi_writes++;
+  }
+}
+
+// CS is pulled up while the expander pin is still an input
+static void probe_expander_write(const PCA9555 &chip, const PCA9555::Transaction &)
+{
+  probe.set_cs(chip.pin(EXPANDER_IO_LCD_CS) != 0);
+}
+
+static inline void probe_attach(void)
+{
+  host_digital_write = probe_digital_write;
+  ioex.on_write = probe_expander_write;
+}
+
+// A bus that only writes down the words it is asked for, the way the panel
+// should receive them. Fed through the library's batchOperation(), it gives
+// the reference for a table without going through ST7701Init::walk().
+class RecordingBus : public Arduino_DataBus
+{
+public:
+  std::vector<PanelWord> words;
+
+  bool begin(int32_t, int8_t) override { return true; }
+  void beginWrite() override {}
+  void endWrite() override {}
+  void writeCommand(uint8_t c) override { put(c); }
+  void writeCommand16(uint16_t c) override
+  {
+    put(c >> 8);
+    put(c & 0xFF);
+  }
+  void writeCommandBytes(uint8_t *data, uint32_t len) override
+  {
+    while (len--) put(*data++);
+  }
+  void write(uint8_t d) override { put(0x100 | d); }
+  void write16(uint16_t d) override
+  {
+    write(d >> 8);
+    write(d & 0xFF);
+  }
+  // Not used by init tables
+  void writeRepeat(uint16_t, uint32_t) override {}
+  void writePixels(uint16_t *, uint32_t) override {}
+  void writeBytes(uint8_t *, uint32_t) override {}
+
+private:
+  void put(uint16_t w) { words.push_back({w, host_time_us}); }
+};
+
+#endif // PANEL_PROBE_H
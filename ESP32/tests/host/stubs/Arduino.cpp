@@ -0,0 +1,86 @@
+#include "Arduino.h"
+#include <stdarg.h>
+
+uint32_t host_time_us = 0;
+
+uint32_t micros(void) { return host_time_us; }
+uint32_t millis(void) { return host_time_us / 1000; }
+void delay(uint32_t ms) { host_time_us += ms * 1000; }
+void delayMicroseconds(uint32_t us) { host_time_us += us; }
+
+void (*host_digital_write)(uint8_t pin, uint8_t val) = NULL;
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (host_digital_write) host_digital_write(pin, val);
+}
+int digitalRead(uint8_t pin) { (void)pin; return LOW; }
+
+HostSerial Serial;
+HostEsp ESP;
+
+void HostSerial::drain(void)
+{
+  uint32_t bytes = (host_time_us - drained_until) / us_per_byte;
+  if (bytes >= queued)
+  {
+    queued = 0;
+    drained_until = host_time_us;
+  }
+  else
+  {
+    queued -= bytes;
+    drained_until += bytes * us_per_byte;
+  }
+}
+
+int HostSerial::availableForWrite(void)
+{
+  drain();
+  return (int)(tx_capacity - queued);
+}
+
+size_t HostSerial::write(const uint8_t *data, size_t len)
+{
+  drain();
+  if (queued + len > tx_capacity)
+  {
+    uint32_t wait = (uint32_t)(queued + len - tx_capacity) * us_per_byte;
+    host_time_us += wait;
+    blocked_us += wait;
+    drain();
+  }
+  queued = std::min(queued + len, tx_capacity);
+  output.append((const char *)data, len);
+  return len;
+}
+
+size_t HostSerial::print(const char *s)
+{
+  return write((const uint8_t *)s, strlen(s));
+}
+
+size_t HostSerial::println(const char *s)
+{
+  return print(s) + print("\r\n");
+}
+
+size_t HostSerial::printf(const char *fmt, ...)
+{
+  char buf[512];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  return write((const uint8_t *)buf, std::min((size_t)len, sizeof(buf) - 1));
+}
+
+void HostSerial::reset(size_t capacity)
+{
+  tx_capacity = capacity;
+  output.clear();
+  blocked_us = 0;
+  queued = 0;
+  drained_until = host_time_us;
+}
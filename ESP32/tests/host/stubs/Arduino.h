@@ -0,0 +1,84 @@
+#ifndef HOST_STUB_ARDUINO_H
+#define HOST_STUB_ARDUINO_H
+
+// Arduino core stand-in for the host tests. Time is simulated: micros() and
+// millis() only move when delay()/delayMicroseconds() are called or a test
+// advances host_time_us.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint32_t host_time_us;
+
+uint32_t micros(void);
+uint32_t millis(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+// GPIOs do nothing unless a test sets host_digital_write to watch them
+extern void (*host_digital_write)(uint8_t pin, uint8_t val);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+
+#include <algorithm>
+#include <string>
+using std::min;
+using std::max;
+
+// Serial with a TX buffer that drains at 115200 baud in simulated time.
+// Writing more than availableForWrite() blocks: the clock moves on until the
+// data fits, and the wait is added up in blocked_us.
+class HostSerial
+{
+public:
+  void setTxBufferSize(size_t size) { tx_capacity = size; }
+  void begin(unsigned long baud) { (void)baud; }
+  int availableForWrite(void);
+  size_t write(const uint8_t *data, size_t len);
+  size_t print(const char *s);
+  size_t println(const char *s = "");
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  void reset(size_t capacity);
+
+  std::string output;        // Everything written, in order
+  size_t tx_capacity = 128;  // HardwareSerial without setTxBufferSize(): the UART FIFO
+  uint32_t us_per_byte = 87; // 10 bits at 115200 baud
+  uint32_t blocked_us = 0;
+
+private:
+  void drain(void);
+  size_t queued = 0;
+  uint32_t drained_until = 0;
+};
+
+extern HostSerial Serial;
+
+// ESP.getCpuFreqMHz() for PerfMonitor: the esp_cpu.h stub counts nanoseconds
+class HostEsp
+{
+public:
+  uint32_t getCpuFreqMHz(void) { return 1000; }
+};
+
+extern HostEsp ESP;
+#endif
+
+#endif // HOST_STUB_ARDUINO_H
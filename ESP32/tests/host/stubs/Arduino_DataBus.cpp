@@ -0,0 +1,59 @@
+#include "Arduino_DataBus.h"
+
+// Same as Arduino_GFX's Arduino_DataBus::batchOperation()
+void Arduino_DataBus::batchOperation(const uint8_t *operations, size_t len)
+{
+  for (size_t i = 0; i < len; ++i)
+  {
+    uint8_t l = 0;
+    switch (operations[i])
+    {
+    case BEGIN_WRITE:
+      beginWrite();
+      break;
+    case WRITE_C8_D16:
+      l++;
+      /* fall through */
+    case WRITE_C8_D8:
+      l++;
+      /* fall through */
+    case WRITE_COMMAND_8:
+      writeCommand(operations[++i]);
+      break;
+    case WRITE_C16_D16:
+      l = 2;
+      /* fall through */
+    case WRITE_COMMAND_16:
+      _data16.msb = operations[++i];
+      _data16.lsb = operations[++i];
+      writeCommand16(_data16.value);
+      break;
+    case WRITE_DATA_8:
+      l = 1;
+      break;
+    case WRITE_DATA_16:
+      l = 2;
+      break;
+    case WRITE_BYTES:
+      l = operations[++i];
+      break;
+    case WRITE_C8_BYTES:
+      writeCommand(operations[++i]);
+      l = operations[++i];
+      break;
+    case END_WRITE:
+      endWrite();
+      break;
+    case DELAY:
+      delay(operations[++i]);
+      break;
+    default:
+      printf("Unknown operation id at %zu: %d\n", i, operations[i]);
+      break;
+    }
+    while (l-- > 0)
+    {
+      write(operations[++i]);
+    }
+  }
+}
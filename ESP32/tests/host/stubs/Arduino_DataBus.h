@@ -0,0 +1,61 @@
+#ifndef HOST_STUB_ARDUINO_DATABUS_H
+#define HOST_STUB_ARDUINO_DATABUS_H
+
+// Arduino_GFX's Arduino_DataBus, reduced to what the panel buses override.
+// batchOperation() in Arduino_DataBus.cpp is the library's interpreter.
+
+#include "Arduino.h"
+
+#define GFX_NOT_DEFINED -1
+#define GFX_INLINE __attribute__((always_inline)) inline
+
+typedef enum
+{
+  BEGIN_WRITE,
+  WRITE_COMMAND_8,
+  WRITE_COMMAND_16,
+  WRITE_COMMAND_BYTES,
+  WRITE_DATA_8,
+  WRITE_DATA_16,
+  WRITE_BYTES,
+  WRITE_C8_D8,
+  WRITE_C8_D16,
+  WRITE_C8_BYTES,
+  WRITE_C16_D16,
+  END_WRITE,
+  DELAY,
+} spi_operation_type_t;
+
+class Arduino_DataBus
+{
+public:
+  Arduino_DataBus() {}
+  virtual ~Arduino_DataBus() {}
+
+  virtual bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) = 0;
+  virtual void beginWrite() = 0;
+  virtual void endWrite() = 0;
+  virtual void writeCommand(uint8_t c) = 0;
+  virtual void writeCommand16(uint16_t c) = 0;
+  virtual void writeCommandBytes(uint8_t *data, uint32_t len) = 0;
+  virtual void write(uint8_t) = 0;
+  virtual void write16(uint16_t) = 0;
+  virtual void writeRepeat(uint16_t p, uint32_t len) = 0;
+  virtual void writePixels(uint16_t *data, uint32_t len) = 0;
+
+  virtual void writeBytes(uint8_t *data, uint32_t len) = 0;
+  virtual void batchOperation(const uint8_t *operations, size_t len);
+
+protected:
+  union
+  {
+    uint16_t value;
+    struct
+    {
+      uint8_t lsb;
+      uint8_t msb;
+    };
+  } _data16;
+};
+
+#endif // HOST_STUB_ARDUINO_DATABUS_H
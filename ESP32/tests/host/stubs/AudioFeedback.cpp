@@ -0,0 +1,17 @@
+// AudioFeedback (src/UI/AudioFeedback.cpp) without the buzzer: the benchmarks
+// that run WindChime.c link this instead, silent and never blocking.
+
+#include "../../../src/UI/AudioFeedback.h"
+
+static bool audio_enabled = false;
+static uint8_t audio_volume = 50;
+
+void AudioFeedbackInit(void) {}
+void PlayEventSound(data_source_t source, int32_t intensity) { (void)source; (void)intensity; }
+void UpdateAmbientSound(int16_t wind_speed) { (void)wind_speed; }
+void SetAudioVolume(uint8_t volume) { audio_volume = volume; }
+void SetAudioEnabled(bool enabled) { audio_enabled = enabled; }
+bool IsAudioEnabled(void) { return audio_enabled; }
+uint8_t GetAudioVolume(void) { return audio_volume; }
+void SaveAudioVolume(uint8_t volume) { audio_volume = volume; }
+uint8_t LoadAudioVolume(void) { return audio_volume; }
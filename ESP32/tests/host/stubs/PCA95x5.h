@@ -0,0 +1,124 @@
+#ifndef HOST_STUB_PCA95X5_H
+#define HOST_STUB_PCA95X5_H
+
+// Anitracks PCA95x5 stand-in backed by a model of the PCA9555 register map.
+// Every register write is one I2C transaction; they are logged with the
+// simulated time, and a test can make the next ones fail (NACK).
+
+#include <vector>
+#include "Arduino.h"
+#include "Wire.h"
+
+namespace PCA95x5
+{
+namespace Port
+{
+enum Port : uint8_t
+{
+  P00, P01, P02, P03, P04, P05, P06, P07,
+  P08, P09, P10, P11, P12, P13, P14, P15,
+};
+}
+namespace Level
+{
+enum Level : uint8_t { L, H };
+}
+namespace Direction
+{
+enum Direction : uint8_t { OUT, IN };
+}
+namespace Polarity
+{
+enum Polarity : uint16_t { ORIGINAL_ALL = 0x0000, INVERTED_ALL = 0xFFFF };
+}
+} // namespace PCA95x5
+
+class PCA9555
+{
+public:
+  // Command bytes of the 16-bit registers
+  enum Reg : uint8_t
+  {
+    REG_OUTPUT = 0x02,
+    REG_POLARITY = 0x04,
+    REG_CONFIG = 0x06,
+  };
+
+  struct Transaction
+  {
+    uint8_t reg;
+    uint16_t value;
+    uint32_t time_us;
+    bool ok;
+  };
+
+  void attach(TwoWire &wire, uint8_t addr = 0x20)
+  {
+    (void)wire;
+    (void)addr;
+  }
+
+  bool polarity(PCA95x5::Polarity::Polarity pol) { return send(REG_POLARITY, pol); }
+
+  // Whole port
+  bool write(uint16_t value) { return send(REG_OUTPUT, value); }
+  bool direction(uint16_t value) { return send(REG_CONFIG, value); }
+
+  // Per pin, as the library does it: change the pin in its copy of the
+  // register, then write the whole register
+  bool write(PCA95x5::Port::Port port, PCA95x5::Level::Level level)
+  {
+    lib_output = level == PCA95x5::Level::H ? (lib_output | (1 << port)) : (lib_output & ~(1 << port));
+    return write(lib_output);
+  }
+  bool direction(PCA95x5::Port::Port port, PCA95x5::Direction::Direction dir)
+  {
+    lib_config = dir == PCA95x5::Direction::IN ? (lib_config | (1 << port)) : (lib_config & ~(1 << port));
+    return direction(lib_config);
+  }
+
+  // Level a pin drives, -1 while it is an input
+  int pin(uint8_t port) const
+  {
+    if (config & (1 << port)) return -1;
+    return (output >> port) & 1;
+  }
+
+  // The chip keeps its registers across an ESP32 reset, a test sets what was left
+  void reset(uint16_t out, uint16_t cfg)
+  {
+    output = out;
+    config = cfg;
+    lib_output = lib_config = 0xFFFF;
+    log.clear();
+    fail_next = 0;
+  }
+
+  uint16_t output = 0xFFFF; // Power-on: all high
+  uint16_t config = 0xFFFF; // Power-on: all inputs
+  uint16_t pol = 0x0000;
+  std::vector<Transaction> log;
+  int fail_next = 0;        // Fail this many of the next writes, the register keeps its value
+  void (*on_write)(const PCA9555 &chip, const Transaction &t) = nullptr;
+
+private:
+  bool send(uint8_t reg, uint16_t value)
+  {
+    bool ok = fail_next <= 0;
+    if (!ok) fail_next--;
+    if (ok)
+    {
+      if (reg == REG_OUTPUT) output = value;
+      if (reg == REG_CONFIG) config = value;
+      if (reg == REG_POLARITY) pol = value;
+    }
+    log.push_back({reg, value, host_time_us, ok});
+    if (on_write) on_write(*this, log.back());
+    return ok;
+  }
+
+  uint16_t lib_output = 0xFFFF;
+  uint16_t lib_config = 0xFFFF;
+};
+
+#endif // HOST_STUB_PCA95X5_H
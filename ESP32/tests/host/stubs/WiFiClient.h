@@ -0,0 +1 @@
+// Empty: the tested code only needs the declarations around this include
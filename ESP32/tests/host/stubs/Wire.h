@@ -0,0 +1,20 @@
+#ifndef HOST_STUB_WIRE_H
+#define HOST_STUB_WIRE_H
+
+#include <stdint.h>
+
+class TwoWire
+{
+public:
+  bool begin(int sda, int scl, uint32_t frequency)
+  {
+    (void)sda;
+    (void)scl;
+    (void)frequency;
+    return true;
+  }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_STUB_WIRE_H
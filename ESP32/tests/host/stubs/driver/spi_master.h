@@ -0,0 +1,50 @@
+#ifndef HOST_STUB_DRIVER_SPI_MASTER_H
+#define HOST_STUB_DRIVER_SPI_MASTER_H
+
+// ESP-IDF SPI master driver, only what Indicator_HWSPI uses. The functions are
+// defined by the test that links the bus, so it can watch every transaction.
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int esp_err_t;
+typedef int spi_host_device_t;
+typedef struct spi_device_t *spi_device_handle_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_STATE 0x103
+
+#define SPI2_HOST 1
+#define SPI_DMA_DISABLED 0
+
+typedef struct
+{
+  int mosi_io_num;
+  int miso_io_num;
+  int sclk_io_num;
+  int quadwp_io_num;
+  int quadhd_io_num;
+  int max_transfer_sz;
+} spi_bus_config_t;
+
+typedef struct
+{
+  uint8_t mode;
+  int clock_speed_hz;
+  int spics_io_num;
+  int queue_size;
+} spi_device_interface_config_t;
+
+typedef struct
+{
+  size_t length; // In bits
+  const void *tx_buffer;
+} spi_transaction_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *config, int dma_chan);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *config,
+                             spi_device_handle_t *handle);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans);
+
+#endif // HOST_STUB_DRIVER_SPI_MASTER_H
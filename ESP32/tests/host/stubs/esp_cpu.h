@@ -0,0 +1,18 @@
+#ifndef HOST_STUB_ESP_CPU_H
+#define HOST_STUB_ESP_CPU_H
+
+// The cycle counter PerfMonitor reads, as this process's CPU time in ns: with
+// ESP.getCpuFreqMHz() at 1000 the histograms come out in real microseconds
+// of CPU, independent of the simulated Arduino clock.
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint32_t esp_cpu_get_cycle_count(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+#endif // HOST_STUB_ESP_CPU_H
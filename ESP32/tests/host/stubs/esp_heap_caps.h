@@ -0,0 +1,14 @@
+#ifndef HOST_STUB_ESP_HEAP_CAPS_H
+#define HOST_STUB_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+#define heap_caps_malloc(size, caps) malloc(size)
+#define heap_caps_free(ptr) free(ptr)
+#define heap_caps_aligned_alloc(align, size, caps) aligned_alloc((align), ((size) + (align) - 1) / (align) * (align))
+
+#endif // HOST_STUB_ESP_HEAP_CAPS_H
@@ -0,0 +1,64 @@
+#ifndef HOST_STUB_LVGL_H
+#define HOST_STUB_LVGL_H
+
+// The few LVGL 9 types and helpers the tested modules use
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LV_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define LV_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LV_UNUSED(x) ((void)x)
+#define lv_memcpy memcpy
+
+typedef struct {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+} lv_area_t;
+
+static inline int32_t lv_area_get_width(const lv_area_t * area) { return area->x2 - area->x1 + 1; }
+static inline int32_t lv_area_get_height(const lv_area_t * area) { return area->y2 - area->y1 + 1; }
+static inline uint32_t lv_area_get_size(const lv_area_t * area)
+{
+    return (uint32_t)lv_area_get_width(area) * (uint32_t)lv_area_get_height(area);
+}
+
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_event_t lv_event_t;
+typedef void (*lv_event_cb_t)(lv_event_t * e);
+
+typedef struct {
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+} lv_color_t;
+
+typedef enum {
+    LV_DISPLAY_ROTATION_0 = 0,
+    LV_DISPLAY_ROTATION_90,
+    LV_DISPLAY_ROTATION_180,
+    LV_DISPLAY_ROTATION_270
+} lv_display_rotation_t;
+
+typedef enum {
+    LV_COLOR_FORMAT_RGB565 = 0x12,
+} lv_color_format_t;
+
+// Not implemented by the stubs: a test that links code calling it supplies
+// its own reference version
+void lv_draw_sw_rotate(const void * src, void * dest, int32_t src_width, int32_t src_height,
+                       int32_t src_stride, int32_t dest_stride, lv_display_rotation_t rotation,
+                       lv_color_format_t color_format);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif // HOST_STUB_LVGL_H
@@ -0,0 +1,187 @@
+// AreaCoalesce_CostModel (src/Display/AreaCoalesce.c): bounded to
+// AREA_COALESCE_MAX_PASSES passes, still covers every dirty area, never costs
+// more than not merging, and against the unbounded version it replaced.
+
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+#include "host_test.h"
+#include "../../src/Display/AreaCoalesce.h"
+
+#define INV_BUF_SIZE 32 // LV_INV_BUF_SIZE
+#define SCREEN 480
+
+struct Areas {
+  std::vector<lv_area_t> areas;
+  std::vector<uint8_t> joined;
+};
+
+static uint64_t cost(const Areas &a)
+{
+  const area_cost_model_t * m = AreaCoalesce_GetModel();
+  uint64_t total = 0;
+  for (size_t i = 0; i < a.areas.size(); i++) {
+    if (!a.joined[i]) total += m->area_overhead_ns + (uint64_t)m->px_cost_ns * lv_area_get_size(&a.areas[i]);
+  }
+  return total;
+}
+
+// The loop from before the pass limit: repeat until nothing merges
+static uint32_t coalesce_unbounded(lv_area_t * areas, uint8_t * joined, uint32_t count)
+{
+  const area_cost_model_t * m = AreaCoalesce_GetModel();
+  uint64_t overhead = m->area_overhead_ns, px_cost = m->px_cost_ns;
+  uint32_t passes = 0;
+  bool merged;
+  do {
+    merged = false;
+    passes++;
+    for (uint32_t i = 0; i < count; i++) {
+      if (joined[i]) continue;
+      for (uint32_t j = i + 1; j < count; j++) {
+        if (joined[j]) continue;
+        lv_area_t bbox;
+        bbox.x1 = LV_MIN(areas[i].x1, areas[j].x1);
+        bbox.y1 = LV_MIN(areas[i].y1, areas[j].y1);
+        bbox.x2 = LV_MAX(areas[i].x2, areas[j].x2);
+        bbox.y2 = LV_MAX(areas[i].y2, areas[j].y2);
+        uint64_t separate = 2 * overhead + px_cost * (lv_area_get_size(&areas[i]) + lv_area_get_size(&areas[j]));
+        uint64_t together = overhead + px_cost * lv_area_get_size(&bbox);
+        if (together < separate) {
+          areas[j] = bbox;
+          joined[i] = 1;
+          merged = true;
+          break;
+        }
+      }
+    }
+  } while (merged);
+  return passes;
+}
+
+static Areas random_areas(int count, int max_size)
+{
+  Areas a;
+  for (int i = 0; i < count; i++) {
+    lv_area_t r;
+    int w = 1 + rand() % max_size, h = 1 + rand() % max_size;
+    r.x1 = rand() % (SCREEN - w);
+    r.y1 = rand() % (SCREEN - h);
+    r.x2 = r.x1 + w - 1;
+    r.y2 = r.y1 + h - 1;
+    a.areas.push_back(r);
+  }
+  // LVGL may already have joined some
+  a.joined.assign(count, 0);
+  for (int i = 0; i < count; i++) a.joined[i] = rand() % 8 == 0;
+  return a;
+}
+
+static bool contains(const lv_area_t &outer, const lv_area_t &inner)
+{
+  return outer.x1 <= inner.x1 && outer.y1 <= inner.y1 && outer.x2 >= inner.x2 && outer.y2 >= inner.y2;
+}
+
+static void test_random(void)
+{
+  uint64_t cost_in = 0, cost_bounded = 0, cost_unbounded = 0;
+  uint32_t max_passes = 0, max_unbounded_passes = 0, capped = 0, sets = 0;
+  srand(5);
+  for (int round = 0; round < 4000; round++) {
+    Areas in = random_areas(1 + rand() % INV_BUF_SIZE, 1 + rand() % 64);
+    Areas out = in, ref = in;
+    uint32_t passes = AreaCoalesce_CostModel(out.areas.data(), out.joined.data(), out.areas.size());
+    uint32_t ref_passes = coalesce_unbounded(ref.areas.data(), ref.joined.data(), ref.areas.size());
+    sets++;
+
+    CHECK(passes >= 1 && passes <= AREA_COALESCE_MAX_PASSES);
+    max_passes = LV_MAX(max_passes, passes);
+    max_unbounded_passes = LV_MAX(max_unbounded_passes, ref_passes);
+    capped += ref_passes > AREA_COALESCE_MAX_PASSES;
+    // Same as before whenever the old loop finished within the limit
+    if (ref_passes <= AREA_COALESCE_MAX_PASSES) CHECK(out.joined == ref.joined);
+
+    CHECK(cost(out) <= cost(in));
+    cost_in += cost(in);
+    cost_bounded += cost(out);
+    cost_unbounded += cost(ref);
+
+    // Every area that was to be drawn is inside one that still is, and
+    // only ever areas LVGL had not joined get joined
+    for (size_t i = 0; i < in.areas.size(); i++) {
+      if (in.joined[i]) { CHECK(out.joined[i]); continue; }
+      bool covered = false;
+      for (size_t j = 0; j < out.areas.size(); j++) {
+        if (!out.joined[j] && contains(out.areas[j], in.areas[i])) covered = true;
+      }
+      CHECK(covered);
+    }
+  }
+  printf("coalesce: %u sets, max %u passes (unbounded: %u, %u sets needed more than %d), "
+         "cost %.3f of unmerged (unbounded %.3f)\n",
+         sets, max_passes, max_unbounded_passes, capped, AREA_COALESCE_MAX_PASSES,
+         (double)cost_bounded / cost_in, (double)cost_unbounded / cost_in);
+  CHECK(max_unbounded_passes > AREA_COALESCE_MAX_PASSES);
+  // The passes given up cost little
+  CHECK(cost_bounded <= cost_unbounded + cost_unbounded / 50);
+}
+
+// The merge that must come last and the area that must be kept is the one
+// with the higher index
+static void test_keeps_higher_index(void)
+{
+  area_cost_model_t model = { 60000, 30 };
+  AreaCoalesce_SetModel(&model);
+  lv_area_t areas[3] = { { 0, 0, 9, 9 }, { 400, 400, 479, 479 }, { 12, 0, 21, 9 } };
+  uint8_t joined[3] = { 0, 0, 0 };
+  CHECK_EQ(AreaCoalesce_CostModel(areas, joined, 3), 2);
+  CHECK_EQ(joined[0], 1);
+  CHECK_EQ(joined[1], 0);
+  CHECK_EQ(joined[2], 0);
+  CHECK(areas[2].x1 == 0 && areas[2].y1 == 0 && areas[2].x2 == 21 && areas[2].y2 == 9);
+}
+
+// Worst case for the old loop: a blob that grows by one strip per pass. The
+// strips are added alternately on the right and at the bottom, each exactly
+// as long as the blob's side, so only the grown blob pays off, never the
+// strip next to it. Listed newest first: the seed, which keeps every merge,
+// has the highest index.
+static void test_chain(void)
+{
+  const int32_t s = 10;
+  area_cost_model_t model = { 1500, 30 }; // Merge only if it draws < 50 px extra
+  AreaCoalesce_SetModel(&model);
+  std::vector<lv_area_t> grown = { { 0, 0, s - 1, s - 1 } };
+  int32_t w = s, h = s;
+  while (grown.size() < INV_BUF_SIZE) {
+    if (grown.size() % 2) { grown.push_back({ w, 0, w + s - 1, h - 1 }); w += s; }
+    else { grown.push_back({ 0, h, w - 1, h + s - 1 }); h += s; }
+  }
+  Areas chain;
+  chain.areas.assign(grown.rbegin(), grown.rend());
+  chain.joined.assign(INV_BUF_SIZE, 0);
+  Areas unmerged = chain, ref = chain;
+
+  using clock = std::chrono::steady_clock;
+  auto t0 = clock::now();
+  uint32_t passes = AreaCoalesce_CostModel(chain.areas.data(), chain.joined.data(), INV_BUF_SIZE);
+  auto t1 = clock::now();
+  uint32_t ref_passes = coalesce_unbounded(ref.areas.data(), ref.joined.data(), INV_BUF_SIZE);
+  auto t2 = clock::now();
+  printf("coalesce chain of %d: %u passes %.1f us, unbounded %u passes %.1f us\n", INV_BUF_SIZE,
+         passes, std::chrono::duration<double, std::micro>(t1 - t0).count(),
+         ref_passes, std::chrono::duration<double, std::micro>(t2 - t1).count());
+  CHECK_EQ(passes, AREA_COALESCE_MAX_PASSES);
+  CHECK_EQ(ref_passes, INV_BUF_SIZE);
+  CHECK(cost(chain) < cost(unmerged));
+  CHECK(cost(ref) < cost(chain));
+  CHECK(contains(ref.areas[INV_BUF_SIZE - 1], { 0, 0, w - 1, h - 1 }));
+}
+
+int main(void)
+{
+  test_random();
+  test_keeps_higher_index();
+  test_chain();
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,186 @@
+// The PCA9555 shadow registers in Indicator_Extender against a model of the
+// chip's register map. extender_init() must leave OUT/CFG exactly where the
+// old pin-by-pin sequence left them, in 3 register writes instead of 16,
+// with OUT written before CFG so a pin never drives a stale level.
+// The extender state cannot be reset, so the scenarios run in order.
+
+#include "host_test.h"
+#include <vector>
+#include "../../Indicator_Extender.h"
+#include "../../Indicator_SWSPI.h"
+
+struct RegState
+{
+  uint16_t output;
+  uint16_t config;
+};
+
+// Registers after each transaction
+static std::vector<RegState> states;
+
+static void record_state(const PCA9555 &chip, const PCA9555::Transaction &)
+{
+  states.push_back({chip.output, chip.config});
+}
+
+// What the chip ends up with after a phase of the old extender_init()
+struct OldInit
+{
+  RegState after_setup;
+  RegState after_reset;
+  size_t writes;
+};
+
+// extender_init() before the shadow registers: every pin call through the
+// library is a full register write
+static OldInit old_extender_init(uint16_t leftover_output, uint16_t leftover_config)
+{
+  PCA9555 chip;
+  chip.reset(leftover_output, leftover_config);
+
+  chip.write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::L);
+  chip.direction(EXPANDER_IO_LCD_RESET, PCA95x5::Direction::OUT);
+  chip.direction(EXPANDER_IO_LCD_INT, PCA95x5::Direction::IN);
+  chip.write(EXPANDER_IO_TP_RESET, PCA95x5::Level::L);
+  chip.direction(EXPANDER_IO_TP_RESET, PCA95x5::Direction::OUT);
+  chip.direction(EXPANDER_IO_RP2040_RESET, PCA95x5::Direction::OUT);
+  chip.write(EXPANDER_IO_RP2040_RESET, PCA95x5::Level::H);
+  chip.direction(EXPANDER_IO_BMP_PWR, PCA95x5::Direction::OUT);
+  chip.write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::H);
+  chip.write(EXPANDER_IO_RADIO_NSS, PCA95x5::Level::H);
+  chip.direction(EXPANDER_IO_RADIO_NSS, PCA95x5::Direction::OUT);
+  chip.direction(EXPANDER_IO_RADIO_RST, PCA95x5::Direction::OUT);
+  chip.direction(EXPANDER_IO_RADIO_BUSY, PCA95x5::Direction::IN);
+  chip.direction(EXPANDER_IO_RADIO_DIO_1, PCA95x5::Direction::IN);
+  OldInit old;
+  old.after_setup = {chip.output, chip.config};
+
+  chip.write(EXPANDER_IO_LCD_RESET, PCA95x5::Level::H);
+  chip.write(EXPANDER_IO_TP_RESET, PCA95x5::Level::H);
+  old.after_reset = {chip.output, chip.config};
+  old.writes = chip.log.size();
+  return old;
+}
+
+static void test_init(void)
+{
+  // Registers left over from before an ESP32 reset, the shadows must not trust them
+  const uint16_t leftover_output = 0x1234;
+  const uint16_t leftover_config = 0xFFFF;
+  OldInit old = old_extender_init(leftover_output, leftover_config);
+  CHECK_EQ(old.writes, 16);
+
+  ioex.reset(leftover_output, leftover_config);
+  ioex.on_write = record_state;
+  states.clear();
+  host_time_us = 1000000;
+  extender_init();
+
+  // Polarity, then OUT and CFG for the setup, then OUT for the reset pulse
+  CHECK_EQ(ioex.log.size(), 4);
+  if (ioex.log.size() != 4) return;
+  CHECK_EQ(ioex.log[0].reg, PCA9555::REG_POLARITY);
+  CHECK_EQ(ioex.log[1].reg, PCA9555::REG_OUTPUT);
+  CHECK_EQ(ioex.log[2].reg, PCA9555::REG_CONFIG);
+  CHECK_EQ(ioex.log[3].reg, PCA9555::REG_OUTPUT);
+  CHECK_EQ(ioex.log[3].time_us - ioex.log[2].time_us, 5000);
+
+  // OUT already holds the setup levels when CFG turns the pins into outputs
+  CHECK_EQ(states[1].output, old.after_setup.output);
+  CHECK_EQ(states[2].output, old.after_setup.output);
+  CHECK_EQ(states[2].config, old.after_setup.config);
+  // No pin ever drives a level the old sequence did not have at that point
+  for (size_t i = 1; i < 3; i++)
+  {
+    CHECK_EQ((states[i].output ^ old.after_setup.output) & ~states[i].config, 0);
+  }
+  CHECK_EQ(ioex.output, old.after_reset.output);
+  CHECK_EQ(ioex.config, old.after_reset.config);
+
+  const extender_stats_t *s = extender_get_stats();
+  printf("init: %u writes (was %zu), %u unchanged, %u coalesced\n",
+         s->writes, old.writes, s->saved_unchanged, s->saved_coalesced);
+  CHECK_EQ(s->writes, 3);
+  CHECK_EQ(s->saved_unchanged, 6);
+  CHECK_EQ(s->saved_coalesced, 7);
+  CHECK_EQ(s->writes + s->saved_unchanged + s->saved_coalesced, old.writes);
+
+  // Only once
+  extender_init();
+  CHECK_EQ(ioex.log.size(), 4);
+}
+
+// CS_INIT() batches low, output, high: OUT is back where it was, only CFG is written
+static void test_cs_init(void)
+{
+  extender_stats_t before = *extender_get_stats();
+  ioex.log.clear();
+  states.clear();
+
+  Indicator_SWSPI bus(GFX_NOT_DEFINED, EXPANDER_IO_LCD_CS, SPI_SCLK, SPI_MOSI, GFX_NOT_DEFINED);
+  CHECK(bus.begin());
+
+  CHECK_EQ(ioex.log.size(), 1);
+  CHECK_EQ(ioex.log[0].reg, PCA9555::REG_CONFIG);
+  CHECK_EQ(ioex.pin(EXPANDER_IO_LCD_CS), 1);
+  const extender_stats_t *s = extender_get_stats();
+  CHECK_EQ(s->writes - before.writes, 1);
+  CHECK_EQ(s->saved_unchanged - before.saved_unchanged, 2);
+  CHECK_EQ(s->saved_coalesced - before.saved_coalesced, 0);
+
+  // Setting a level the register already has costs nothing
+  CHECK(extender_write(EXPANDER_IO_LCD_CS, PCA95x5::Level::H));
+  CHECK(extender_direction(EXPANDER_IO_LCD_CS, PCA95x5::Direction::OUT));
+  CHECK_EQ(ioex.log.size(), 1);
+  CHECK_EQ(s->saved_unchanged - before.saved_unchanged, 4);
+}
+
+// A write the chip did not acknowledge is sent again by the next call, even
+// if it asks for the same level
+static void test_failed_send(void)
+{
+  ioex.log.clear();
+  const extender_stats_t *s = extender_get_stats();
+  uint32_t writes = s->writes;
+
+  ioex.fail_next = 1;
+  CHECK(!extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::L));
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), 1);
+  CHECK(extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::L));
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), 0);
+  CHECK_EQ(ioex.log.size(), 2);
+  CHECK_EQ(s->writes - writes, 2);
+
+  // Once it went through, the same level is skipped again
+  CHECK(extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::L));
+  CHECK_EQ(ioex.log.size(), 2);
+
+  // Same inside a batch
+  ioex.fail_next = 1;
+  extender_begin_batch();
+  extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::H);
+  CHECK(!extender_end_batch());
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), 0);
+  extender_begin_batch();
+  extender_write(EXPANDER_IO_BMP_PWR, PCA95x5::Level::H);
+  CHECK(extender_end_batch());
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), 1);
+  CHECK_EQ(ioex.log.size(), 4);
+
+  // And for the configuration register
+  ioex.fail_next = 1;
+  CHECK(!extender_direction(EXPANDER_IO_BMP_PWR, PCA95x5::Direction::IN));
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), 1);
+  CHECK(extender_direction(EXPANDER_IO_BMP_PWR, PCA95x5::Direction::IN));
+  CHECK_EQ(ioex.pin(EXPANDER_IO_BMP_PWR), -1);
+  CHECK_EQ(ioex.log.size(), 6);
+  CHECK_EQ(s->writes - writes, 6);
+}
+
+int main(void)
+{
+  test_init();
+  test_cs_init();
+  test_failed_send();
+  return HOST_TEST_RESULT();
+}
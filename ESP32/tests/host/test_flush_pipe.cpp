@@ -0,0 +1,238 @@
+// FlushPipe (src/Display/FlushPipe.cpp), the double-partial handoff, with a
+// host thread as the worker. First the contract: jobs arrive in order, Drain()
+// waits for the one in flight, the statistics add up. Then the benchmark that
+// replaces the old ASYNC_FLUSH_SINK_DELAY_US knob: a renderer and a sink that
+// both take a fixed time per 40-line strip, run synchronously (sink called
+// from the flush callback, as in partial mode) and through the pipe, reporting
+// overlap, sink throughput and frames per second. Times are sleeps, so the
+// numbers hold on a single core too.
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "host_test.h"
+#include "../../src/Display/FlushPipe.h"
+
+#define SCREEN_W 480
+#define SCREEN_H 480
+#define STRIP_LINES 40 // ASYNC_FLUSH_LINES
+#define STRIPS (SCREEN_H / STRIP_LINES)
+#define PX_SIZE 2
+
+static std::vector<uint16_t> fb(SCREEN_W * SCREEN_H);
+static std::vector<uint16_t> strips[2] = {
+  std::vector<uint16_t>(SCREEN_W * STRIP_LINES), std::vector<uint16_t>(SCREEN_W * STRIP_LINES)
+};
+
+static uint32_t sink_delay_us = 0;
+static std::vector<int32_t> sink_order; // y1 of each job the sink saw
+static uint32_t sink_last = 0;
+static volatile bool sink_done = false;
+
+static void sleep_us(uint32_t us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+static double now_us(void)
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Copies the strip into the framebuffer, like gfx_draw_area() at rotation 0
+static void copy_sink(const flush_job_t * job)
+{
+  if (sink_delay_us) sleep_us(sink_delay_us);
+  int32_t w = lv_area_get_width(&job->area);
+  const uint16_t * src = (const uint16_t *)job->px_map;
+  for (int32_t y = job->area.y1; y <= job->area.y2; y++)
+  {
+    memcpy(&fb[y * SCREEN_W + job->area.x1], src, w * PX_SIZE);
+    src += w;
+  }
+  sink_order.push_back(job->area.y1);
+  sink_last += job->last;
+  sink_done = true;
+}
+
+static uint16_t pixel(int frame, int32_t x, int32_t y)
+{
+  return (uint16_t)(frame * 7919 + y * SCREEN_W + x);
+}
+
+// Renders strip s of a frame into buf, taking render_us
+static void render_strip(int frame, int s, std::vector<uint16_t> &buf, uint32_t render_us)
+{
+  if (render_us) sleep_us(render_us);
+  for (int32_t y = 0; y < STRIP_LINES; y++)
+  {
+    for (int32_t x = 0; x < SCREEN_W; x++)
+    {
+      buf[y * SCREEN_W + x] = pixel(frame, x, s * STRIP_LINES + y);
+    }
+  }
+}
+
+static flush_job_t strip_job(int s, std::vector<uint16_t> &buf)
+{
+  flush_job_t job = { { 0, s * STRIP_LINES, SCREEN_W - 1, (s + 1) * STRIP_LINES - 1 },
+                      (uint8_t *)buf.data(), LV_DISPLAY_ROTATION_0, s == STRIPS - 1 };
+  return job;
+}
+
+// What LVGL does with two buffers and a flush_wait_cb: render into the free
+// buffer, wait for the previous flush only when the next one is due
+static void run_async(int frames, uint32_t render_us)
+{
+  for (int f = 0; f < frames; f++)
+  {
+    for (int s = 0; s < STRIPS; s++)
+    {
+      std::vector<uint16_t> &buf = strips[(f * STRIPS + s) & 1];
+      render_strip(f, s, buf, render_us);
+      FlushPipe_Wait();
+      FlushPipe_Acquire();
+      flush_job_t job = strip_job(s, buf);
+      FlushPipe_Submit(&job);
+    }
+  }
+  FlushPipe_Wait();
+}
+
+// Partial mode: one buffer, the flush callback copies before returning
+static void run_sync(int frames, uint32_t render_us)
+{
+  for (int f = 0; f < frames; f++)
+  {
+    for (int s = 0; s < STRIPS; s++)
+    {
+      render_strip(f, s, strips[0], render_us);
+      flush_job_t job = strip_job(s, strips[0]);
+      copy_sink(&job);
+    }
+  }
+}
+
+static bool frame_matches(int frame)
+{
+  for (int32_t y = 0; y < SCREEN_H; y++)
+  {
+    for (int32_t x = 0; x < SCREEN_W; x++)
+    {
+      if (fb[y * SCREEN_W + x] != pixel(frame, x, y)) return false;
+    }
+  }
+  return true;
+}
+
+static void test_order_and_stats(void)
+{
+  sink_delay_us = 200;
+  sink_order.clear();
+  sink_last = 0;
+  FlushPipe_ResetStats();
+
+  run_async(3, 0);
+
+  CHECK_EQ(sink_order.size(), 3 * STRIPS);
+  bool in_order = true;
+  for (size_t i = 0; i < sink_order.size(); i++)
+  {
+    in_order &= sink_order[i] == (int32_t)(i % STRIPS) * STRIP_LINES;
+  }
+  CHECK(in_order);
+  CHECK_EQ(sink_last, 3);
+  // Each strip was copied out of its buffer before the renderer reused it
+  CHECK(frame_matches(2));
+
+  flush_pipe_stats_t stats;
+  FlushPipe_GetStats(&stats);
+  CHECK_EQ(stats.jobs, 3 * STRIPS);
+  CHECK_EQ(stats.frames, 3);
+  CHECK_EQ(stats.bytes, 3 * SCREEN_W * SCREEN_H * PX_SIZE);
+  CHECK(stats.busy_us >= 3 * STRIPS * 200);
+}
+
+// Drain() returns only once the job in flight has left the sink
+static void test_drain(void)
+{
+  sink_delay_us = 5000;
+  sink_done = false;
+  FlushPipe_Acquire();
+  flush_job_t job = strip_job(0, strips[0]);
+  FlushPipe_Submit(&job);
+  FlushPipe_Drain();
+  CHECK(sink_done);
+
+  // And a drained pipe can be drained again without blocking
+  double start = now_us();
+  FlushPipe_Drain();
+  CHECK(now_us() - start < 1000);
+}
+
+struct BenchResult
+{
+  double sync_ms;
+  double async_ms;
+  flush_pipe_stats_t stats;
+};
+
+static BenchResult bench(uint32_t render_us, uint32_t sink_us, int frames)
+{
+  BenchResult r;
+  sink_delay_us = sink_us;
+
+  double start = now_us();
+  run_sync(frames, render_us);
+  r.sync_ms = (now_us() - start) / 1000;
+
+  FlushPipe_ResetStats();
+  start = now_us();
+  run_async(frames, render_us);
+  r.async_ms = (now_us() - start) / 1000;
+  FlushPipe_GetStats(&r.stats);
+
+  uint32_t overlap = FlushPipe_OverlapPermille(&r.stats);
+  printf("render %4u us + sink %4u us per strip: sync %6.1f ms, async %6.1f ms (%.2fx), "
+         "overlap %u.%u%%, stall %u us, sink %.2f MB/s, %.1f frames/s\n",
+         render_us, sink_us, r.sync_ms, r.async_ms, r.async_ms > 0 ? r.sync_ms / r.async_ms : 0.0,
+         overlap / 10, overlap % 10, r.stats.stall_us,
+         r.stats.busy_us ? (double)r.stats.bytes / r.stats.busy_us : 0.0,
+         r.stats.window_us ? r.stats.frames * 1e6 / r.stats.window_us : 0.0);
+  return r;
+}
+
+static void test_bench(void)
+{
+  const int frames = 10;
+  // Sink faster than the renderer: the copy hides behind rendering
+  BenchResult fast = bench(1500, 500, frames);
+  // Sink slower than the renderer: the renderer stalls, the pipe still hides the render time
+  BenchResult slow = bench(500, 1500, frames);
+  // Balanced, the best case for two buffers
+  BenchResult even = bench(1000, 1000, frames);
+
+  // Loose bounds, sleeps overshoot on a loaded host
+  CHECK(FlushPipe_OverlapPermille(&fast.stats) > 700);
+  CHECK(fast.async_ms < fast.sync_ms * 0.9);
+  CHECK(slow.async_ms < slow.sync_ms * 0.9);
+  CHECK(slow.stats.stall_us > 0);
+  CHECK(even.async_ms < even.sync_ms * 0.8);
+  CHECK_EQ(even.stats.frames, frames);
+}
+
+int main(void)
+{
+  CHECK(!FlushPipe_IsStarted());
+  FlushPipe_Drain(); // Never started: returns at once
+  CHECK(FlushPipe_Start(copy_sink, PX_SIZE));
+  CHECK(FlushPipe_IsStarted());
+
+  test_order_and_stats();
+  test_drain();
+  test_bench();
+
+  FlushPipe_Stop();
+  CHECK(!FlushPipe_IsStarted());
+  return HOST_TEST_RESULT();
+}
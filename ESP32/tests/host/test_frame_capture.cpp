@@ -0,0 +1,290 @@
+// FrameCapture (src/Display/FrameCapture.cpp) stepped like loop() does, in
+// simulated time: the stub Serial drains at 115200 baud and blocks writers
+// that do not fit, MQTT publishes take a fixed time. Every capture is decoded
+// back and compared with the framebuffer.
+
+#include <vector>
+#include "host_test.h"
+#include "Arduino.h"
+#include "../../src/Display/FrameCapture.h"
+#include "../../src/Core/MQTTManager.h"
+
+#define W 480
+#define H 480
+#define LOOP_US 5000        // Rest of loop() between two steps
+#define PUBLISH_US 1500     // One MQTT publish
+
+static uint16_t fb[W * H];
+
+// --- MQTT stand-in ---
+static bool mqtt_connected = true;
+static int mqtt_fail_after = -1; // Publishes until the connection drops, -1: never
+static int step_publishes = 0;
+static std::vector<std::vector<uint8_t>> mqtt_chunks;
+
+extern "C" bool MQTTManager_IsConnected(void) { return mqtt_connected; }
+
+extern "C" bool MQTTManager_PublishBinary(const char *topic, const uint8_t *payload, unsigned int length)
+{
+  (void)topic;
+  if (mqtt_fail_after == 0) mqtt_connected = false;
+  if (mqtt_fail_after > 0) mqtt_fail_after--;
+  if (!mqtt_connected) return false;
+  host_time_us += PUBLISH_US;
+  step_publishes++;
+  mqtt_chunks.emplace_back(payload, payload + length);
+  return true;
+}
+
+// --- Decoder, same format as tools/capture_decode.py ---
+static std::vector<uint16_t> image(W * H);
+
+static uint16_t get_u16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+static bool base64_decode(const std::string &in, std::vector<uint8_t> &out)
+{
+  static const std::string table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  if (in.size() % 4) return false;
+  out.clear();
+  for (size_t i = 0; i < in.size(); i += 4)
+  {
+    uint32_t v = 0;
+    int pad = 0;
+    for (int k = 0; k < 4; k++)
+    {
+      char c = in[i + k];
+      size_t pos = table.find(c);
+      if (c == '=') { pad++; pos = 0; }
+      else if (pos == std::string::npos) return false;
+      v = (v << 6) | (uint32_t)pos;
+    }
+    out.push_back(v >> 16);
+    if (pad < 2) out.push_back((v >> 8) & 0xFF);
+    if (pad < 1) out.push_back(v & 0xFF);
+  }
+  return true;
+}
+
+struct Decoded
+{
+  int chunks = 0;
+  int frames_ended = 0;
+  uint16_t next_seq = 0;
+  bool ok = true;
+};
+
+static void apply_chunk(const std::vector<uint8_t> &c, Decoded &d)
+{
+  if (c.size() < 5) { d.ok = false; return; }
+  uint8_t type = c[0];
+  uint16_t seq = get_u16(&c[3]);
+  if (type == FRAME_CAPTURE_CHUNK_BEGIN) d.next_seq = 0;
+  if (seq != d.next_seq++) d.ok = false;
+  d.chunks++;
+  if (type == FRAME_CAPTURE_CHUNK_END) { d.frames_ended++; return; }
+  if (type != FRAME_CAPTURE_CHUNK_TILES) return;
+
+  size_t pos = 5;
+  while (pos + 5 <= c.size())
+  {
+    int tx = c[pos], ty = c[pos + 1], enc = c[pos + 2];
+    uint16_t len = get_u16(&c[pos + 3]);
+    const uint8_t *data = &c[pos + 5];
+    pos += 5 + len;
+    if (pos > c.size()) { d.ok = false; return; }
+    std::vector<uint16_t> px;
+    if (enc == FRAME_CAPTURE_ENC_RAW)
+    {
+      for (int i = 0; i < len; i += 2) px.push_back(get_u16(data + i));
+    }
+    else
+    {
+      for (int i = 0; i < len; i += 3) px.insert(px.end(), data[i] + 1, get_u16(data + i + 1));
+    }
+    if (px.size() != FRAME_CAPTURE_TILE * FRAME_CAPTURE_TILE) { d.ok = false; return; }
+    for (int y = 0; y < FRAME_CAPTURE_TILE; y++)
+    {
+      for (int x = 0; x < FRAME_CAPTURE_TILE; x++)
+      {
+        image[(ty * FRAME_CAPTURE_TILE + y) * W + tx * FRAME_CAPTURE_TILE + x] = px[y * FRAME_CAPTURE_TILE + x];
+      }
+    }
+  }
+}
+
+// Every "CAP " line in the Serial output; anything else is log text
+static Decoded decode_serial(void)
+{
+  Decoded d;
+  const std::string &out = Serial.output;
+  size_t pos = 0;
+  while (pos < out.size())
+  {
+    size_t end = out.find("\r\n", pos);
+    if (end == std::string::npos) break;
+    std::string line = out.substr(pos, end - pos);
+    pos = end + 2;
+    if (line.compare(0, 4, "CAP ") != 0) continue;
+    std::vector<uint8_t> chunk;
+    if (!base64_decode(line.substr(4), chunk)) { d.ok = false; continue; }
+    apply_chunk(chunk, d);
+  }
+  return d;
+}
+
+static Decoded decode_mqtt(void)
+{
+  Decoded d;
+  for (auto &c : mqtt_chunks) apply_chunk(c, d);
+  return d;
+}
+
+// --- Driving it like loop() ---
+struct Run
+{
+  int steps = 0;
+  uint32_t max_step_us = 0;    // Steps that sent capture data
+  uint32_t last_step_us = 0;   // The step that finished and printed the stats line
+  uint32_t capture_blocked_us = 0;
+  int max_publishes = 0;
+};
+
+static Run run_capture(bool log_between_steps)
+{
+  Run r;
+  while (FrameCaptureIsRunning())
+  {
+    uint32_t t0 = host_time_us;
+    uint32_t blocked = Serial.blocked_us;
+    step_publishes = 0;
+    FrameCaptureUpdate();
+    r.steps++;
+    // 结束时的统计行是普通日志，和 loop() 里其他 Serial.printf 一样会阻塞
+    if (FrameCaptureIsRunning())
+    {
+      r.max_step_us = std::max(r.max_step_us, host_time_us - t0);
+      r.capture_blocked_us += Serial.blocked_us - blocked;
+    }
+    else
+    {
+      r.last_step_us = host_time_us - t0;
+    }
+    r.max_publishes = std::max(r.max_publishes, step_publishes);
+    if (log_between_steps) Serial.println("MQTT Status: something else logging");
+    host_time_us += LOOP_US;
+    if (r.steps > 1000000) break;
+  }
+  return r;
+}
+
+static void fill_frame(void)
+{
+  srand(7);
+  for (int i = 0; i < W * H; i++) fb[i] = (i / W) / 40 * 1000;   // Bands: RLE
+  for (int y = 100; y < 140; y++)
+    for (int x = 200; x < 260; x++) fb[y * W + x] = rand();       // Noise: raw
+}
+
+static void test_serial_buffered(void)
+{
+  fill_frame();
+  Serial.reset(FRAME_CAPTURE_SERIAL_TX_BUFFER);
+  std::fill(image.begin(), image.end(), 0);
+
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_SERIAL, true));
+  Run r = run_capture(true);
+  const frame_capture_stats_t *stats = FrameCaptureGetStats();
+  Decoded d = decode_serial();
+
+  printf("serial key frame: %u chunks over %d steps, %u sink waits, max step %u us, "
+         "capture blocked %u us, log lines blocked %u us\n",
+         stats->chunks, r.steps, stats->sink_waits, r.max_step_us, r.capture_blocked_us,
+         Serial.blocked_us - r.capture_blocked_us);
+  CHECK(d.ok);
+  CHECK_EQ(d.frames_ended, 1);
+  CHECK_EQ(d.chunks, stats->chunks);
+  CHECK(memcmp(image.data(), fb, sizeof(fb)) == 0);
+  // The capture never waited on the UART, it only wrote whole lines that
+  // fit; the log lines in between did wait, the UART was kept busy
+  CHECK_EQ(r.capture_blocked_us, 0);
+  CHECK_EQ(stats->blocking_sends, 0);
+  CHECK(stats->sink_waits > 0);
+  CHECK_EQ(r.max_step_us, 0);
+  CHECK(r.last_step_us <= 200 * Serial.us_per_byte);
+
+  // Delta on top of it
+  for (int y = 300; y < 310; y++)
+    for (int x = 5; x < 470; x++) fb[y * W + x] = 0xF800;
+  Serial.reset(FRAME_CAPTURE_SERIAL_TX_BUFFER);
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_SERIAL, false));
+  r = run_capture(true);
+  d = decode_serial();
+  printf("serial delta: %u/%u tiles\n", stats->tiles_changed, (W / 16) * (H / 16));
+  CHECK(d.ok);
+  CHECK(stats->tiles_changed > 0 && stats->tiles_changed < (W / 16) * (H / 16));
+  CHECK(memcmp(image.data(), fb, sizeof(fb)) == 0);
+  CHECK_EQ(r.capture_blocked_us, 0);
+}
+
+// TX buffer smaller than one line: waits FRAME_CAPTURE_SINK_WAIT_MS, then
+// falls back to blocking writes instead of stalling forever
+static void test_serial_small_buffer(void)
+{
+  fill_frame();
+  Serial.reset(128);
+  std::fill(image.begin(), image.end(), 0);
+
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_SERIAL, true));
+  Run r = run_capture(false);
+  const frame_capture_stats_t *stats = FrameCaptureGetStats();
+  Decoded d = decode_serial();
+
+  printf("serial 128 byte buffer: %u chunks, %u blocking, max step %u us\n",
+         stats->chunks, stats->blocking_sends, r.max_step_us);
+  CHECK(d.ok);
+  CHECK(memcmp(image.data(), fb, sizeof(fb)) == 0);
+  CHECK_EQ(stats->blocking_sends, stats->chunks - 2); // BEGIN and END lines fit in 128 bytes
+  CHECK(r.max_step_us <= FRAME_CAPTURE_MAX_LINE * Serial.us_per_byte);
+}
+
+static void test_mqtt(void)
+{
+  fill_frame();
+  Serial.reset(FRAME_CAPTURE_SERIAL_TX_BUFFER);
+  mqtt_chunks.clear();
+  std::fill(image.begin(), image.end(), 0);
+
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_MQTT, true));
+  Run r = run_capture(false);
+  const frame_capture_stats_t *stats = FrameCaptureGetStats();
+  Decoded d = decode_mqtt();
+
+  printf("mqtt key frame: %u chunks over %d steps, max step %u us\n", stats->chunks, r.steps, r.max_step_us);
+  CHECK(d.ok);
+  CHECK(memcmp(image.data(), fb, sizeof(fb)) == 0);
+  CHECK_EQ(r.max_publishes, 1);
+  CHECK(r.max_step_us <= PUBLISH_US);
+
+  // Connection drops mid-capture: aborted, and the next one is a key frame
+  for (int i = 0; i < W * H; i += 7) fb[i] ^= 0x1F;
+  mqtt_chunks.clear();
+  mqtt_fail_after = 3;
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_MQTT, false));
+  run_capture(false);
+  CHECK(!FrameCaptureIsRunning());
+  CHECK_EQ(mqtt_chunks.size(), 3);
+  mqtt_connected = true;
+  mqtt_fail_after = -1;
+  mqtt_chunks.clear();
+  CHECK(FrameCaptureStart(fb, W, H, FRAME_CAPTURE_SINK_MQTT, false));
+  run_capture(false);
+  CHECK(mqtt_chunks.size() > 2 && mqtt_chunks[0][10] == 1); // BEGIN: keyframe flag
+}
+
+int main(void)
+{
+  test_serial_buffered();
+  test_serial_small_buffer();
+  test_mqtt();
+  return HOST_TEST_RESULT();
+}
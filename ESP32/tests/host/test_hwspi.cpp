@@ -0,0 +1,246 @@
+// Indicator_HWSPI against Indicator_SWSPI: both buses get the same calls and
+// the probe must see the same bits, at the same times, inside the same CS
+// frames. The SPI host is a stub that clocks each transaction's t.length bits
+// into the probe, so frames that do not end on a byte boundary and the
+// PANEL_FRAME_MAX_BYTES split are covered too.
+
+#include <functional>
+#include "host_test.h"
+#include "../../Indicator_SWSPI.h"
+#include "../../Indicator_HWSPI.h"
+#include "../../src/Display/Indicator_RGB_Display.h"
+#include "panel_probe.h"
+
+#define TABLE st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations)
+#define FRAME_WORDS (PANEL_FRAME_MAX_BYTES * 8 / 9) // 9-bit words in one transaction
+
+PanelProbe probe;
+
+struct SpiTransaction
+{
+  size_t length;
+  std::vector<uint8_t> buf;
+  uint32_t time_us;
+};
+
+static std::vector<SpiTransaction> transactions;
+static uint32_t transmits_cs_high = 0;
+static uint32_t max_transfer_sz = 0;
+
+esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t *config, int)
+{
+  max_transfer_sz = config->max_transfer_sz;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t, const spi_device_interface_config_t *config,
+                             spi_device_handle_t *handle)
+{
+  CHECK_EQ(config->spics_io_num, -1);
+  static int device;
+  *handle = (spi_device_handle_t)&device;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t, spi_transaction_t *t)
+{
+  const uint8_t *tx = (const uint8_t *)t->tx_buffer;
+  transactions.push_back({t->length, std::vector<uint8_t>(tx, tx + (t->length + 7) / 8), host_time_us});
+  transmits_cs_high += probe.cs;
+  probe.clock_buffer(tx, t->length);
+  return ESP_OK;
+}
+
+// What the panel saw for one run
+struct Capture
+{
+  std::vector<uint8_t> bits;
+  std::vector<PanelWord> words;
+  std::vector<PanelEdge> cs_edges;
+};
+
+static Capture run(Indicator_PanelBus &bus, const std::function<void(Indicator_PanelBus &)> &calls, uint32_t start_us)
+{
+  host_time_us = start_us;
+  probe.clear();
+  transactions.clear();
+  transmits_cs_high = 0;
+  bus.resetStats();
+  calls(bus);
+  return {probe.bits, probe.words, probe.cs_edges};
+}
+
+static void check_same(const char *name, const Capture &hw, const Capture &sw, bool aligned)
+{
+  CHECK(!sw.bits.empty());
+  CHECK(hw.bits == sw.bits);
+  // Word stamps only mean something while every write is a 9-bit word
+  if (aligned)
+  {
+    CHECK(hw.words == sw.words);
+  }
+  CHECK_EQ(hw.cs_edges.size(), sw.cs_edges.size());
+  for (size_t i = 0; i < hw.cs_edges.size() && i < sw.cs_edges.size(); i++)
+  {
+    CHECK_EQ(hw.cs_edges[i].level, sw.cs_edges[i].level);
+    CHECK_EQ(hw.cs_edges[i].time_us, sw.cs_edges[i].time_us);
+    CHECK_EQ(hw.cs_edges[i].bits_before, sw.cs_edges[i].bits_before);
+  }
+  CHECK_EQ(transmits_cs_high, 0);
+  CHECK_EQ(probe.clocks_cs_high, 0);
+
+  size_t max_length = 0;
+  for (const SpiTransaction &t : transactions)
+  {
+    max_length = t.length > max_length ? t.length : max_length;
+  }
+  CHECK(max_length <= PANEL_FRAME_MAX_BYTES * 8);
+  printf("%s: %zu bits, %zu CS edges, %zu transactions, longest %zu bits\n",
+         name, sw.bits.size(), sw.cs_edges.size(), transactions.size(), max_length);
+}
+
+// Transactions a run of 9-bit words needs, flushed at the end
+static size_t frames_for(size_t words)
+{
+  return (words + FRAME_WORDS - 1) / FRAME_WORDS;
+}
+
+static void test_table(Indicator_HWSPI &hw, Indicator_SWSPI &sw)
+{
+  auto calls = [](Indicator_PanelBus &bus) { bus.batchOperation(TABLE); };
+  Capture s = run(sw, calls, 1000000);
+  Capture h = run(hw, calls, 1000000);
+  check_same("table", h, s, true);
+
+  // One flush before the Sleep Out delay, one at the end
+  const ST7701InitStreamView v = st7701_indicator_init_stream.view();
+  size_t expected = 0;
+  for (uint8_t i = 0; i < v.segment_count; i++)
+  {
+    expected += frames_for(v.segments[i].words);
+  }
+  CHECK_EQ(transactions.size(), expected);
+  CHECK_EQ(hw.stats().transactions, expected);
+  CHECK_EQ(hw.stats().words, sw.stats().words);
+  CHECK_EQ(hw.stats().cs_edges, 2);
+  CHECK_EQ(hw.stats().batch_us, sw.stats().batch_us);
+}
+
+static void test_stream(Indicator_HWSPI &hw, Indicator_SWSPI &sw)
+{
+  auto calls = [](Indicator_PanelBus &bus) { bus.writeInitStream(st7701_indicator_init_stream.view()); };
+  Capture s = run(sw, calls, 2000000);
+  Capture h = run(hw, calls, 2000000);
+  check_same("stream", h, s, true);
+  CHECK_EQ(h.words.size(), st7701_indicator_init_words);
+  CHECK_EQ(hw.stats().words, sw.stats().words);
+  CHECK_EQ(hw.stats().batch_us, sw.stats().batch_us);
+
+  // Segments start on a new frame, the one before the delay is not held back
+  const ST7701InitSegment &first = st7701_indicator_init_stream.segments[0];
+  size_t before_delay = frames_for(first.words);
+  CHECK(transactions.size() > before_delay);
+  CHECK_EQ(transactions[before_delay - 1].time_us, 2000000);
+  CHECK_EQ(transactions[before_delay].time_us, 2000000 + first.delay_ms * 1000);
+}
+
+// Commands, data, 16-bit and 8-bit raw writes and repeats, in two CS frames
+static void test_mixed(Indicator_HWSPI &hw, Indicator_SWSPI &sw)
+{
+  auto calls = [](Indicator_PanelBus &bus) {
+    static uint16_t pixels[40];
+    static uint8_t bytes[70];
+    static uint8_t params[] = {0xB0, 0xB1, 0xB2};
+    for (size_t i = 0; i < 40; i++) pixels[i] = (uint16_t)(0x1234 * i + 7);
+    for (size_t i = 0; i < 70; i++) bytes[i] = (uint8_t)(i * 37);
+
+    bus.beginWrite();
+    bus.writeCommand(0x2A);
+    bus.write16(0x0010);
+    bus.writeCommand16(0x3A55);
+    bus.writeCommandBytes(params, sizeof(params));
+    bus.write(0xA5);
+    bus.writeRepeat(0xF81F, 40); // 80 words, over a frame
+    bus.writeRepeat(0xFFFF, 3);
+    bus.writePixels(pixels, 40); // 640 raw bits
+    bus.writeBytes(bytes, 70);   // 560 raw bits
+    bus.endWrite();
+    delay(5);
+    bus.beginWrite();
+    bus.writeCommand(0x29);
+    bus.endWrite();
+  };
+  Capture s = run(sw, calls, 3000000);
+  Capture h = run(hw, calls, 3000000);
+  check_same("mixed", h, s, false);
+  CHECK_EQ(h.cs_edges.size(), 4);
+  CHECK_EQ(s.bits.size(), 9 * (1 + 2 + 2 + 3 + 1 + 80 + 6 + 1) + 16 * 40 + 8 * 70);
+  CHECK(transactions.size() > 4); // Split more than once
+}
+
+// Frame boundaries: a full frame goes out as one transaction, one more word
+// opens the next; lengths are the exact bit counts, not rounded to bytes
+static void test_frames(Indicator_HWSPI &hw)
+{
+  auto words = [](size_t n) {
+    return [n](Indicator_PanelBus &bus) {
+      bus.beginWrite();
+      for (size_t i = 0; i < n; i++) bus.write((uint8_t)i);
+      bus.endWrite();
+    };
+  };
+
+  run(hw, words(1), 4000000);
+  CHECK_EQ(transactions.size(), 1);
+  CHECK_EQ(transactions[0].length, 9);
+  CHECK_EQ(transactions[0].buf.size(), 2);
+  CHECK_EQ(transactions[0].buf[1] & 0x7F, 0); // Bits after length are zero
+  CHECK_EQ(probe.bits.size(), 9);
+
+  run(hw, words(FRAME_WORDS), 4000000);
+  CHECK_EQ(transactions.size(), 1);
+  CHECK_EQ(transactions[0].length, FRAME_WORDS * 9);
+
+  run(hw, words(FRAME_WORDS + 1), 4000000);
+  CHECK_EQ(transactions.size(), 2);
+  CHECK_EQ(transactions[0].length, FRAME_WORDS * 9);
+  CHECK_EQ(transactions[1].length, 9);
+  CHECK_EQ(hw.stats().transactions, 2);
+  CHECK_EQ(probe.words.size(), FRAME_WORDS + 1);
+  CHECK_EQ(probe.partial_releases, 0);
+
+  // 16-bit raw words fill the 64 bytes exactly
+  auto pixels = [](Indicator_PanelBus &bus) {
+    static uint16_t p[33];
+    bus.beginWrite();
+    bus.writePixels(p, 33);
+    bus.endWrite();
+  };
+  run(hw, pixels, 4000000);
+  CHECK_EQ(transactions.size(), 2);
+  CHECK_EQ(transactions[0].length, PANEL_FRAME_MAX_BYTES * 8);
+  CHECK_EQ(transactions[1].length, 16);
+
+  // Nothing buffered, nothing sent
+  run(hw, [](Indicator_PanelBus &bus) { bus.beginWrite(); bus.endWrite(); }, 4000000);
+  CHECK(transactions.empty());
+}
+
+int main(void)
+{
+  ioex.reset(0xFFFF, 0xFFFF);
+  probe_attach();
+
+  Indicator_SWSPI sw(GFX_NOT_DEFINED, EXPANDER_IO_LCD_CS, SPI_SCLK, SPI_MOSI, GFX_NOT_DEFINED);
+  Indicator_HWSPI hw(EXPANDER_IO_LCD_CS, SPI_SCLK, SPI_MOSI);
+  CHECK(sw.begin());
+  CHECK(hw.begin());
+  CHECK_EQ(max_transfer_sz, PANEL_FRAME_MAX_BYTES);
+  CHECK(probe.cs_edges.empty());
+
+  test_table(hw, sw);
+  test_stream(hw, sw);
+  test_mixed(hw, sw);
+  test_frames(hw);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,186 @@
+// The precompiled ST7701 init stream (ST7701Init::encode) decoded bit by bit
+// here, without the encoder's own walk() or panel_frame_get(), and compared
+// with what Arduino_GFX's batchOperation() sends for the same table through
+// a recording bus: every 9-bit word, every segment and delay, and zero padding.
+// ST7701Init::matches(), which backs the static_assert in Indicator_RGB_Display.h,
+// must reject streams that have been tampered with.
+
+#include <string.h>
+#include "host_test.h"
+#include "../../src/Display/Indicator_RGB_Display.h"
+#include "panel_probe.h"
+
+PanelProbe probe;
+
+// Exercises the operations the Indicator table does not use
+static constexpr uint8_t synthetic_operations[] = {
+    BEGIN_WRITE,
+    WRITE_COMMAND_16, 0x12, 0x34,
+    WRITE_C16_D16, 0xAB, 0xCD, 0x01, 0x02,
+    WRITE_DATA_8, 0xFF,
+    END_WRITE,
+    DELAY, 5,
+    BEGIN_WRITE,
+    WRITE_DATA_16, 0x80, 0x01,
+    WRITE_C8_BYTES, 0x2A, 3, 0x00, 0x01, 0x02,
+    WRITE_BYTES, 2, 0x55, 0xAA,
+    END_WRITE,
+    DELAY, 7,
+    BEGIN_WRITE,
+    WRITE_C8_D16, 0x36, 0x12, 0x34,
+    WRITE_C8_D8, 0x3A, 0x55,
+    END_WRITE,
+    DELAY, 9, // Ends with a delay: an empty last segment
+};
+
+static constexpr size_t synthetic_words = ST7701Init::countWords(synthetic_operations, sizeof(synthetic_operations));
+static constexpr size_t synthetic_segments = ST7701Init::countSegments(synthetic_operations, sizeof(synthetic_operations));
+static constexpr ST7701Init::Stream<synthetic_words, synthetic_segments> synthetic_stream =
+    ST7701Init::encode<synthetic_words, synthetic_segments>(synthetic_operations, sizeof(synthetic_operations));
+
+struct Expected
+{
+  std::vector<uint16_t> words;
+  std::vector<ST7701InitSegment> segments;
+};
+
+// Runs the table through the library's interpreter. Delays only show up as
+// time passing, so a segment ends wherever the next word (or the end of the
+// table) is later than the previous word.
+static Expected reference(const uint8_t *ops, size_t len)
+{
+  const uint32_t start_us = 1000000;
+  host_time_us = start_us;
+  RecordingBus bus;
+  bus.batchOperation(ops, len);
+
+  Expected e;
+  uint32_t last_us = start_us;
+  uint16_t count = 0;
+  for (const PanelWord &w : bus.words)
+  {
+    if (w.time_us != last_us)
+    {
+      e.segments.push_back({count, (uint8_t)((w.time_us - last_us) / 1000)});
+      count = 0;
+      last_us = w.time_us;
+    }
+    e.words.push_back(w.value);
+    count++;
+  }
+  if (host_time_us != last_us)
+  {
+    e.segments.push_back({count, (uint8_t)((host_time_us - last_us) / 1000)});
+    count = 0;
+  }
+  e.segments.push_back({count, 0});
+  return e;
+}
+
+// Word index of a packed stream: 9 bits starting at bit index*9, MSB of byte 0 first
+static uint16_t decode_word(const uint8_t *bits, size_t index)
+{
+  uint16_t w = 0;
+  for (size_t b = index * 9; b < index * 9 + 9; b++)
+  {
+    w = (uint16_t)((w << 1) | ((bits[b / 8] >> (7 - b % 8)) & 1));
+  }
+  return w;
+}
+
+static void check_stream(const char *name, ST7701InitStreamView v, size_t bytes, const Expected &e)
+{
+  CHECK_EQ(v.words, e.words.size());
+  CHECK_EQ(bytes, (e.words.size() * 9 + 7) / 8);
+  CHECK_EQ(v.segment_count, e.segments.size());
+
+  size_t mismatched = 0;
+  for (size_t i = 0; i < v.words && i < e.words.size(); i++)
+  {
+    if (decode_word(v.bits, i) != e.words[i])
+    {
+      if (!mismatched) fprintf(stderr, "%s: word %zu is 0x%03x, expected 0x%03x\n", name, i, decode_word(v.bits, i), e.words[i]);
+      mismatched++;
+    }
+  }
+  CHECK_EQ(mismatched, 0);
+
+  size_t total = 0;
+  for (size_t s = 0; s < v.segment_count && s < e.segments.size(); s++)
+  {
+    CHECK_EQ(v.segments[s].words, e.segments[s].words);
+    CHECK_EQ(v.segments[s].delay_ms, e.segments[s].delay_ms);
+    total += v.segments[s].words;
+  }
+  CHECK_EQ(total, v.words);
+
+  // Bits after the last word are never clocked out and must be zero
+  for (size_t b = (size_t)v.words * 9; b < bytes * 8; b++)
+  {
+    CHECK_EQ((v.bits[b / 8] >> (7 - b % 8)) & 1, 0);
+  }
+  printf("%s: %u words in %u segments, %zu bytes\n", name, v.words, v.segment_count, bytes);
+}
+
+static void test_indicator_table(void)
+{
+  Expected e = reference(st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations));
+  CHECK_EQ(e.words.size(), 217);
+  CHECK_EQ(e.segments.size(), 2);
+  CHECK_EQ(e.segments[0].delay_ms, 120); // Sleep Out
+  check_stream("indicator", st7701_indicator_init_stream.view(), sizeof(st7701_indicator_init_stream.bits), e);
+}
+
+static void test_synthetic_table(void)
+{
+  Expected e = reference(synthetic_operations, sizeof(synthetic_operations));
+  // 2 + 4 + 1, then 2 + 4 + 2, then 3 + 2
+  CHECK_EQ(e.words.size(), 20);
+  CHECK_EQ(e.segments.size(), 4);
+  CHECK_EQ(e.segments[3].words, 0);
+  check_stream("synthetic", synthetic_stream.view(), sizeof(synthetic_stream.bits), e);
+  CHECK(ST7701Init::matches(synthetic_stream, synthetic_operations, sizeof(synthetic_operations)));
+}
+
+// The compile-time check is only worth something if it notices a bad stream
+static void test_matches_rejects(void)
+{
+  const uint8_t *ops = st7701_indicator_init_operations;
+  const size_t len = sizeof(st7701_indicator_init_operations);
+  const size_t last_bit = st7701_indicator_init_words * 9 - 1;
+
+  auto s = st7701_indicator_init_stream;
+  CHECK(ST7701Init::matches(s, ops, len));
+
+  s.bits[0] ^= 0x80; // D/C of the first word
+  CHECK(!ST7701Init::matches(s, ops, len));
+
+  s = st7701_indicator_init_stream;
+  s.bits[last_bit / 8] ^= 0x80 >> (last_bit % 8);
+  CHECK(!ST7701Init::matches(s, ops, len));
+
+  s = st7701_indicator_init_stream;
+  s.bits[sizeof(s.bits) - 1] |= 0x01; // Padding
+  CHECK(!ST7701Init::matches(s, ops, len));
+
+  s = st7701_indicator_init_stream;
+  s.segments[0].delay_ms = 100;
+  CHECK(!ST7701Init::matches(s, ops, len));
+
+  s = st7701_indicator_init_stream;
+  s.segments[0].words--;
+  s.segments[1].words++;
+  CHECK(!ST7701Init::matches(s, ops, len));
+
+  // A table the encoder does not understand cannot be sized at all
+  static constexpr uint8_t unknown[] = {BEGIN_WRITE, 0xEE, END_WRITE};
+  CHECK_EQ(ST7701Init::countWords(unknown, sizeof(unknown)), ST7701Init::INVALID);
+}
+
+int main(void)
+{
+  test_indicator_table();
+  test_synthetic_table();
+  test_matches_rejects();
+  return HOST_TEST_RESULT();
+}
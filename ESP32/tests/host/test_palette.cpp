@@ -0,0 +1,146 @@
+// WindChimePalette (src/UI/WindChimePalette.c), the fixed index palette of
+// L8 rendering. Checks that slots are handed out without ever changing the
+// meaning of an index already on screen, that the neutral band and the colour
+// slots do not overlap, and that a byte LVGL derives from an index-coded grey
+// comes back as that index.
+
+#include "host_test.h"
+#include "../../src/UI/WindChimePalette.h"
+
+static lv_color_t rgb(uint8_t r, uint8_t g, uint8_t b)
+{
+  lv_color_t c;
+  c.red = r;
+  c.green = g;
+  c.blue = b;
+  return c;
+}
+
+static uint32_t rgb32(lv_color_t c)
+{
+  return ((uint32_t)c.red << 16) | ((uint32_t)c.green << 8) | c.blue;
+}
+
+// What LVGL 9 stores for a colour in an L8 buffer (lv_color_luminance)
+static uint8_t l8_byte(lv_color_t c)
+{
+  return (uint8_t)((c.red * 77 + c.green * 151 + c.blue * 28) >> 8);
+}
+
+static const lv_color_t fixed[3] = { rgb(0x4A, 0x90, 0xE2), rgb(0x7B, 0x68, 0xEE), rgb(0x50, 0xC8, 0x78) };
+
+static void test_slots(void)
+{
+  WindChimePalettePreset(fixed, 3);
+  bool changed = false;
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    CHECK_EQ(WindChimePaletteSlot(fixed[i], &changed), i);
+    CHECK_EQ(WindChimePaletteFind(rgb32(fixed[i])), i);
+  }
+  CHECK(!changed);
+
+  // New colours take free slots, once
+  lv_color_t red = rgb(0xFF, 0x20, 0x20);
+  CHECK_EQ(WindChimePaletteSlot(red, &changed), 3);
+  CHECK(changed);
+  changed = false;
+  CHECK_EQ(WindChimePaletteSlot(red, &changed), 3);
+  CHECK(!changed);
+
+  for (uint8_t i = 4; i < WINDCHIME_PALETTE_SLOTS; i++)
+  {
+    changed = false;
+    CHECK_EQ(WindChimePaletteSlot(rgb(i * 20, 0, 0x40), &changed), i);
+    CHECK(changed);
+  }
+
+  // Full: the nearest slot, the palette stays as it is
+  changed = false;
+  CHECK_EQ(WindChimePaletteSlot(rgb(0xF0, 0x20, 0x20), &changed), 3);
+  CHECK(!changed);
+  CHECK_EQ(WindChimePaletteFind(0x4B90E2), 0);
+
+  // Once released, custom slots are handed out again from the first one
+  WindChimePaletteReleaseCustom();
+  changed = false;
+  CHECK_EQ(WindChimePaletteSlot(rgb(0x10, 0x10, 0x10), &changed), 3);
+  CHECK(changed);
+  CHECK_EQ(WindChimePaletteFind(0x101010), 3);
+}
+
+static void test_indices(void)
+{
+  CHECK_EQ(WindChimePaletteIndex(0, 0), 0);
+  CHECK_EQ(WindChimePaletteIndex(5, 7), 0);
+  for (uint8_t slot = 0; slot < WINDCHIME_PALETTE_SLOTS; slot++)
+  {
+    uint8_t first = WINDCHIME_PALETTE_NEUTRAL + slot * WINDCHIME_PALETTE_LEVELS;
+    uint8_t prev = 0;
+    bool in_band = true, monotonic = true;
+    for (uint32_t opa = 8; opa < 256; opa++)
+    {
+      uint8_t index = WindChimePaletteIndex(slot, (uint8_t)opa);
+      in_band &= index >= first && index < first + WINDCHIME_PALETTE_LEVELS;
+      monotonic &= index >= prev;
+      prev = index;
+    }
+    CHECK(in_band);
+    CHECK(monotonic);
+    CHECK_EQ(WindChimePaletteIndex(slot, 255), first + WINDCHIME_PALETTE_LEVELS - 1);
+  }
+}
+
+static void test_colors(void)
+{
+  WindChimePalettePreset(fixed, 3);
+  bool changed = false;
+  lv_color_t custom = rgb(0xFF, 0x80, 0x00);
+  uint8_t slot = WindChimePaletteSlot(custom, &changed);
+
+  lv_color_t colors[WINDCHIME_PALETTE_SIZE];
+  WindChimePaletteGetColors(colors);
+  CHECK_EQ(rgb32(colors[0]), 0x000000);
+  CHECK_EQ(rgb32(colors[WINDCHIME_PALETTE_NEUTRAL - 1]), 0xFFFFFF);
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    CHECK_EQ(rgb32(colors[WindChimePaletteIndex(i, 255)]), rgb32(fixed[i]));
+  }
+  CHECK_EQ(rgb32(colors[WindChimePaletteIndex(slot, 255)]), rgb32(custom));
+  // Half opacity is about half the colour
+  lv_color_t half = colors[WindChimePaletteIndex(slot, 128)];
+  CHECK(half.red >= 0x78 && half.red <= 0x88);
+  CHECK_EQ(half.blue, 0);
+
+  // Widgets: a grey of the same luminance, whose L8 byte is in the neutral band
+  // and expands back to about that luminance
+  bool neutral = true, close = true;
+  for (uint32_t c = 0; c < 0x1000000; c += 0x030507)
+  {
+    lv_color_t in = rgb(c >> 16, c >> 8, c);
+    lv_color_t grey = WindChimePaletteNeutral(in);
+    uint8_t byte = l8_byte(grey);
+    neutral &= grey.red == grey.green && grey.green == grey.blue && byte == grey.red &&
+               byte < WINDCHIME_PALETTE_NEUTRAL;
+    int32_t diff = (int32_t)colors[byte].red - l8_byte(in);
+    close &= diff >= -2 && diff <= 2;
+  }
+  CHECK(neutral);
+  CHECK(close);
+
+  // The rasterizer writes an index as a grey: LVGL reads the same byte back
+  bool exact = true;
+  for (uint32_t i = 0; i < WINDCHIME_PALETTE_SIZE; i++)
+  {
+    exact &= l8_byte(rgb(i, i, i)) == i;
+  }
+  CHECK(exact);
+}
+
+int main(void)
+{
+  test_slots();
+  test_indices();
+  test_colors();
+  return HOST_TEST_RESULT();
+}
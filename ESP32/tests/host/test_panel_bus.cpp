@@ -0,0 +1,139 @@
+// Indicator_SWSPI running the ST7701 init table through Arduino_GFX's
+// batchOperation(): the panel gets the same words as the table asks for,
+// CS goes low once and high once around the Sleep Out delay, and the
+// Indicator_PanelBus_Stats counters match what the probe saw on the wires.
+
+#include "host_test.h"
+#include "../../Indicator_SWSPI.h"
+#include "../../src/Display/Indicator_RGB_Display.h"
+#include "panel_probe.h"
+
+#define TABLE st7701_indicator_init_operations, sizeof(st7701_indicator_init_operations)
+#define TABLE_WORDS 217
+#define SLEEP_OUT_DELAY_US 120000
+
+PanelProbe probe;
+
+static std::vector<PanelWord> reference(uint32_t start_us)
+{
+  host_time_us = start_us;
+  RecordingBus ref;
+  ref.batchOperation(TABLE);
+  return ref.words;
+}
+
+// MOSI writes a bus that skips unchanged levels needs for these words
+static uint32_t level_changes(const std::vector<PanelWord> &words, int level)
+{
+  uint32_t changes = 0;
+  for (const PanelWord &w : words)
+  {
+    for (int b = 8; b >= 0; b--)
+    {
+      int bit = (w.value >> b) & 1;
+      changes += bit != level;
+      level = bit;
+    }
+  }
+  return changes;
+}
+
+// One CS frame: low before the first bit, high after the last, the delay inside
+static void check_one_frame(const std::vector<PanelWord> &ref, uint32_t start_us)
+{
+  CHECK_EQ(probe.cs_edges.size(), 2);
+  if (probe.cs_edges.size() != 2) return;
+  CHECK_EQ(probe.cs_edges[0].level, 0);
+  CHECK_EQ(probe.cs_edges[0].bits_before, 0);
+  CHECK_EQ(probe.cs_edges[0].time_us, start_us);
+  CHECK_EQ(probe.cs_edges[1].level, 1);
+  CHECK_EQ(probe.cs_edges[1].bits_before, TABLE_WORDS * 9);
+  CHECK_EQ(probe.cs_edges[1].time_us, ref.back().time_us);
+  CHECK_EQ(probe.cs_edges[1].time_us - probe.cs_edges[0].time_us, SLEEP_OUT_DELAY_US);
+  CHECK_EQ(probe.clocks_cs_high, 0);
+  CHECK_EQ(probe.partial_releases, 0);
+}
+
+static void test_batch(Indicator_SWSPI &bus)
+{
+  std::vector<PanelWord> ref = reference(1000000);
+  CHECK_EQ(ref.size(), TABLE_WORDS);
+
+  host_time_us = 1000000;
+  probe.clear();
+  ioex.log.clear();
+  bus.resetStats();
+  bus.batchOperation(TABLE);
+
+  // Same words, and the ones after Sleep Out only once the delay is over
+  CHECK(probe.words == ref);
+  check_one_frame(ref, 1000000);
+  CHECK_EQ(ioex.log.size(), 2);
+
+  const Indicator_PanelBus_Stats &s = bus.stats();
+  printf("batch: %u words, CS edges %u (%u saved), MOSI writes %u (%u saved), %u us\n",
+         s.words, s.cs_edges, s.cs_edges_saved, s.mosi_writes, s.mosi_writes_saved, s.batch_us);
+  CHECK_EQ(s.words, TABLE_WORDS);
+  CHECK_EQ(s.cs_edges, 2);
+  CHECK_EQ(s.cs_edges_saved, 2); // The END_WRITE/BEGIN_WRITE pair around the delay
+  CHECK_EQ(s.mosi_writes, probe.mosi_writes);
+  CHECK_EQ(s.mosi_writes, level_changes(ref, LOW));
+  CHECK_EQ(s.mosi_writes + s.mosi_writes_saved, TABLE_WORDS * 9);
+  CHECK_EQ(s.transactions, 0);
+  CHECK_EQ(s.batch_us, SLEEP_OUT_DELAY_US);
+}
+
+// The library's interpreter without the override, what the bus did before
+// batching: same words, but CS is released and re-asserted around the delay
+static void test_unbatched(Indicator_SWSPI &bus)
+{
+  std::vector<PanelWord> ref = reference(3000000);
+  host_time_us = 3000000;
+  probe.clear();
+  bus.resetStats();
+  bus.Arduino_DataBus::batchOperation(TABLE);
+
+  CHECK(probe.words == ref);
+  CHECK_EQ(probe.cs_edges.size(), 4);
+  CHECK_EQ(bus.stats().cs_edges, 4);
+  CHECK_EQ(bus.stats().cs_edges_saved, 0);
+  printf("unbatched: CS edges %zu\n", probe.cs_edges.size());
+}
+
+// begin() with the precompiled stream: the same words in the same CS frame
+static void test_stream_begin(void)
+{
+  Indicator_SWSPI bus(GFX_NOT_DEFINED, EXPANDER_IO_LCD_CS, SPI_SCLK, SPI_MOSI, GFX_NOT_DEFINED);
+  bus.setInitStream(st7701_indicator_init_stream.view());
+  host_time_us = 5000000;
+  probe.clear();
+  CHECK(bus.begin());
+
+  std::vector<PanelWord> ref = reference(5000000);
+  CHECK(probe.words == ref);
+  check_one_frame(ref, 5000000);
+
+  const Indicator_PanelBus_Stats &s = bus.stats();
+  CHECK_EQ(s.words, TABLE_WORDS);
+  CHECK_EQ(s.cs_edges, 2);
+  CHECK_EQ(s.mosi_writes + 1, probe.mosi_writes); // begin() drives MOSI low first
+  CHECK_EQ(s.mosi_writes, level_changes(ref, LOW));
+  CHECK_EQ(s.batch_us, SLEEP_OUT_DELAY_US);
+}
+
+int main(void)
+{
+  ioex.reset(0xFFFF, 0xFFFF);
+  probe_attach();
+
+  Indicator_SWSPI bus(GFX_NOT_DEFINED, EXPANDER_IO_LCD_CS, SPI_SCLK, SPI_MOSI, GFX_NOT_DEFINED);
+  CHECK(bus.begin());
+  // CS_INIT() turns the pin into an output without a low glitch
+  CHECK(probe.cs_edges.empty());
+  CHECK_EQ(ioex.pin(EXPANDER_IO_LCD_CS), 1);
+
+  test_batch(bus);
+  test_unbatched(bus);
+  test_stream_begin();
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,170 @@
+// Q16.16 particle integration (WindChimeParticle.h) against the float
+// physics it replaced, plus a small host benchmark of both.
+
+#include <math.h>
+#include <stdlib.h>
+#include <chrono>
+#include "host_test.h"
+#include "../../src/UI/WindChimeParticle.h"
+
+#define CANVAS 480
+#define LIFE_MIN 80
+#define LIFE_MAX 139
+
+// Error bounds over a whole lifetime (<= LIFE_MAX frames)
+#define POS_ERROR_MAX 0.25 // px
+#define ALPHA_ERROR_MAX 1
+
+// The float particle from before the Q16.16 change
+struct FloatParticle {
+  float x, y, vx, vy;
+  int16_t life, max_life;
+};
+
+static void float_launch(FloatParticle &p, int deg, int speed_step, int x, int y, int16_t life) {
+  float angle = deg * M_PI / 180.0f;
+  float speed = 0.5f + (speed_step / 100.0f) * 2.5f;
+  p.vx = cos(angle) * speed;
+  p.vy = sin(angle) * speed;
+  p.x = x;
+  p.y = y;
+  p.life = life;
+  p.max_life = life;
+}
+
+static bool float_step(FloatParticle &p, int16_t wind_speed) {
+  p.x += p.vx;
+  p.y += p.vy;
+  p.x += (wind_speed / 20.0f);
+  p.vy += 0.25f;
+  return !(p.x < 0 || p.x >= CANVAS || p.y < 0 || p.y >= CANVAS);
+}
+
+static void test_launch_velocity(void) {
+  double worst = 0;
+  for (int deg = 0; deg < 360; deg++) {
+    for (int step = 0; step < PARTICLE_SPEED_STEPS; step++) {
+      int32_t vx, vy;
+      particle_launch(deg, step, &vx, &vy);
+      FloatParticle p;
+      float_launch(p, deg, step, 0, 0, 1);
+      worst = fmax(worst, fabs(vx / (double)FIX_ONE - p.vx));
+      worst = fmax(worst, fabs(vy / (double)FIX_ONE - p.vy));
+    }
+  }
+  printf("launch velocity: max error %.6f px/frame\n", worst);
+  CHECK(worst < POS_ERROR_MAX / LIFE_MAX);
+}
+
+static void test_integration(void) {
+  static const int16_t winds[] = { -60, -7, 0, 13, 45 };
+  static const int origins[][2] = { { 240, 240 }, { 3, 470 }, { 400, 20 } };
+  const uint32_t max = INT_TO_FIX(CANVAS);
+  double worst = 0;
+  long frames = 0, particles = 0, death_mismatches = 0;
+
+  for (int16_t wind_speed : winds) {
+    for (auto &o : origins) {
+      for (int deg = 0; deg < 360; deg += 7) {
+        for (int step = 0; step < PARTICLE_SPEED_STEPS; step += 11) {
+          int32_t x = INT_TO_FIX(o[0]), y = INT_TO_FIX(o[1]), vx, vy;
+          particle_launch(deg, step, &vx, &vy);
+          const int32_t wind = particle_wind(wind_speed);
+          FloatParticle p;
+          float_launch(p, deg, step, o[0], o[1], LIFE_MAX);
+          particles++;
+
+          for (int f = 0; f < LIFE_MAX; f++) {
+            bool fix_alive = particle_step(&x, &y, vx, &vy, wind, max, max);
+            bool float_alive = float_step(p, wind_speed);
+            worst = fmax(worst, fabs(x / (double)FIX_ONE - p.x));
+            worst = fmax(worst, fabs(y / (double)FIX_ONE - p.y));
+            frames++;
+            if (fix_alive != float_alive) {
+              // Only allowed where the float position is within the error
+              // bound of an edge
+              float edge = fminf(fminf(fabsf(p.x), fabsf(p.x - CANVAS)),
+                                 fminf(fabsf(p.y), fabsf(p.y - CANVAS)));
+              CHECK(edge <= POS_ERROR_MAX);
+              death_mismatches++;
+            }
+            if (!fix_alive || !float_alive) break;
+          }
+        }
+      }
+    }
+  }
+  printf("integration: %ld particles, %ld frames, max position error %.4f px, "
+         "%ld edge deaths differ\n", particles, frames, worst, death_mismatches);
+  CHECK(worst <= POS_ERROR_MAX);
+}
+
+static void test_alpha(void) {
+  int worst = 0;
+  for (int16_t max_life = LIFE_MIN; max_life <= LIFE_MAX; max_life++) {
+    uint16_t fade = particle_fade_step(max_life);
+    CHECK(particle_alpha(max_life, fade) >= 255 - ALPHA_ERROR_MAX);
+    for (int16_t life = max_life; life > 0; life--) {
+      int fixed = particle_alpha(life, fade);
+      int ref = (life * 255) / max_life;
+      worst = abs(fixed - ref) > worst ? abs(fixed - ref) : worst;
+      CHECK(fixed <= ref);
+    }
+  }
+  printf("alpha: max error %d\n", worst);
+  CHECK(worst <= ALPHA_ERROR_MAX);
+}
+
+// Host timing only, it says little about the ESP32-S3. Kept small so that
+// `make` stays fast.
+#define BENCH_PARTICLES 1024
+#define BENCH_FRAMES 2000
+
+static void bench(void) {
+  static int32_t x[BENCH_PARTICLES], y[BENCH_PARTICLES], vx[BENCH_PARTICLES], vy[BENCH_PARTICLES];
+  static FloatParticle fp[BENCH_PARTICLES];
+  const uint32_t max = INT_TO_FIX(CANVAS); // Nothing is removed, the result is only summed
+  srand(1);
+  for (int i = 0; i < BENCH_PARTICLES; i++) {
+    int deg = rand() % 360, step = rand() % PARTICLE_SPEED_STEPS;
+    particle_launch(deg, step, &vx[i], &vy[i]);
+    x[i] = y[i] = INT_TO_FIX(CANVAS / 2);
+    float_launch(fp[i], deg, step, CANVAS / 2, CANVAS / 2, LIFE_MAX);
+  }
+
+  using clock = std::chrono::steady_clock;
+  const int32_t wind = particle_wind(5);
+  long alive = 0;
+  auto t0 = clock::now();
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    if (f % LIFE_MAX == 0) {
+      for (int i = 0; i < BENCH_PARTICLES; i++) { y[i] = INT_TO_FIX(CANVAS / 2); vy[i] = 0; }
+    }
+    for (int i = 0; i < BENCH_PARTICLES; i++) {
+      alive += particle_step(&x[i], &y[i], vx[i], &vy[i], wind, max, max);
+    }
+  }
+  auto t1 = clock::now();
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    if (f % LIFE_MAX == 0) {
+      for (int i = 0; i < BENCH_PARTICLES; i++) { fp[i].y = CANVAS / 2; fp[i].vy = 0; }
+    }
+    for (int i = 0; i < BENCH_PARTICLES; i++) {
+      alive += float_step(fp[i], 5);
+    }
+  }
+  auto t2 = clock::now();
+
+  double steps = (double)BENCH_PARTICLES * BENCH_FRAMES;
+  printf("bench: Q16.16 %.2f ns/step, float %.2f ns/step (%ld)\n",
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / steps,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / steps, alive);
+}
+
+int main(void) {
+  test_launch_velocity();
+  test_integration();
+  test_alpha();
+  bench();
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,116 @@
+// ReplayTrace (src/UI/ReplayTrace.c), the event trace of the replay
+// benchmarks. The events are a function of the seed and the frame number
+// only: each phase delivers exactly its rate times its length, an event's
+// timestamp is its frame's, and the same seed gives the same events.
+
+#include <string.h>
+#include <vector>
+#include "host_test.h"
+#include "../../src/UI/ReplayTrace.h"
+
+static std::vector<wind_chime_event_t> events;
+static uint32_t current_frame = 0;
+static std::vector<uint32_t> event_frames;
+
+extern "C" void WindChimeAddEvent(wind_chime_event_t * event)
+{
+  events.push_back(*event);
+  event_frames.push_back(current_frame);
+}
+
+static void run(uint32_t seed, std::vector<uint32_t> * per_phase)
+{
+  events.clear();
+  event_frames.clear();
+  replay_trace_t trace;
+  ReplayTraceInit(&trace, seed);
+  current_frame = 0;
+  uint32_t emitted = 0;
+  bool stepped = true;
+  while (trace.phase < ReplayTracePhaseCount())
+  {
+    uint8_t phase = trace.phase;
+    stepped &= ReplayTraceStep(&trace);
+    current_frame++;
+    if (trace.phase != phase)
+    {
+      per_phase->push_back(trace.emitted - emitted);
+      emitted = trace.emitted;
+    }
+  }
+  CHECK(stepped);
+  CHECK(!ReplayTraceStep(&trace));
+  CHECK_EQ(trace.emitted, events.size());
+}
+
+static void test_rates(void)
+{
+  std::vector<uint32_t> per_phase;
+  run(12345, &per_phase);
+  CHECK_EQ(per_phase.size(), ReplayTracePhaseCount());
+  CHECK_EQ(ReplayTracePhaseCount(), 4);
+
+  // quiet 2/s, steady 20/s, burst 200/s for 5 s each, then drain
+  static const uint32_t expected[] = { 10, 100, 1000, 0 };
+  uint32_t frames = 0;
+  for (uint8_t p = 0; p < ReplayTracePhaseCount(); p++)
+  {
+    CHECK_EQ(per_phase[p], expected[p]);
+    frames += ReplayTracePhaseFrames(p);
+  }
+  CHECK_EQ(current_frame, frames);
+  CHECK_EQ(ReplayTracePhaseFrames(0) * ReplayTraceFrameMs(), 5000);
+
+  // Stamped with their frame, inside the screen
+  bool stamped = true, inside = true;
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    stamped &= events[i].timestamp == event_frames[i] * ReplayTraceFrameMs();
+    inside &= events[i].circle_style.x_coord >= 28 && events[i].circle_style.x_coord < 452 &&
+              events[i].circle_style.y_coord >= 28 && events[i].circle_style.y_coord < 452;
+  }
+  CHECK(stamped);
+  CHECK(inside);
+
+  // Spread evenly: the burst adds events in every one of its frames
+  uint32_t burst_start = ReplayTracePhaseFrames(0) + ReplayTracePhaseFrames(1);
+  uint32_t burst_frames = 0, last = 0;
+  for (uint32_t f : event_frames)
+  {
+    if (f >= burst_start && f < burst_start + ReplayTracePhaseFrames(2) && f != last) burst_frames++;
+    last = f;
+  }
+  CHECK_EQ(burst_frames, ReplayTracePhaseFrames(2));
+}
+
+static void test_seed(void)
+{
+  std::vector<uint32_t> per_phase;
+  run(7, &per_phase);
+  std::vector<wind_chime_event_t> first = events;
+  per_phase.clear();
+  run(7, &per_phase);
+  CHECK_EQ(first.size(), events.size());
+  bool same = first.size() == events.size();
+  for (size_t i = 0; same && i < events.size(); i++)
+  {
+    same = memcmp(&first[i], &events[i], sizeof(wind_chime_event_t)) == 0;
+  }
+  CHECK(same);
+
+  per_phase.clear();
+  run(8, &per_phase);
+  bool differs = false;
+  for (size_t i = 0; i < events.size() && i < first.size(); i++)
+  {
+    differs |= first[i].circle_style.x_coord != events[i].circle_style.x_coord;
+  }
+  CHECK(differs);
+}
+
+int main(void)
+{
+  test_rates();
+  test_seed();
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+// RotateRGB565 (src/Display/RotateRGB565.c) against LVGL's mapping for 90,
+// 180 and 270 degrees, on sizes that are not multiples of the 32 px tile and
+// on padded strides. Built twice: as is, where the weak RotateRGB565_SIMD
+// hook declines and the C kernels run, and with -DROTATE_TEST_SIMD, where
+// this file overrides the hook. The plain build also times both on a full
+// frame and on a double-partial strip; the host's caches are not PSRAM, so
+// the numbers only show the direction, the "rotate" command has the real ones.
+
+#include <chrono>
+#include <vector>
+#include "host_test.h"
+#include "../../src/Display/RotateRGB565.h"
+
+#define SENTINEL 0xA5A5
+
+// lv_draw_sw_rotate() for RGB565, same loops as LVGL 9.2's rotate90/180/270_rgb565
+extern "C" void lv_draw_sw_rotate(const void * src_v, void * dst_v, int32_t w, int32_t h,
+                                  int32_t src_stride, int32_t dst_stride,
+                                  lv_display_rotation_t rotation, lv_color_format_t cf)
+{
+  (void)cf;
+  const uint16_t * src = (const uint16_t *)src_v;
+  uint16_t * dst = (uint16_t *)dst_v;
+  src_stride /= 2;
+  dst_stride /= 2;
+  switch (rotation) {
+    case LV_DISPLAY_ROTATION_90:
+      for (int32_t x = 0; x < w; ++x) {
+        int32_t src_index = w - x - 1;
+        for (int32_t y = 0; y < h; ++y) {
+          dst[x * dst_stride + y] = src[src_index];
+          src_index += src_stride;
+        }
+      }
+      break;
+    case LV_DISPLAY_ROTATION_180:
+      for (int32_t y = 0; y < h; ++y) {
+        for (int32_t x = 0; x < w; ++x) {
+          dst[(h - y - 1) * dst_stride + w - x - 1] = src[y * src_stride + x];
+        }
+      }
+      break;
+    case LV_DISPLAY_ROTATION_270:
+      for (int32_t x = 0; x < w; ++x) {
+        int32_t src_index = src_stride * (h - 1) + x;
+        for (int32_t y = 0; y < h; ++y) {
+          dst[x * dst_stride + y] = src[src_index];
+          src_index -= src_stride;
+        }
+      }
+      break;
+    default:
+      for (int32_t y = 0; y < h; ++y) {
+        memcpy(dst + y * dst_stride, src + y * src_stride, w * 2);
+      }
+      break;
+  }
+}
+
+#ifdef ROTATE_TEST_SIMD
+// Stands in for an ESP32-S3 kernel that only handles 180 degrees
+static int simd_calls = 0;
+static int simd_handled = 0;
+
+extern "C" bool RotateRGB565_SIMD(const uint16_t * src, uint16_t * dst, int32_t src_w, int32_t src_h,
+                                  int32_t src_stride, int32_t dst_stride, lv_display_rotation_t rotation)
+{
+  simd_calls++;
+  if (rotation != LV_DISPLAY_ROTATION_180) return false;
+  simd_handled++;
+  lv_draw_sw_rotate(src, dst, src_w, src_h, src_stride, dst_stride, rotation, LV_COLOR_FORMAT_RGB565);
+  return true;
+}
+#endif
+
+static const lv_display_rotation_t rotations[] = {
+  LV_DISPLAY_ROTATION_0, LV_DISPLAY_ROTATION_90, LV_DISPLAY_ROTATION_180, LV_DISPLAY_ROTATION_270
+};
+
+// Rotates a w x h area out of a padded source into a padded destination and
+// compares the whole destination buffer, padding included
+static bool check_rotate(int32_t w, int32_t h, int32_t src_pad, int32_t dst_pad, lv_display_rotation_t rotation)
+{
+  bool quarter = rotation == LV_DISPLAY_ROTATION_90 || rotation == LV_DISPLAY_ROTATION_270;
+  int32_t dst_w = quarter ? h : w;
+  int32_t dst_h = quarter ? w : h;
+  int32_t ss = w + src_pad;
+  int32_t ds = dst_w + dst_pad;
+
+  std::vector<uint16_t> src(ss * h);
+  for (size_t i = 0; i < src.size(); i++) src[i] = (uint16_t)(i * 2654435761u >> 16);
+  std::vector<uint16_t> ref(ds * dst_h, SENTINEL);
+  std::vector<uint16_t> out(ds * dst_h, SENTINEL);
+
+  lv_draw_sw_rotate(src.data(), ref.data(), w, h, ss * 2, ds * 2, rotation, LV_COLOR_FORMAT_RGB565);
+  RotateRGB565(src.data(), out.data(), w, h, ss * 2, ds * 2, rotation);
+
+  if (ref == out) return true;
+  fprintf(stderr, "rotation %d, %dx%d, src pad %d, dst pad %d differs\n",
+          (int)rotation * 90, w, h, src_pad, dst_pad);
+  return false;
+}
+
+static void test_sizes_and_strides(void)
+{
+  static const int32_t sizes[][2] = {
+    { 1, 1 }, { 1, 50 }, { 50, 1 }, { 31, 32 }, { 32, 32 }, { 33, 31 },
+    { 37, 23 }, { 64, 65 }, { 100, 97 }, { 480, 7 }, { 7, 480 }
+  };
+  static const int32_t pads[][2] = { { 0, 0 }, { 3, 0 }, { 0, 5 }, { 16, 9 } };
+  int cases = 0;
+  for (auto &s : sizes) {
+    for (auto &p : pads) {
+      for (lv_display_rotation_t r : rotations) {
+        CHECK(check_rotate(s[0], s[1], p[0], p[1], r));
+        cases++;
+      }
+    }
+  }
+  printf("rotate: %d size/stride/rotation cases\n", cases);
+}
+
+static void test_self_check(void)
+{
+  rotate_rgb565_check_t check;
+  CHECK(RotateRGB565SelfCheck(&check));
+  for (int i = 0; i < 3; i++) CHECK(check.exact[i]);
+}
+
+#ifndef ROTATE_TEST_SIMD
+#define TIMING_RUNS 20
+
+// Best of TIMING_RUNS, in microseconds
+template <typename F>
+static double best_us(F rotate)
+{
+  double best = 1e12;
+  for (int i = 0; i < TIMING_RUNS; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    rotate();
+    std::chrono::duration<double, std::micro> us = std::chrono::steady_clock::now() - start;
+    if (us.count() < best) best = us.count();
+  }
+  return best;
+}
+
+static void time_rotate(int32_t w, int32_t h)
+{
+  std::vector<uint16_t> src(w * h);
+  for (size_t i = 0; i < src.size(); i++) src[i] = (uint16_t)(i * 2654435761u >> 16);
+  std::vector<uint16_t> dst(w * h);
+
+  for (int r = 1; r < 4; r++)
+  {
+    lv_display_rotation_t rotation = rotations[r];
+    bool quarter = rotation == LV_DISPLAY_ROTATION_90 || rotation == LV_DISPLAY_ROTATION_270;
+    int32_t ds = (quarter ? h : w) * 2;
+    double lvgl = best_us([&] {
+      lv_draw_sw_rotate(src.data(), dst.data(), w, h, w * 2, ds, rotation, LV_COLOR_FORMAT_RGB565);
+    });
+    double tiled = best_us([&] { RotateRGB565(src.data(), dst.data(), w, h, w * 2, ds, rotation); });
+    printf("rotate %3d %dx%d: lv_draw_sw_rotate %7.1f us, RotateRGB565 %7.1f us, %.2fx\n",
+           r * 90, w, h, lvgl, tiled, tiled > 0 ? lvgl / tiled : 0.0);
+  }
+}
+
+static void test_timing(void)
+{
+  time_rotate(480, 480);
+  time_rotate(480, 40); // One DISPLAY_MODE_DOUBLE_PARTIAL strip
+}
+#endif
+
+int main(void)
+{
+  test_sizes_and_strides();
+  test_self_check();
+#ifndef ROTATE_TEST_SIMD
+  test_timing();
+#endif
+#ifdef ROTATE_TEST_SIMD
+  // Every call asks the hook first, 180 is all it took
+  CHECK(simd_calls > 0);
+  CHECK(simd_handled > 0);
+  CHECK(simd_handled < simd_calls);
+  printf("rotate: SIMD hook called %d times, handled %d\n", simd_calls, simd_handled);
+#endif
+  return HOST_TEST_RESULT();
+}
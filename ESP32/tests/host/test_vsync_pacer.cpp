@@ -0,0 +1,200 @@
+// VsyncPacer (src/Display/VsyncPacer.c) driven by scripted timelines standing
+// in for the panel's VSYNC interrupt and loop(), checking when it lets LVGL
+// refresh and what it counts as dropped and duplicated.
+
+#include <stdlib.h>
+#include "host_test.h"
+#include "../../src/Display/VsyncPacer.h"
+
+// Timeline, one character per event, spaces are ignored:
+//   V  VSYNC interrupt
+//   P  loop() polls; when the pacer says so, LVGL refreshes and renders a frame
+//   p  loop() polls; when the pacer says so, LVGL refreshes but nothing was dirty
+//   R  LVGL renders on its own timer (divider 0)
+// Returns the number of polls that were let through.
+static int play(vsync_pacer_t * pacer, const char * timeline)
+{
+  int refreshes = 0;
+  for (const char * c = timeline; *c; c++) {
+    switch (*c) {
+      case 'V':
+        VsyncPacer_OnVsync(pacer);
+        break;
+      case 'P':
+      case 'p':
+        if (VsyncPacer_Poll(pacer)) {
+          refreshes++;
+          if (*c == 'P') VsyncPacer_FrameRendered(pacer);
+        }
+        break;
+      case 'R':
+        VsyncPacer_FrameRendered(pacer);
+        break;
+    }
+  }
+  return refreshes;
+}
+
+#define CHECK_STATS(pacer, rendered, dropped, duplicated)   \
+  do {                                                      \
+    CHECK_EQ((pacer).frames_rendered, rendered);            \
+    CHECK_EQ((pacer).frames_dropped, dropped);              \
+    CHECK_EQ((pacer).frames_duplicated, duplicated);        \
+  } while (0)
+
+// Polled more often than VSYNC: one refresh per divider VSYNCs, nothing lost
+static void test_dividers(void)
+{
+  vsync_pacer_t pacer;
+
+  VsyncPacer_Init(&pacer, 1);
+  CHECK_EQ(play(&pacer, "PP VPP VPP VPP VPP VPP VPP"), 6);
+  CHECK_STATS(pacer, 6, 0, 0);
+
+  VsyncPacer_Init(&pacer, 2);
+  CHECK_EQ(play(&pacer, "PP VPP VPP VPP VPP VPP VPP"), 3);
+  CHECK_STATS(pacer, 3, 0, 0);
+
+  VsyncPacer_Init(&pacer, 3);
+  CHECK_EQ(play(&pacer, "PP VPP VPP VPP VPP VPP VPP"), 2);
+  CHECK_STATS(pacer, 2, 0, 0);
+
+  // Exactly on the divider's VSYNCs
+  VsyncPacer_Init(&pacer, 3);
+  CHECK(!VsyncPacer_Poll(&pacer));
+  play(&pacer, "VV");
+  CHECK(!VsyncPacer_Poll(&pacer));
+  play(&pacer, "V");
+  CHECK(VsyncPacer_Poll(&pacer));
+  CHECK(!VsyncPacer_Poll(&pacer));
+
+  // Divider 0: never paced
+  VsyncPacer_Init(&pacer, 0);
+  CHECK_EQ(play(&pacer, "VPVPVPVP"), 0);
+}
+
+// loop() comes round late: the missed VSYNCs are duplicates of the previous
+// frame, and the cadence restarts from the late poll instead of catching up
+static void test_late_polls(void)
+{
+  vsync_pacer_t pacer;
+
+  VsyncPacer_Init(&pacer, 1);
+  CHECK_EQ(play(&pacer, "VP VVVP VP"), 3);
+  CHECK_STATS(pacer, 3, 0, 2);
+
+  VsyncPacer_Init(&pacer, 2);
+  CHECK_EQ(play(&pacer, "VVP VVVVVP"), 2);
+  CHECK_STATS(pacer, 2, 0, 3);
+  // Next slot is two VSYNCs after the late poll, not after where it should have been
+  CHECK_EQ(play(&pacer, "VP"), 0);
+  CHECK_EQ(play(&pacer, "VP"), 1);
+  CHECK_STATS(pacer, 3, 0, 3);
+
+  // Late by a single VSYNC, less than a whole divider: still one scan-out of
+  // the old frame too many
+  VsyncPacer_Init(&pacer, 3);
+  CHECK_EQ(play(&pacer, "VVVP VVVVP"), 2);
+  CHECK_STATS(pacer, 2, 0, 1);
+
+  // Refresh with nothing dirty still takes the slot
+  VsyncPacer_Init(&pacer, 2);
+  CHECK_EQ(play(&pacer, "VVp VVP"), 2);
+  CHECK_STATS(pacer, 1, 0, 0);
+}
+
+// LVGL's own timer (divider 0) renders twice between two VSYNCs: the first
+// of the two was never shown
+static void test_dropped(void)
+{
+  vsync_pacer_t pacer;
+
+  VsyncPacer_Init(&pacer, 0);
+  play(&pacer, "R V R V R R V R R R V");
+  CHECK_STATS(pacer, 7, 3, 0);
+
+  // The first frame has nothing before it to drop
+  VsyncPacer_Init(&pacer, 0);
+  play(&pacer, "R");
+  CHECK_STATS(pacer, 1, 0, 0);
+
+  // Paced, a refresh and an extra render (e.g. an lv_refr_now()) before the next VSYNC
+  VsyncPacer_Init(&pacer, 1);
+  play(&pacer, "VP R VP");
+  CHECK_STATS(pacer, 3, 1, 0);
+}
+
+static void test_set_divider(void)
+{
+  vsync_pacer_t pacer;
+
+  VsyncPacer_Init(&pacer, 1);
+  CHECK_EQ(play(&pacer, "VP VP VP"), 3);
+
+  // The new cadence counts from the change, VSYNCs before it are not
+  // duplicates even though the last refresh was a while ago
+  play(&pacer, "VV");
+  VsyncPacer_SetDivider(&pacer, 3);
+  CHECK_EQ(play(&pacer, "VP VP"), 0);
+  CHECK_EQ(play(&pacer, "VP"), 1);
+  CHECK_STATS(pacer, 4, 0, 0);
+
+  // Down to 2, then off, then back on: paused VSYNCs are not duplicates either
+  VsyncPacer_SetDivider(&pacer, 2);
+  CHECK_EQ(play(&pacer, "VP VP VP VP"), 2);
+  VsyncPacer_SetDivider(&pacer, 0);
+  CHECK_EQ(play(&pacer, "VP VP VP VP VP"), 0);
+  VsyncPacer_SetDivider(&pacer, 1);
+  CHECK_EQ(play(&pacer, "VP"), 1);
+  CHECK_STATS(pacer, 7, 0, 0);
+
+  VsyncPacer_ResetStats(&pacer);
+  CHECK_STATS(pacer, 0, 0, 0);
+  CHECK_EQ(play(&pacer, "VVVP"), 1);
+  CHECK_STATS(pacer, 1, 0, 2);
+}
+
+// A long run at the real rates: VSYNC every 23.8 ms (42 Hz), loop() every
+// 5 ms with random stalls. Every VSYNC since the start is accounted for as a
+// paced refresh (divider each) or a duplicate.
+static void test_long_run(void)
+{
+  srand(3);
+  for (uint8_t divider = 1; divider <= 3; divider++) {
+    vsync_pacer_t pacer;
+    VsyncPacer_Init(&pacer, divider);
+    uint32_t next_vsync_us = 23800, next_poll_us = 5000, last_refresh_vsync = 0;
+    uint32_t stalls = 0;
+    for (uint32_t t = 0; t < 60u * 1000 * 1000; t += 100) {
+      if (t >= next_vsync_us) {
+        VsyncPacer_OnVsync(&pacer);
+        next_vsync_us += 23800;
+      }
+      if (t >= next_poll_us) {
+        if (VsyncPacer_Poll(&pacer)) {
+          VsyncPacer_FrameRendered(&pacer);
+          last_refresh_vsync = pacer.vsync_count;
+        }
+        bool stall = rand() % 50 == 0;  // A slow MQTT publish or flash write
+        stalls += stall;
+        next_poll_us += stall ? 5000 + rand() % 100000 : 5000;
+      }
+    }
+    printf("vsync: divider %u, %u vsyncs, %u refreshes, %u duplicated, %u stalls\n",
+           divider, pacer.vsync_count, pacer.frames_rendered, pacer.frames_duplicated, stalls);
+    CHECK_EQ(pacer.frames_dropped, 0);
+    CHECK_EQ(pacer.frames_rendered * divider + pacer.frames_duplicated, last_refresh_vsync);
+    CHECK(pacer.frames_duplicated > 0);
+    CHECK(pacer.frames_rendered > pacer.vsync_count / divider / 2);
+  }
+}
+
+int main(void)
+{
+  test_dividers();
+  test_late_polls();
+  test_dropped();
+  test_set_divider();
+  test_long_run();
+  return HOST_TEST_RESULT();
+}
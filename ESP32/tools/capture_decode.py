@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Rebuild PNG frames from the framebuffer capture stream (src/Display/FrameCapture).
+
+Input is text, one chunk per line:
+  - serial log lines "CAP <base64>" (other log lines are ignored), or
+  - hex payloads, e.g. from: mosquitto_sub -h broker.emqx.io -t windchime/capture -F %x
+
+Usage:
+  capture_decode.py capture.log -o frames/
+  mosquitto_sub ... -F %x | capture_decode.py - -o frames/
+
+Each finished capture is written as frame_<id>.png. Delta captures are applied
+on top of the previous frame, so start from a key frame ("capture key").
+"""
+
+import argparse
+import base64
+import binascii
+import os
+import struct
+import sys
+import zlib
+
+CHUNK_BEGIN = 0
+CHUNK_TILES = 1
+CHUNK_END = 2
+
+ENC_RAW = 0
+ENC_RLE = 1
+
+
+def write_png(path, width, height, pixels):
+    """pixels: list of RGB565 values, row major."""
+    rows = bytearray()
+    for y in range(height):
+        rows.append(0)  # filter: none
+        for px in pixels[y * width:(y + 1) * width]:
+            r = (px >> 11) & 0x1F
+            g = (px >> 5) & 0x3F
+            b = px & 0x1F
+            rows += bytes(((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)))
+
+    def chunk(tag, data):
+        body = tag + data
+        return struct.pack(">I", len(data)) + body + struct.pack(">I", zlib.crc32(body) & 0xFFFFFFFF)
+
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(bytes(rows), 6)))
+        f.write(chunk(b"IEND", b""))
+
+
+class Decoder:
+    def __init__(self, out_dir):
+        self.out_dir = out_dir
+        self.width = 0
+        self.height = 0
+        self.tile = 16
+        self.pixels = None
+        self.frame = None
+        self.next_seq = 0
+        self.valid = False  # canvas holds a complete picture to apply deltas to
+
+    def chunk(self, data):
+        if len(data) < 5:
+            return
+        ctype, frame, seq = struct.unpack_from("<BHH", data)
+        body = data[5:]
+
+        if ctype == CHUNK_BEGIN:
+            width, height, tile, keyframe = struct.unpack_from("<HHBB", body)
+            if keyframe or (width, height) != (self.width, self.height):
+                self.pixels = [0] * (width * height)
+                self.valid = bool(keyframe)
+            self.width, self.height, self.tile = width, height, tile
+            self.frame = frame
+            self.next_seq = 1
+            return
+
+        if frame != self.frame:
+            return
+        if seq != self.next_seq:
+            print("frame %u: chunk %u missing" % (frame, self.next_seq), file=sys.stderr)
+            self.valid = False
+        self.next_seq = seq + 1
+
+        if ctype == CHUNK_TILES:
+            self.tiles(body)
+        elif ctype == CHUNK_END:
+            tiles, encoded, cost_us = struct.unpack_from("<HII", body)
+            if not self.valid:
+                print("frame %u: incomplete, waiting for a key frame" % frame, file=sys.stderr)
+                return
+            path = os.path.join(self.out_dir, "frame_%05u.png" % frame)
+            write_png(path, self.width, self.height, self.pixels)
+            print("%s: %u tiles, %u bytes, %u us on device" % (path, tiles, encoded, cost_us))
+
+    def tiles(self, body):
+        pos = 0
+        while pos + 5 <= len(body):
+            tx, ty, enc, length = struct.unpack_from("<BBBH", body, pos)
+            pos += 5
+            data = body[pos:pos + length]
+            pos += length
+
+            x0 = tx * self.tile
+            y0 = ty * self.tile
+            w = min(self.tile, self.width - x0)
+            h = min(self.tile, self.height - y0)
+
+            if enc == ENC_RAW:
+                values = struct.unpack("<%uH" % (len(data) // 2), data)
+            else:
+                values = []
+                for i in range(0, len(data) - 2, 3):
+                    count = data[i] + 1
+                    values.extend([data[i + 1] | (data[i + 2] << 8)] * count)
+
+            for i, px in enumerate(values[:w * h]):
+                self.pixels[(y0 + i // w) * self.width + x0 + i % w] = px
+
+
+def parse_line(line):
+    line = line.strip()
+    if line.startswith("CAP "):
+        return base64.b64decode(line[4:])
+    try:
+        return binascii.unhexlify(line)
+    except (binascii.Error, ValueError):
+        return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="capture log, or - for stdin")
+    parser.add_argument("-o", "--out", default=".", help="output directory for PNG frames")
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    decoder = Decoder(args.out)
+    stream = sys.stdin if args.input == "-" else open(args.input, "r", errors="replace")
+    for line in stream:
+        data = parse_line(line)
+        if data:
+            decoder.chunk(data)
+
+
+if __name__ == "__main__":
+    main()